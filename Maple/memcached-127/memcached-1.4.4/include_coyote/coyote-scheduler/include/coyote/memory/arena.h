@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_ARENA_H
+#define COYOTE_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace coyote
+{
+	// Monotonic allocator for the bookkeeping of a single testing iteration. Memory is carved from large
+	// blocks by bumping a cursor, individual deallocations are ignored, and 'reset' rewinds the cursor to
+	// the first block in constant time. Blocks are kept across resets, so once the arena has grown to the
+	// size of the largest iteration it stops calling into the global allocator of the program under test.
+	// Objects created in the arena are never destroyed, so they must only own memory from the same arena.
+	class Arena
+	{
+	private:
+		struct Block
+		{
+			char* data;
+			size_t size;
+		};
+
+		// The blocks owned by this arena, in the order in which they are used.
+		std::vector<Block> blocks;
+
+		// Index of the block that allocations are currently carved from.
+		size_t block_index;
+
+		// The next free byte of the current block.
+		char* cursor;
+
+		// The end of the current block.
+		char* limit;
+
+		// Size in bytes of each new block, unless a single allocation needs more.
+		const size_t block_size;
+
+	public:
+		Arena(size_t block_size = 64 * 1024) noexcept;
+		~Arena();
+
+		Arena(Arena&& arena) = delete;
+		Arena(Arena const&) = delete;
+
+		Arena& operator=(Arena&& arena) = delete;
+		Arena& operator=(Arena const&) = delete;
+
+		// Returns uninitialized memory of the specified size and alignment.
+		void* allocate(size_t size, size_t alignment);
+
+		// Creates an object in the arena. The object is never destroyed.
+		template<typename T, typename... Args>
+		T* create(Args&&... args)
+		{
+			return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		}
+
+		// Releases all allocations at once. Memory returned before the reset must not be used afterwards.
+		void reset() noexcept;
+
+		// Returns the total size in bytes of the blocks owned by this arena.
+		size_t capacity() const noexcept;
+	};
+
+	// Standard allocator that carves memory from an 'Arena', so that containers holding per-iteration
+	// state can be abandoned when the arena resets instead of being cleared node by node.
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		typedef T value_type;
+
+		// The arena to allocate from.
+		Arena* arena;
+
+		explicit ArenaAllocator(Arena& arena) noexcept :
+			arena(&arena)
+		{
+		}
+
+		template<typename U>
+		ArenaAllocator(const ArenaAllocator<U>& other) noexcept :
+			arena(other.arena)
+		{
+		}
+
+		T* allocate(size_t n)
+		{
+			return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* /*ptr*/, size_t /*n*/) noexcept
+		{
+		}
+
+		template<typename U>
+		bool operator==(const ArenaAllocator<U>& other) const noexcept
+		{
+			return arena == other.arena;
+		}
+
+		template<typename U>
+		bool operator!=(const ArenaAllocator<U>& other) const noexcept
+		{
+			return arena != other.arena;
+		}
+	};
+}
+
+#endif // COYOTE_ARENA_H
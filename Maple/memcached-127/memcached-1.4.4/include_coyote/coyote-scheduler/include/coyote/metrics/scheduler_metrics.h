@@ -0,0 +1,202 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULER_METRICS_H
+#define COYOTE_SCHEDULER_METRICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace coyote
+{
+	// The counters that the scheduler keeps for each testing iteration.
+	enum class Metric
+	{
+		// Scheduling decisions that consulted the strategy.
+		SchedulingDecisions = 0,
+		// Scheduling points that returned without consulting the strategy, due to scheduling elision.
+		ElidedSteps = 1,
+		// Scheduling decisions that resumed another operation than the one that was executing.
+		ContextSwitches = 2,
+		// Time that operations spent paused, summed over all operations.
+		BlockedNanoseconds = 3,
+		// Calls that waited for one or more resources.
+		ResourceWaits = 4,
+		// Calls that signaled a resource.
+		ResourceSignals = 5,
+		// Wall time of attaching to the scheduler, which includes preparing the strategy.
+		AttachNanoseconds = 6,
+		// Wall time of detaching from the scheduler, which includes canceling the remaining operations.
+		DetachNanoseconds = 7,
+		// The number of metrics.
+		Count = 8
+	};
+
+	// Returns the name of the specified metric, as it appears in the CSV and JSON dumps.
+	std::string metric_name(Metric metric);
+
+	// Distribution of values in power-of-two buckets. Bucket '0' counts zeros, and bucket 'i' counts the
+	// values in the [2^(i-1), 2^i) range.
+	class Histogram
+	{
+	public:
+		static const size_t NUM_BUCKETS = 65;
+
+		// The number of values in each bucket.
+		uint64_t buckets[NUM_BUCKETS];
+
+		// The number of values.
+		uint64_t count;
+
+		// The sum of the values.
+		uint64_t sum;
+
+		// The largest value.
+		uint64_t max;
+
+		Histogram() noexcept;
+
+		void add(uint64_t value) noexcept
+		{
+			size_t bucket = 0;
+			for (uint64_t remaining = value; remaining != 0; remaining >>= 1)
+			{
+				bucket++;
+			}
+
+			buckets[bucket] += 1;
+			count += 1;
+			sum += value;
+			if (value > max)
+			{
+				max = value;
+			}
+		}
+
+		// Adds the values of the specified histogram to this histogram.
+		void merge(const Histogram& histogram) noexcept;
+
+		// Returns an upper bound of the value below which the specified fraction of the values fall.
+		uint64_t percentile(double fraction) const noexcept;
+
+		void clear() noexcept;
+	};
+
+	// The metrics of one testing iteration, or the sum of the metrics of several iterations.
+	struct IterationMetrics
+	{
+		// The counters, indexed by 'Metric'.
+		uint64_t counters[static_cast<size_t>(Metric::Count)];
+
+		// Distribution of the number of enabled operations at each scheduling decision.
+		Histogram enabled_operations;
+
+		// Distribution of the time that an operation stayed paused, in nanoseconds.
+		Histogram blocked_nanoseconds;
+
+		IterationMetrics() noexcept;
+
+		uint64_t& operator[](Metric metric) noexcept
+		{
+			return counters[static_cast<size_t>(metric)];
+		}
+
+		uint64_t operator[](Metric metric) const noexcept
+		{
+			return counters[static_cast<size_t>(metric)];
+		}
+
+		// Adds the metrics of the specified iteration to these metrics.
+		void merge(const IterationMetrics& metrics) noexcept;
+
+		void clear() noexcept;
+	};
+
+	// Collects the metrics of the testing iterations of a scheduler. The scheduler updates the metrics of
+	// the current iteration while holding its lock, so they should only be read while no client is attached.
+	class SchedulerMetrics
+	{
+	private:
+		// The metrics of the current iteration, or of the last iteration if no client is attached.
+		IterationMetrics current;
+
+		// The sum of the metrics of all completed iterations.
+		IterationMetrics aggregate;
+
+		// The counters of each completed iteration, 'Metric::Count' entries per iteration.
+		std::vector<uint64_t> history;
+
+	public:
+		SchedulerMetrics() noexcept;
+
+		SchedulerMetrics(SchedulerMetrics&& metrics) = delete;
+		SchedulerMetrics(SchedulerMetrics const&) = delete;
+
+		SchedulerMetrics& operator=(SchedulerMetrics&& metrics) = delete;
+		SchedulerMetrics& operator=(SchedulerMetrics const&) = delete;
+
+		// Returns a timestamp in nanoseconds from a monotonic clock.
+		static uint64_t now() noexcept
+		{
+			return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+		}
+
+		// Returns the metrics of the current iteration.
+		IterationMetrics& iteration() noexcept
+		{
+			return current;
+		}
+
+		// Records a scheduling decision among the specified number of enabled operations.
+		void record_decision(size_t enabled_operation_count, bool is_context_switch) noexcept
+		{
+			current[Metric::SchedulingDecisions] += 1;
+			if (is_context_switch)
+			{
+				current[Metric::ContextSwitches] += 1;
+			}
+
+			current.enabled_operations.add(enabled_operation_count);
+		}
+
+		// Records that an operation stayed paused since the specified timestamp.
+		void record_blocked(uint64_t start_time) noexcept
+		{
+			const uint64_t elapsed_time = now() - start_time;
+			current[Metric::BlockedNanoseconds] += elapsed_time;
+			current.blocked_nanoseconds.add(elapsed_time);
+		}
+
+		// Starts collecting the metrics of a new iteration.
+		void begin_iteration() noexcept;
+
+		// Adds the metrics of the current iteration to the aggregate metrics.
+		void end_iteration();
+
+		// Returns the metrics of the last completed iteration.
+		const IterationMetrics& last_iteration() const noexcept;
+
+		// Returns the sum of the metrics of all completed iterations.
+		const IterationMetrics& total() const noexcept;
+
+		// Returns the number of completed iterations.
+		size_t iteration_count() const noexcept;
+
+		// Returns the value of the specified metric in the specified completed iteration, starting from '0'.
+		uint64_t value(size_t iteration, Metric metric) const noexcept;
+
+		// Writes a header row, and one row with the counters of each completed iteration.
+		void write_csv(std::ostream& stream) const;
+
+		// Writes the aggregate and last iteration metrics with their histograms, and the counters of each
+		// completed iteration.
+		void write_json(std::ostream& stream) const;
+	};
+}
+
+#endif // COYOTE_SCHEDULER_METRICS_H
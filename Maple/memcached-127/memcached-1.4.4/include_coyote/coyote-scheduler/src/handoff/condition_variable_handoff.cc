@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "handoff/condition_variable_handoff.h"
+
+namespace coyote
+{
+	ConditionVariableHandoff::ConditionVariableHandoff() noexcept
+	{
+	}
+
+	void ConditionVariableHandoff::wait(Operation& op, std::unique_lock<std::mutex>& lock)
+	{
+		op.cv.wait(lock);
+	}
+
+	void ConditionVariableHandoff::notify(Operation& op)
+	{
+		op.cv.notify_all();
+	}
+
+	void ConditionVariableHandoff::handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock)
+	{
+		next.cv.notify_all();
+		current.cv.wait(lock);
+	}
+
+	std::string ConditionVariableHandoff::get_description()
+	{
+		return "Condition variable handoff.";
+	}
+}
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include "memory/arena.h"
+
+namespace coyote
+{
+	Arena::Arena(size_t block_size) noexcept :
+		block_index(0),
+		cursor(nullptr),
+		limit(nullptr),
+		block_size(block_size)
+	{
+	}
+
+	Arena::~Arena()
+	{
+		for (auto& block : blocks)
+		{
+			::operator delete(block.data);
+		}
+	}
+
+	void* Arena::allocate(size_t size, size_t alignment)
+	{
+		while (true)
+		{
+			if (cursor != nullptr)
+			{
+				const uintptr_t address = reinterpret_cast<uintptr_t>(cursor);
+				const size_t padding = (alignment - address % alignment) % alignment;
+				const size_t remaining = static_cast<size_t>(limit - cursor);
+				if (padding <= remaining && size <= remaining - padding)
+				{
+					char* start = cursor + padding;
+					cursor = start + size;
+					return start;
+				}
+
+				block_index += 1;
+			}
+
+			if (block_index == blocks.size())
+			{
+				// All blocks are in use, so grow the arena by a block that is large enough for this request.
+				const size_t new_block_size = size + alignment > block_size ? size + alignment : block_size;
+				blocks.push_back({ static_cast<char*>(::operator new(new_block_size)), new_block_size });
+			}
+
+			cursor = blocks[block_index].data;
+			limit = cursor + blocks[block_index].size;
+		}
+	}
+
+	void Arena::reset() noexcept
+	{
+		block_index = 0;
+		cursor = nullptr;
+		limit = nullptr;
+	}
+
+	size_t Arena::capacity() const noexcept
+	{
+		size_t total_size = 0;
+		for (auto& block : blocks)
+		{
+			total_size += block.size;
+		}
+
+		return total_size;
+	}
+}
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "strategies/Exhaustive/bounded_dfs_strategy.h"
+#include <algorithm>
+
+constexpr auto TRUE_CHOICE = 1;
+constexpr auto MAX_INTEGER_CHOICES = 64;
+
+// The offset of the frames of value choices, which have no operation choices.
+constexpr auto VALUE_CHOICES = SIZE_MAX;
+
+namespace coyote
+{
+	BoundedDFSStrategy::BoundedDFSStrategy(BoundKind bound_kind) noexcept :
+		bound_kind(bound_kind),
+		cost_bound(0),
+		is_bound_reached(false),
+		SchIndex(0),
+		current_operation_id(0),
+		current_cost(0)
+	{
+	}
+
+	// A new scheduling index keeps the enabled operations that the remaining budget affords, cheapest first,
+	// so that the first iteration of each bound replays the schedule of cost 0.
+	size_t BoundedDFSStrategy::next_operation(Operations& operations)
+	{
+		if (this->SchIndex >= this->frames.size())
+		{
+			const std::vector<size_t>& enabled_ids = operations.enabled_operation_ids();
+			const size_t size = enabled_ids.size();
+
+			// The round-robin order starts from the current operation, or from the next one if it is disabled.
+			auto it = std::lower_bound(enabled_ids.begin(), enabled_ids.end(), this->current_operation_id);
+			const size_t start = it - enabled_ids.begin();
+			const bool is_current_enabled = it != enabled_ids.end() && *it == this->current_operation_id;
+
+			this->candidates.clear();
+			for (size_t i = 0; i < size; i++)
+			{
+				size_t cost;
+				if (this->bound_kind == BoundKind::Preemption)
+				{
+					cost = is_current_enabled && i != start ? 1 : 0;
+				}
+				else
+				{
+					cost = (i + size - start) % size;
+				}
+
+				if (this->current_cost + cost <= this->cost_bound)
+				{
+					this->candidates.push_back(std::make_pair(enabled_ids[i], cost));
+				}
+				else
+				{
+					this->is_bound_reached = true;
+				}
+			}
+
+			std::stable_sort(this->candidates.begin(), this->candidates.end(),
+				[](const std::pair<size_t, size_t>& left, const std::pair<size_t, size_t>& right) {
+					return left.second < right.second;
+				});
+
+			this->frames.push_back({ this->candidates.size(), 0, this->operation_choices.size(), this->current_cost });
+			for (const auto& candidate : this->candidates)
+			{
+				this->operation_choices.push_back(candidate.first);
+				this->operation_costs.push_back(candidate.second);
+			}
+		}
+
+		const Frame& frame = this->frames[this->SchIndex++];
+		this->current_operation_id = this->operation_choices[frame.offset + frame.index];
+		this->current_cost = frame.cost + this->operation_costs[frame.offset + frame.index];
+		return this->current_operation_id;
+	}
+
+	size_t BoundedDFSStrategy::next_value(size_t count)
+	{
+		if (this->SchIndex >= this->frames.size())
+		{
+			this->frames.push_back({ count, 0, (size_t)VALUE_CHOICES, this->current_cost });
+		}
+
+		return this->frames[this->SchIndex++].index;
+	}
+
+	bool BoundedDFSStrategy::next_boolean()
+	{
+		return next_value(2) == TRUE_CHOICE;
+	}
+
+	int BoundedDFSStrategy::next_integer(int max_value)
+	{
+		if (max_value <= 0)
+		{
+			return 0;
+		}
+
+		return (int)next_value(std::min((size_t)max_value, (size_t)MAX_INTEGER_CHOICES));
+	}
+
+	// Backtracks to the deepest scheduling index with a choice left. If there is none, every schedule within
+	// the bound is explored, so the next iteration starts the tree of the next bound, or starts over if the
+	// bound did not skip any choice.
+	void BoundedDFSStrategy::prepare_next_iteration()
+	{
+		this->SchIndex = 0;
+		this->current_operation_id = 0;
+		this->current_cost = 0;
+
+		while (!this->frames.empty())
+		{
+			Frame& frame = this->frames.back();
+			if (frame.index + 1 < frame.count)
+			{
+				frame.index++;
+				return;
+			}
+
+			if (frame.offset != VALUE_CHOICES)
+			{
+				this->operation_choices.resize(frame.offset);
+				this->operation_costs.resize(frame.offset);
+			}
+
+			this->frames.pop_back();
+		}
+
+		this->cost_bound = this->is_bound_reached ? this->cost_bound + 1 : 0;
+		this->is_bound_reached = false;
+	}
+
+	size_t BoundedDFSStrategy::bound() const
+	{
+		return this->cost_bound;
+	}
+
+	std::string BoundedDFSStrategy::get_description()
+	{
+		if (this->bound_kind == BoundKind::Preemption)
+		{
+			return "Preemption-bounded DFS Strategy with bound " + std::to_string(this->cost_bound) + ".";
+		}
+
+		return "Delay-bounded DFS Strategy with bound " + std::to_string(this->cost_bound) + ".";
+	}
+
+	bool BoundedDFSStrategy::is_fair()
+	{
+		return false;
+	}
+
+	size_t BoundedDFSStrategy::seed()
+	{
+		return 0;
+	}
+}
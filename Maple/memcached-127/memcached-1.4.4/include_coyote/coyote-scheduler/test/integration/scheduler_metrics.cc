@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <sstream>
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 0;
+
+// Number of scheduling points that each operation passes.
+constexpr auto NUM_STEPS = 5;
+
+// Number of scheduling points that the main operation passes while it is the only enabled operation.
+constexpr auto NUM_SOLO_STEPS = 10;
+
+// Number of testing iterations.
+constexpr size_t NUM_ITERATIONS = 100;
+
+Scheduler* scheduler;
+
+bool is_signaled;
+
+void wait_signal()
+{
+	scheduler->start_operation(WORK_THREAD_1_ID);
+	for (int i = 0; i < NUM_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	if (!is_signaled)
+	{
+		scheduler->wait_resource(RESOURCE_ID);
+	}
+
+	scheduler->complete_operation(WORK_THREAD_1_ID);
+}
+
+void signal()
+{
+	scheduler->start_operation(WORK_THREAD_2_ID);
+	for (int i = 0; i < NUM_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	is_signaled = true;
+	scheduler->signal_resource(RESOURCE_ID);
+	scheduler->complete_operation(WORK_THREAD_2_ID);
+}
+
+void run_iteration()
+{
+	is_signaled = false;
+
+	scheduler->attach();
+	for (int i = 0; i < NUM_SOLO_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->create_resource(RESOURCE_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(wait_signal);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(signal);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->delete_resource(RESOURCE_ID);
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void check_metrics(const SchedulerMetrics* metrics, bool is_elision_enabled)
+{
+	assert(metrics->iteration_count() == NUM_ITERATIONS, "unexpected number of iterations.");
+
+	// The totals are the sums of the per-iteration counters.
+	for (size_t i = 0; i < static_cast<size_t>(Metric::Count); i++)
+	{
+		const Metric metric = static_cast<Metric>(i);
+		uint64_t sum = 0;
+		for (size_t iteration = 0; iteration < NUM_ITERATIONS; iteration++)
+		{
+			sum += metrics->value(iteration, metric);
+		}
+
+		assert(sum == metrics->total()[metric], "total of '" + metric_name(metric) + "' does not match.");
+		assert(metrics->value(NUM_ITERATIONS - 1, metric) == metrics->last_iteration()[metric],
+			"last iteration of '" + metric_name(metric) + "' does not match.");
+	}
+
+	const IterationMetrics& total = metrics->total();
+	assert(total[Metric::ResourceSignals] == NUM_ITERATIONS, "unexpected number of resource signals.");
+	assert(total[Metric::ResourceWaits] > 0, "no resource wait was recorded.");
+	assert(total[Metric::ResourceWaits] <= NUM_ITERATIONS, "unexpected number of resource waits.");
+	assert(total[Metric::SchedulingDecisions] >= NUM_ITERATIONS * 2 * NUM_STEPS, "too few scheduling decisions.");
+	assert(total[Metric::ContextSwitches] > 0, "no context switch was recorded.");
+	assert(total[Metric::ContextSwitches] <= total[Metric::SchedulingDecisions], "too many context switches.");
+	assert(total[Metric::BlockedNanoseconds] > 0, "no blocked time was recorded.");
+	assert(total[Metric::AttachNanoseconds] > 0, "no attach time was recorded.");
+	assert(total[Metric::DetachNanoseconds] > 0, "no detach time was recorded.");
+
+	if (is_elision_enabled)
+	{
+		// The first solo step of each iteration consults the strategy, and the rest are elided.
+		assert(total[Metric::ElidedSteps] >= NUM_ITERATIONS * (NUM_SOLO_STEPS - 1), "too few elided steps.");
+	}
+	else
+	{
+		assert(total[Metric::ElidedSteps] == 0, "steps were elided while elision is disabled.");
+	}
+
+	assert(total.enabled_operations.count == total[Metric::SchedulingDecisions],
+		"enabled operations were not recorded for each scheduling decision.");
+	assert(total.enabled_operations.max <= 3, "more operations were enabled than created.");
+	assert(total.blocked_nanoseconds.sum == total[Metric::BlockedNanoseconds], "blocked time histogram does not match.");
+	assert(total.blocked_nanoseconds.percentile(0.5) <= total.blocked_nanoseconds.percentile(0.99),
+		"percentiles are not ordered.");
+
+	std::ostringstream csv;
+	metrics->write_csv(csv);
+	const std::string csv_text = csv.str();
+	assert(csv_text.rfind("iteration,scheduling_decisions,", 0) == 0, "unexpected CSV header.");
+	assert(std::count(csv_text.begin(), csv_text.end(), '\n') == NUM_ITERATIONS + 1, "unexpected number of CSV rows.");
+
+	std::ostringstream json;
+	metrics->write_json(json);
+	const std::string json_text = json.str();
+	assert(json_text.find("\"iterations\": " + std::to_string(NUM_ITERATIONS)) != std::string::npos,
+		"unexpected JSON iteration count.");
+	assert(json_text.find("\"blocked_ns_histogram\"") != std::string::npos, "JSON has no blocked time histogram.");
+}
+
+void test(Scheduler* new_scheduler, bool is_elision_enabled)
+{
+	scheduler = new_scheduler;
+	assert(scheduler->get_metrics() == nullptr, "metrics are enabled by default.");
+	assert(scheduler->enable_metrics(), ErrorCode::Success);
+	assert(scheduler->set_scheduling_elision(is_elision_enabled), ErrorCode::Success);
+
+	for (size_t i = 0; i < NUM_ITERATIONS; i++)
+	{
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+		run_iteration();
+	}
+
+	check_metrics(scheduler->get_metrics(), is_elision_enabled);
+
+	scheduler->attach();
+	assert(scheduler->enable_metrics(), ErrorCode::ClientAttached);
+	scheduler->detach();
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test(new Scheduler((size_t)42), false);
+		test(new Scheduler((size_t)42), true);
+		test(new Scheduler("PCTStrategy"), false);
+		test(new Scheduler("DFSStrategy"), true);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/operations/operation_table.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		OperationTable table;
+		assert(table.size() == 0, "unexpected size [0]");
+		assert(table.find(7) == OperationTable::npos, "found operation in empty table [0]");
+
+		assert(table.insert(0) == 0, "unexpected index of operation 0 [1]");
+		assert(table.insert(7) == 1, "unexpected index of operation 7 [1]");
+		assert(table.size() == 2, "unexpected size [1]");
+		assert(table.find(7) == 1, "unexpected index found for operation 7 [1]");
+		assert(table.id(1) == 7, "unexpected id in slot 1 [1]");
+		assert(table[1].id == 7, "unexpected record id in slot 1 [1]");
+		assert(table.status(1) == OperationStatus::None, "unexpected status in slot 1 [1]");
+		assert(!table.is_scheduled(1), "slot 1 is scheduled [1]");
+
+		try
+		{
+			table.insert(7);
+			assert(false, "inserted duplicate operation [2]");
+		}
+		catch (ErrorCode error_code)
+		{
+			assert(error_code, ErrorCode::DuplicateOperation);
+		}
+
+		try
+		{
+			table.index_of(9);
+			assert(false, "found not existing operation [2]");
+		}
+		catch (ErrorCode error_code)
+		{
+			assert(error_code, ErrorCode::NotExistingOperation);
+		}
+
+		// Ids that only differ in their upper bits, and enough of them to grow the buckets.
+		for (size_t i = 1; i <= 100; i++)
+		{
+			assert(table.insert(i << 40) == i + 1, "unexpected index of large operation id [3]");
+		}
+
+		for (size_t i = 1; i <= 100; i++)
+		{
+			assert(table.find(i << 40) == i + 1, "unexpected index found for large operation id [3]");
+		}
+
+		assert(table.find(7) == 1, "unexpected index found for operation 7 after growing [3]");
+
+		// Join semantics.
+		table.status(0) = OperationStatus::Enabled;
+		table.join_operations(0, { 1, 2 }, true);
+		assert(table.status(0) == OperationStatus::JoinAllOperations, "unexpected join all status [4]");
+		assert(!table.on_join_operation(0, 1), "enabled before all joined operations completed [4]");
+		assert(table.on_join_operation(0, 2), "not enabled after all joined operations completed [4]");
+		assert(table.status(0) == OperationStatus::Enabled, "unexpected status after join all [4]");
+
+		table.join_operations(0, { 1, 2 }, false);
+		assert(table.on_join_operation(0, 2), "not enabled after any joined operation completed [5]");
+		assert(table[0].pending_join_operation_indices.empty(), "pending joins not cleared [5]");
+
+		// Resource semantics.
+		const size_t resource_ids[] = { 10, 11 };
+		table.wait_resource_signals(0, resource_ids, 2, true);
+		assert(!table.on_resource_signal(0, 10), "enabled before all resources signaled [6]");
+		assert(table.on_resource_signal(0, 11), "not enabled after all resources signaled [6]");
+
+		table.wait_resource_signals(0, resource_ids, 2, false);
+		assert(table.on_resource_signal(0, 11), "not enabled after any resource signaled [7]");
+		assert(table[0].pending_signal_resource_ids.empty(), "pending signals not cleared [7]");
+
+		// Slots and their records are reused after clearing.
+		Operation* record = &table[1];
+		table.set_scheduled(1, true);
+		table.clear();
+		assert(table.size() == 0, "unexpected size after clear [8]");
+		assert(table.find(7) == OperationTable::npos, "found operation after clear [8]");
+
+		assert(table.insert(3) == 0, "unexpected index of operation 3 [9]");
+		assert(table.insert(5) == 1, "unexpected index of operation 5 [9]");
+		assert(&table[1] == record, "record was not reused [9]");
+		assert(table[1].id == 5, "unexpected reused record id [9]");
+		assert(!table.is_scheduled(1), "reused slot is scheduled [9]");
+		assert(table.status(1) == OperationStatus::None, "unexpected reused slot status [9]");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_BATON_H
+#define COYOTE_BATON_H
+
+#include <atomic>
+#include <cstdint>
+#if !defined(__linux__)
+#include <condition_variable>
+#include <mutex>
+#endif
+
+namespace coyote
+{
+	// Binary semaphore that is owned by a single operation and used to park its thread until the
+	// scheduler passes it the baton. On Linux it is a single futex word, so posting to a thread that
+	// is not sleeping costs one atomic exchange, and waking a sleeping thread costs one syscall that
+	// targets only that thread.
+	class Baton
+	{
+	private:
+#if defined(__linux__)
+		// No permit is available and nobody is sleeping.
+		static constexpr uint32_t EMPTY = 0;
+
+		// A permit is available.
+		static constexpr uint32_t POSTED = 1;
+
+		// No permit is available and the owner is (or is about to be) sleeping on the futex.
+		static constexpr uint32_t SLEEPING = 2;
+
+		// The futex word.
+		std::atomic<uint32_t> state;
+#else
+		std::mutex mutex;
+		std::condition_variable cv;
+		bool is_posted;
+#endif
+
+	public:
+		Baton() noexcept;
+
+		Baton(Baton&& baton) = delete;
+		Baton(Baton const&) = delete;
+
+		Baton& operator=(Baton&& baton) = delete;
+		Baton& operator=(Baton const&) = delete;
+
+		// Makes a permit available and wakes the owner if it is sleeping. Multiple posts without an
+		// intermediate wait collapse into a single permit.
+		void post() noexcept;
+
+		// Blocks until a permit is available and consumes it.
+		void wait() noexcept;
+
+		// Drops any pending permit. Must not be called while the owner is waiting.
+		void reset() noexcept;
+	};
+}
+
+#endif // COYOTE_BATON_H
@@ -0,0 +1,126 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_RESOURCE_TABLE_H
+#define COYOTE_RESOURCE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "../memory/arena.h"
+
+namespace coyote
+{
+	// Slot indices of the operations that are blocked on a resource, in the order in which they started
+	// waiting. Up to 'INLINE_CAPACITY' waiters are stored inline, and longer lists spill into the arena of
+	// the current iteration.
+	class ResourceWaiters
+	{
+	private:
+		static const uint32_t INLINE_CAPACITY = 4;
+
+		// Storage of the first waiters.
+		size_t inline_indices[INLINE_CAPACITY];
+
+		// Storage of all waiters once they no longer fit inline, else null.
+		size_t* spilled_indices;
+
+		// The number of waiters.
+		uint32_t count;
+
+		// The number of waiters that fit in the current storage.
+		uint32_t capacity;
+
+	public:
+		ResourceWaiters() noexcept;
+
+		// Adds the operation in the specified slot, unless it is already waiting.
+		void insert(size_t operation_index, Arena& arena);
+
+		// Removes the operation in the specified slot, and returns true if it was waiting, else false.
+		bool erase(size_t operation_index) noexcept;
+
+		// Removes all waiters.
+		void clear() noexcept;
+
+		size_t size() const noexcept;
+
+		const size_t* begin() const noexcept;
+		const size_t* end() const noexcept;
+
+	private:
+		size_t* data() noexcept;
+	};
+
+	// Flat open-addressing table from resource ids to their waiters. Resources are stored inline in the
+	// buckets, so waiting on or signaling a resource is a single probe sequence without any indirection.
+	// Each bucket is stamped with the generation of the iteration that filled it, which lets 'clear' empty
+	// the table in constant time.
+	class ResourceTable
+	{
+	private:
+		struct Entry
+		{
+			// The id of the resource in this bucket.
+			size_t id;
+
+			// The generation in which this bucket was filled. The bucket is empty in other generations.
+			uint32_t generation;
+
+			// The operations that are blocked on the resource.
+			ResourceWaiters waiters;
+		};
+
+		// The buckets of the table. Their number is always a power of two.
+		std::vector<Entry> entries;
+
+		// The current generation.
+		uint32_t generation;
+
+		// The number of resources in the current generation.
+		size_t count;
+
+		// Arena that holds the waiter lists that spill out of their buckets.
+		Arena& arena;
+
+	public:
+		ResourceTable(Arena& arena) noexcept;
+
+		ResourceTable(ResourceTable&& table) = delete;
+		ResourceTable(ResourceTable const&) = delete;
+
+		ResourceTable& operator=(ResourceTable&& table) = delete;
+		ResourceTable& operator=(ResourceTable const&) = delete;
+
+		// Adds a new resource with the specified id, or throws if it already exists.
+		void insert(size_t resource_id);
+
+		// Returns the waiters of the resource with the specified id, or throws if it does not exist.
+		ResourceWaiters& at(size_t resource_id);
+
+		// Adds the operation in the specified slot to the waiters of the resource with the specified id.
+		void add_waiter(size_t resource_id, size_t operation_index);
+
+		// Removes the resource with the specified id, or throws if it does not exist.
+		void erase(size_t resource_id);
+
+		// Returns the number of resources.
+		size_t size() const noexcept;
+
+		// Removes all resources. Waiter lists that spilled into the arena must be released by resetting
+		// the arena afterwards.
+		void clear() noexcept;
+
+	private:
+		// Returns the bucket that holds the specified resource id, or the empty bucket where it belongs.
+		size_t find_bucket(size_t resource_id) const noexcept;
+
+		// Returns the bucket where the probe sequence of the specified resource id starts.
+		size_t home_bucket(size_t resource_id) const noexcept;
+
+		// Doubles the number of buckets and rehashes the resources of the current generation.
+		void grow();
+	};
+}
+
+#endif // COYOTE_RESOURCE_TABLE_H
@@ -0,0 +1,88 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_FORK_SERVER_H
+#define COYOTE_FORK_SERVER_H
+
+#if !defined(_WIN32)
+
+#include <cstddef>
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Runs the testing iterations of a program from a snapshot of its process, taken once an iteration
+	// reaches a ready point, such as after the program under test has started. At the ready point, the
+	// server forks a copy-on-write child process per iteration, one at a time, and waits until it exits,
+	// so that each child only runs the suffix of the iteration. The process must run a single thread at
+	// the ready point, for example because its operations run as fibers, since the children only inherit
+	// the thread that forks them.
+	class ForkServer
+	{
+	private:
+		// The number of child processes to fork.
+		const size_t num_iterations;
+
+		// The seed of the first child. The children use consecutive seeds.
+		const size_t first_seed;
+
+		// True if the server stops forking after the first child that finds a bug, else false.
+		const bool stop_on_first_bug;
+
+		// True if this process is a forked child, else false.
+		bool is_child_process;
+
+		// The seed of the iteration of this child process.
+		size_t child_seed;
+
+		// The number of children that completed without finding a bug.
+		size_t completed_iteration_count;
+
+		// The number of children that found a bug.
+		size_t failed_iteration_count;
+
+		// The seed of the first child that found a bug.
+		size_t first_bug_seed;
+
+	public:
+		ForkServer(size_t num_iterations, size_t first_seed, bool stop_on_first_bug) noexcept;
+
+		ForkServer(ForkServer&& server) = delete;
+		ForkServer(ForkServer const&) = delete;
+
+		ForkServer& operator=(ForkServer&& server) = delete;
+		ForkServer& operator=(ForkServer const&) = delete;
+
+		// Forks the child processes from the current state of this process, and waits until each one exits.
+		// Returns in each child, where 'is_child' is true, and which should reseed its scheduler with 'seed'
+		// and continue the iteration. Returns in the server once the children have exited. Fails with
+		// 'ErrorCode::NotSupported' if the process runs more than one thread.
+		ErrorCode fork_children() noexcept;
+
+		// Returns true if this process is a forked child, else false.
+		bool is_child() const noexcept;
+
+		// Returns the seed of the iteration of this child process.
+		size_t seed() const noexcept;
+
+		// Ends this child process, and reports to the server whether its iteration found a bug. A child
+		// that crashes, such as on a failed assertion, also reports a bug.
+		[[noreturn]] void exit_child(bool bug_found) noexcept;
+
+		// Returns true if a child found a bug, else false.
+		bool bug_found() const noexcept;
+
+		// Returns the seed of the first child that found a bug.
+		size_t bug_seed() const noexcept;
+
+		// Returns the number of children that completed without finding a bug.
+		size_t completed_iterations() const noexcept;
+
+		// Returns the number of children that found a bug.
+		size_t failed_iterations() const noexcept;
+	};
+}
+
+#endif // !_WIN32
+
+#endif // COYOTE_FORK_SERVER_H
@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SLEEP_SET_DFS_STRATEGY_H
+#define COYOTE_SLEEP_SET_DFS_STRATEGY_H
+
+#include "../strategy.h"
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace coyote
+{
+	// Explores the interleavings of the program in depth-first order, like 'DFSStrategy', but skips the
+	// interleavings that only reorder independent steps, using sleep sets. After the subtree of a choice
+	// has been explored, the operation that was chosen sleeps in the subtrees of the next choices, until
+	// an operation takes a step that depends on its next step. An iteration that reaches a scheduling
+	// point where every enabled operation sleeps is equivalent to an explored one, so it continues with
+	// forced choices and adds no new choices to explore. Steps are independent only if they declared their
+	// accesses with 'schedule_next', so without declarations the strategy explores the same interleavings
+	// as 'DFSStrategy'. A step that ran through scheduling points elided by the scheduler depends on every
+	// step, as the accesses of the elided points are not declared.
+	class SleepSetDFSStrategy : public Strategy
+	{
+	private:
+		// A scheduling point of the current iteration.
+		struct Frame
+		{
+			// True if the choices are operations, else false if they are values.
+			bool is_operation_choice;
+
+			// The number of choices at this point.
+			size_t count;
+
+			// The operation choices of this point, in order. Value choices are the values below 'count', so
+			// they are not stored.
+			std::vector<size_t> choices;
+
+			// The accesses of the next steps of the operation choices.
+			std::vector<StepAccess> accesses;
+
+			// The index of the current choice.
+			size_t index;
+
+			// The sleeping operations at this point, with the accesses of their next steps.
+			std::vector<std::pair<size_t, StepAccess>> sleep_set;
+		};
+
+		// The scheduling points of the current iteration, which the next iteration replays up to the last
+		// point that has choices left to explore.
+		std::vector<Frame> frames;
+
+		// Current scheduling index (next sch point)
+		size_t SchIndex;
+
+		// True if the current iteration reached a point where every enabled operation sleeps, else false.
+		bool is_sleep_blocked;
+
+		// The declared accesses of the next steps of the operations of the current iteration.
+		std::unordered_map<size_t, StepAccess> next_accesses;
+
+		// The number of values of an integer choice that are explored, starting from the lowest one.
+		const size_t max_integer_choices;
+
+		// Returns the next operation choice out of the specified ones.
+		size_t next_choice(const std::vector<size_t>& choices);
+
+		// Returns the next value choice out of the values below 'count'.
+		size_t next_choice(size_t count);
+
+		// Adds a new scheduling point with the specified number of choices, and returns it.
+		Frame& push_frame(bool is_operation_choice, size_t count);
+
+		// Returns the current choice of the specified frame.
+		size_t current_choice(const Frame& frame) const;
+
+		// Computes the sleep set of a new scheduling point from the current choice of the previous one.
+		void inherit_sleep_set(Frame& frame) const;
+
+	public:
+		SleepSetDFSStrategy() noexcept;
+
+		// Explores at most the specified number of values of each integer choice, instead of the default of
+		// 64, which bounds the tree of programs that ask for integers out of very large ranges.
+		explicit SleepSetDFSStrategy(size_t max_integer_choices) noexcept;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations);
+
+		// Returns the next boolean choice.
+		bool next_boolean();
+
+		// Returns the next integer choice, out of at most 'max_integer_choices' values.
+		int next_integer(int max_value);
+
+		// Records the access of the next step of an operation.
+		void declare_access(size_t operation_id, const StepAccess& access);
+
+		// Accounts for scheduling points that the scheduler elided while the operation ran alone.
+		void skip_steps(size_t operation_id, size_t count);
+
+		// Prepares the next iteration.
+		void prepare_next_iteration();
+
+		// Description about the strategy
+		std::string get_description();
+
+		// Fair strategy or not
+		bool is_fair();
+
+		// seed
+		size_t seed();
+	};
+}
+
+#endif // COYOTE_SLEEP_SET_DFS_STRATEGY_H
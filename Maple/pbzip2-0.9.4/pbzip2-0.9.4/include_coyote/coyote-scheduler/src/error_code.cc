@@ -15,6 +15,12 @@ namespace coyote
             return "failure";
         case ErrorCode::DeadlockDetected:
             return "deadlock detected";
+        case ErrorCode::NotSupported:
+            return "not supported by the current configuration";
+        case ErrorCode::LivelockDetected:
+            return "livelock detected";
+        case ErrorCode::ReplayDiverged:
+            return "execution diverged from the replayed trace";
         case ErrorCode::DuplicateOperation:
             return "operation already exists";
         case ErrorCode::NotExistingOperation:
@@ -14,7 +14,9 @@ namespace coyote
 {
 	Operations::Operations() noexcept :
 		enabled_operations_size(0),
-		disabled_operations_size(0)
+		disabled_operations_size(0),
+		positions(nullptr),
+		is_sorted_view_valid(false)
 	{
 	}
 
@@ -30,8 +32,15 @@ namespace coyote
 		std::cout << "pre-insert-total/enabled/disabled: " << operation_ids.size() << "/" << enabled_operations_size << "/" << disabled_operations_size << std::endl;
 		debug_print();
 #endif // COYOTE_DEBUG_LOG_V2
+		if (positions == nullptr)
+		{
+			positions = arena.create<PositionMap>(PositionMap::allocator_type(arena));
+		}
+
 		operation_ids.push_back(operation_id);
+		(*positions)[operation_id] = operation_ids.size() - 1;
 		enabled_operations_size += 1;
+		is_sorted_view_valid = false;
 		if (operation_ids.size() != enabled_operations_size)
 		{
 			swap(operation_ids.size() - 1, enabled_operations_size - 1);
@@ -57,6 +66,7 @@ namespace coyote
 		if (find_index(operation_id, 0, enabled_operations_size, index))
 		{
 			enabled_operations_size -= 1;
+			is_sorted_view_valid = false;
 			found = true;
 		}
 		else if (find_index(operation_id, enabled_operations_size, operation_ids.size(), index))
@@ -73,6 +83,7 @@ namespace coyote
 			swap(index, enabled_operations_size);
 			swap(enabled_operations_size, operation_ids.size() - 1);
 			operation_ids.pop_back();
+			positions->erase(operation_id);
 		}
 #ifdef COYOTE_DEBUG_LOG_V2
 		std::cout << "post-remove-total/enabled/disabled: " << operation_ids.size() << "/" << enabled_operations_size << "/" << disabled_operations_size << std::endl;
@@ -99,6 +110,7 @@ namespace coyote
 			swap(index, enabled_operations_size);
 			enabled_operations_size += 1;
 			disabled_operations_size -= 1;
+			is_sorted_view_valid = false;
 		}
 #ifdef COYOTE_DEBUG_LOG_V2
 		std::cout << "post-enable-total/enabled/disabled: " << operation_ids.size() << "/" << enabled_operations_size << "/" << disabled_operations_size << std::endl;
@@ -121,6 +133,7 @@ namespace coyote
 		{
 			enabled_operations_size -= 1;
 			disabled_operations_size += 1;
+			is_sorted_view_valid = false;
 #ifdef COYOTE_DEBUG_LOG_V2
 			std::cout << "disable-swap: " << index << "-" << enabled_operations_size << "-" << disabled_operations_size << std::endl;
 #endif // COYOTE_DEBUG_LOG_V2
@@ -140,35 +153,45 @@ namespace coyote
 	void Operations::clear()
 	{
 		operation_ids.clear();
+		positions = nullptr;
+		arena.reset();
 		enabled_operations_size = 0;
 		disabled_operations_size = 0;
+		is_sorted_view_valid = false;
 	}
 
 	bool Operations::find_index(size_t operation_id, size_t start, size_t end, size_t& index)
 	{
-		for (index = start; index < end; index++)
+		if (positions == nullptr)
 		{
-			if (operation_ids[index] == operation_id)
-			{
-				return true;
-			}
+			return false;
 		}
 
-		return false;
+		auto it = positions->find(operation_id);
+		if (it == positions->end())
+		{
+			return false;
+		}
+
+		index = it->second;
+		return index >= start && index < end;
 	}
 
-	std::vector<size_t> Operations::get_enabled_operation_ids()
+	const std::vector<size_t>& Operations::enabled_operation_ids()
 	{
-		std::vector<size_t> enabled_opr;
-		std::vector<size_t>::iterator it = operation_ids.begin();
-		for (int i = 0; i < enabled_operations_size; i++)
+		if (!is_sorted_view_valid)
 		{
-			enabled_opr.push_back(*it);
-			it++;
+			sorted_enabled_operation_ids.assign(operation_ids.begin(), operation_ids.begin() + enabled_operations_size);
+			std::sort(sorted_enabled_operation_ids.begin(), sorted_enabled_operation_ids.end());
+			is_sorted_view_valid = true;
 		}
 
-		std::sort(enabled_opr.begin(), enabled_opr.end());
-		return enabled_opr;
+		return sorted_enabled_operation_ids;
+	}
+
+	std::vector<size_t> Operations::get_enabled_operation_ids()
+	{
+		return enabled_operation_ids();
 	}
 
 	void Operations::swap(size_t left, size_t right)
@@ -178,6 +201,8 @@ namespace coyote
 			size_t temp = operation_ids[left];
 			operation_ids[left] = operation_ids[right];
 			operation_ids[right] = temp;
+			(*positions)[operation_ids[left]] = left;
+			(*positions)[operation_ids[right]] = right;
 		}
 	}
 
@@ -11,25 +11,16 @@ namespace coyote
 	{
 	}
 
-	size_t RandomStrategy::next_operation(Operations& operations)
-	{
-		const size_t index = generator.next() % operations.size();
-		return operations[index];
-	}
-
-	bool RandomStrategy::next_boolean()
-	{
-		return generator.next() & 1;
-	}
-
-	int RandomStrategy::next_integer(int max_value)
+	size_t RandomStrategy::seed()
 	{
-		return generator.next() % max_value;
+		return iteration_seed;
 	}
 
-	size_t RandomStrategy::seed()
+	bool RandomStrategy::reseed(size_t seed)
 	{
-		return iteration_seed;
+		iteration_seed = seed;
+		generator.seed(iteration_seed);
+		return true;
 	}
 
 	void RandomStrategy::prepare_next_iteration()
@@ -1,7 +1,6 @@
 ﻿// Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
-#include <cstdint>
 #include "strategies/random.h"
 
 namespace coyote
@@ -19,17 +18,4 @@ namespace coyote
 		state_y = seed == 0 ? 5489 : 0;
 		next();
 	}
-
-	size_t Random::next()
-	{
-		const uint64_t x = state_x;
-		uint64_t y = state_y;
-		const uint64_t result = state_x + y;
-
-		y ^= x;
-		state_x = rotl(x, 24) ^ y ^ (y << 16);
-		state_y = rotl(y, 37);
-
-		return result;
-	}
 }
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "test.h"
+#include "coyote/handoff/fiber_handoff.h"
+
+using namespace coyote;
+
+// Total number of scheduling decisions that each configuration performs, split across its operations.
+constexpr size_t TOTAL_STEPS = 2000000;
+
+// Number of testing iterations that each configuration runs.
+constexpr size_t NUM_ITERATIONS = 10;
+
+size_t steps_per_operation;
+
+template <typename SchedulerT>
+struct Context
+{
+	static SchedulerT* scheduler;
+
+	static void run_steps()
+	{
+		for (size_t i = 0; i < steps_per_operation; i++)
+		{
+			scheduler->schedule_next();
+			scheduler->next_boolean();
+		}
+	}
+
+	static void fiber_work(void*)
+	{
+		run_steps();
+	}
+};
+
+template <typename SchedulerT>
+SchedulerT* Context<SchedulerT>::scheduler;
+
+template <typename SchedulerT>
+void run(SchedulerT* scheduler, const std::string& scheduler_name, size_t num_operations)
+{
+	Context<SchedulerT>::scheduler = scheduler;
+	if (num_operations > 1)
+	{
+		assert(scheduler->set_handoff_engine(std::make_unique<FiberHandoff>()), ErrorCode::Success);
+	}
+
+	steps_per_operation = TOTAL_STEPS / NUM_ITERATIONS / num_operations;
+
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t iteration = 0; iteration < NUM_ITERATIONS; iteration++)
+	{
+		scheduler->attach();
+		if (num_operations == 1)
+		{
+			Context<SchedulerT>::run_steps();
+		}
+		else
+		{
+			for (size_t i = 1; i <= num_operations; i++)
+			{
+				scheduler->create_operation(i, Context<SchedulerT>::fiber_work, nullptr);
+			}
+
+			for (size_t i = 1; i <= num_operations; i++)
+			{
+				scheduler->join_operation(i);
+			}
+		}
+
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+
+	auto end_time = std::chrono::steady_clock::now();
+	double nanoseconds = std::chrono::duration<double, std::nano>(end_time - start_time).count();
+
+	std::cout << "[benchmark] " << scheduler_name << ", " << num_operations << " operations: " <<
+		nanoseconds / (steps_per_operation * num_operations * NUM_ITERATIONS) << " ns/step." << std::endl;
+	delete scheduler;
+}
+
+// Compares the type-erased 'Scheduler' against a 'BasicScheduler' that is specialized for the same
+// strategy at compile time. Each step is a scheduling decision followed by a boolean choice.
+int main()
+{
+	std::cout << "[benchmark] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		for (size_t num_operations = 1; num_operations <= 8; num_operations *= 8)
+		{
+			run(new Scheduler((size_t)42), "Scheduler", num_operations);
+			run(new BasicScheduler<RandomStrategy>(std::make_unique<RandomStrategy>(42)),
+				"BasicScheduler<RandomStrategy>", num_operations);
+			run(new Scheduler("ProbabilisticRandomStrategy"), "Scheduler(ProbabilisticRandomStrategy)", num_operations);
+			run(new BasicScheduler<ProbabilisticRandomStrategy>(std::make_unique<ProbabilisticRandomStrategy>(42)),
+				"BasicScheduler<ProbabilisticRandomStrategy>", num_operations);
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[benchmark] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[benchmark] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
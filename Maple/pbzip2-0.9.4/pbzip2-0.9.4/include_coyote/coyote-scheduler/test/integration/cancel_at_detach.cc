@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/handoff/baton_handoff.h"
+#include "coyote/handoff/condition_variable_handoff.h"
+
+using namespace coyote;
+
+constexpr auto NUM_OPERATIONS = 8;
+constexpr auto NUM_MAIN_STEPS = 20;
+constexpr auto NUM_ITERATIONS = 300;
+
+Scheduler* scheduler;
+
+// The threads of the previous iteration, which are joined only after the next iteration has detached.
+std::vector<std::thread> previous_threads;
+
+// The number of iterations that are about to detach, or have detached.
+std::atomic<int> detached_iteration_count;
+
+// Takes steps until the operation gets canceled by the detach of the main operation. The canceled threads
+// of an iteration overwrite the last error code of the next one, so the returned error codes are not used.
+void work(size_t id, int iteration)
+{
+	scheduler->start_operation(id);
+	while (detached_iteration_count.load() <= iteration)
+	{
+		scheduler->schedule_next();
+	}
+}
+
+void join_previous_threads()
+{
+	for (auto& thread : previous_threads)
+	{
+		thread.join();
+	}
+
+	previous_threads.clear();
+}
+
+// Detaches while every other operation is still paused. Their threads are woken by the cancellation, and
+// can still be waking up while the operations of the next iteration reuse their slots.
+void run_iteration(int iteration)
+{
+	scheduler->attach();
+
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= NUM_OPERATIONS; id++)
+	{
+		scheduler->create_operation(id);
+		threads.emplace_back(work, id, iteration);
+	}
+
+	for (int step = 0; step < NUM_MAIN_STEPS; step++)
+	{
+		scheduler->schedule_next();
+	}
+
+	// The other operations are paused, so they observe the flag once they are canceled.
+	detached_iteration_count.store(iteration + 1);
+	scheduler->detach();
+
+	join_previous_threads();
+	previous_threads = std::move(threads);
+}
+
+void test_cancel_at_detach(std::unique_ptr<HandoffEngine> engine)
+{
+	scheduler = new Scheduler();
+	detached_iteration_count.store(0);
+	assert(scheduler->set_handoff_engine(std::move(engine)), ErrorCode::Success);
+
+	for (int i = 0; i < NUM_ITERATIONS; i++)
+	{
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+		run_iteration(i);
+	}
+
+	join_previous_threads();
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_cancel_at_detach(std::make_unique<ConditionVariableHandoff>());
+		test_cancel_at_detach(std::make_unique<BatonHandoff>());
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
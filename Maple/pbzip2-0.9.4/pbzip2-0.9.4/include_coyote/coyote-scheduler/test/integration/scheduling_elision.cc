@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+// Number of scheduling points that the main operation passes while it is the only enabled operation.
+constexpr auto NUM_SOLO_STEPS = 1000;
+
+Scheduler* scheduler;
+
+int shared_var;
+bool race_found;
+
+void work(size_t operation_id, int value)
+{
+	scheduler->start_operation(operation_id);
+
+	shared_var = value;
+	scheduler->schedule_next();
+	if (shared_var != value)
+	{
+		race_found = true;
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+
+	scheduler->attach();
+
+	// These scheduling points are elided, as the main operation is the only enabled operation.
+	for (int i = 0; i < NUM_SOLO_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID, 1);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID, 2);
+
+	scheduler->schedule_next();
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	// The main operation runs alone again after joining.
+	for (int i = 0; i < NUM_SOLO_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test(Scheduler* new_scheduler)
+{
+	scheduler = new_scheduler;
+	assert(scheduler->set_scheduling_elision(true), ErrorCode::Success);
+
+	race_found = false;
+	for (int i = 0; i < 100; i++)
+	{
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+		run_iteration();
+	}
+
+	assert(race_found, "race was not found.");
+
+	scheduler->attach();
+	assert(scheduler->set_scheduling_elision(false), ErrorCode::ClientAttached);
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test(new Scheduler((size_t)42));
+		test(new Scheduler("ProbabilisticRandomStrategy"));
+		test(new Scheduler("PCTStrategy"));
+		test(new Scheduler("DFSStrategy"));
+		test(new Scheduler("FairPCTStrategy", 10));
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 3;
+constexpr auto MAX_ITERATIONS = 1000;
+
+Scheduler* scheduler;
+
+// The operations increment their own counter, so every interleaving of the same number of steps reaches the
+// same state, and the counters identify the state of both operations.
+int counters[2];
+
+// The scheduling decisions of the current iteration.
+std::string schedule;
+
+bool is_pruning_enabled;
+
+// Records the decisions of DFS, which only repeats a schedule once it has explored every schedule.
+class RecordingDFSStrategy : public DFSStrategy
+{
+public:
+	size_t next_operation(Operations& operations) override
+	{
+		const size_t operation_id = DFSStrategy::next_operation(operations);
+		schedule += std::to_string(operation_id);
+		return operation_id;
+	}
+};
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		counters[id - 1]++;
+		if (is_pruning_enabled)
+		{
+			scheduler->report_state(counters[0] * (NUM_STEPS + 1) + counters[1]);
+		}
+
+		scheduler->schedule_next();
+	}
+
+	scheduler->complete_operation(id);
+}
+
+void run_iteration()
+{
+	counters[0] = 0;
+	counters[1] = 0;
+	schedule.clear();
+
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+// Runs DFS until it starts over with the first schedule, and returns the number of explored schedules.
+size_t explore(bool with_pruning)
+{
+	is_pruning_enabled = with_pruning;
+	scheduler = new Scheduler(std::make_unique<RecordingDFSStrategy>());
+
+	run_iteration();
+	const std::string first_schedule = schedule;
+
+	size_t iterations = 1;
+	while (iterations < MAX_ITERATIONS)
+	{
+		run_iteration();
+		if (schedule == first_schedule)
+		{
+			break;
+		}
+
+		iterations++;
+	}
+
+	assert(iterations < MAX_ITERATIONS, "DFS did not start over.");
+	if (with_pruning)
+	{
+		assert(scheduler->distinct_state_count() == (NUM_STEPS + 1) * (NUM_STEPS + 1) - 1,
+			"DFS with pruning did not reach every state.");
+	}
+	else
+	{
+		assert(scheduler->distinct_state_count() == 0, "reported states without pruning.");
+	}
+
+	delete scheduler;
+	return iterations;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		const size_t iterations = explore(false);
+		const size_t pruned_iterations = explore(true);
+		std::cout << "[test] explored " << iterations << " schedules, and " << pruned_iterations <<
+			" schedules with pruning." << std::endl;
+		assert(pruned_iterations < iterations, "pruning did not skip any schedule.");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/runners/test_campaign.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + 1;
+	scheduler->complete_operation(id);
+}
+
+// Runs a racy increment on an attached scheduler, and returns false if the race was exposed.
+bool test_race()
+{
+	shared_var = 0;
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	return shared_var == 2;
+}
+
+// Checks that the seed of each buggy iteration reproduces the race on a new scheduler.
+void check_bug_seeds(const TestCampaign& campaign)
+{
+	Scheduler* campaign_scheduler = scheduler;
+	for (const CampaignBug& bug : campaign.found_bugs())
+	{
+		assert(bug.error_code, ErrorCode::Success);
+
+		scheduler = new Scheduler(bug.seed);
+		assert(scheduler->attach(), ErrorCode::Success);
+		assert(scheduler->seed() == bug.seed, "the seed of the replayed iteration does not match.");
+		assert(!test_race(), "the seed of a buggy iteration did not reproduce the race.");
+		scheduler->detach();
+		delete scheduler;
+	}
+
+	scheduler = campaign_scheduler;
+}
+
+void test_iteration_budget()
+{
+	scheduler = new Scheduler((size_t)42);
+	TestCampaign campaign(*scheduler, 100, std::chrono::milliseconds(0), false);
+	assert(campaign.run(test_race), ErrorCode::Success);
+
+	assert(campaign.completed_iterations() == 100, "the iteration budget was not spent.");
+	assert(campaign.bug_found(), "did not find the race.");
+	assert(campaign.found_bugs().size() < 100, "every iteration was reported as buggy.");
+	assert(campaign.iterations_per_second() > 0, "the throughput was not measured.");
+	assert(campaign.time_to_first_bug_seconds() >= 0, "the time to the first bug was not measured.");
+	assert(campaign.time_to_first_bug_seconds() <= campaign.elapsed_seconds(), "the first bug was found too late.");
+	for (size_t i = 1; i < campaign.found_bugs().size(); i++)
+	{
+		assert(campaign.found_bugs()[i - 1].iteration < campaign.found_bugs()[i].iteration,
+			"the bugs are not ordered by iteration.");
+	}
+
+	check_bug_seeds(campaign);
+	delete scheduler;
+}
+
+void test_stop_on_first_bug()
+{
+	scheduler = new Scheduler((size_t)42);
+	TestCampaign campaign(*scheduler, 100, std::chrono::milliseconds(0), true);
+	assert(campaign.run(test_race), ErrorCode::Success);
+
+	assert(campaign.found_bugs().size() == 1, "the campaign did not stop at the first bug.");
+	assert(campaign.completed_iterations() == campaign.found_bugs()[0].iteration + 1,
+		"the campaign ran past the first bug.");
+
+	check_bug_seeds(campaign);
+	delete scheduler;
+}
+
+void test_time_budget()
+{
+	scheduler = new Scheduler((size_t)42);
+	TestCampaign campaign(*scheduler, 0, std::chrono::milliseconds(100), false);
+	assert(campaign.run([]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		return true;
+	}), ErrorCode::Success);
+
+	assert(!campaign.bug_found(), "found a bug in a correct test.");
+	assert(campaign.time_to_first_bug_seconds() < 0, "reported a time to the first bug without a bug.");
+	assert(campaign.elapsed_seconds() >= 0.1, "the campaign stopped before the time budget was spent.");
+	assert(campaign.elapsed_seconds() < 1, "the campaign ran past the time budget.");
+	assert(campaign.completed_iterations() > 1, "the campaign ran a single iteration.");
+	delete scheduler;
+}
+
+void test_scheduler_error()
+{
+	scheduler = new Scheduler((size_t)42);
+	TestCampaign campaign(*scheduler, 10, std::chrono::milliseconds(0), true);
+
+	// The campaign is driven manually, and the scheduler reports the misuse as the bug.
+	while (campaign.next_iteration())
+	{
+		scheduler->attach();
+		scheduler->start_operation(WORK_THREAD_1_ID);
+		scheduler->detach();
+		campaign.complete_iteration(true);
+	}
+
+	assert(campaign.completed_iterations() == 1, "the campaign did not stop at the first bug.");
+	assert(campaign.found_bugs()[0].error_code, ErrorCode::NotExistingOperation);
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_iteration_budget();
+		test_stop_on_first_bug();
+		test_time_budget();
+		test_scheduler_error();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
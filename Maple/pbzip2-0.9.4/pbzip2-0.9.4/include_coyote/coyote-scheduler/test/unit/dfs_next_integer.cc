@@ -9,6 +9,7 @@ using namespace coyote;
 
 constexpr auto WORK_THREAD_1_ID = 1;
 constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto MAX_INTEGER_CHOICES = 3;
 
 Scheduler* scheduler;
 
@@ -60,6 +61,64 @@ void run_iteration()
 	assert(scheduler->error_code(), ErrorCode::Success);
 }
 
+// Asks for an integer out of the largest range, such as the ones of streamcluster, and checks that DFS
+// explores only its lowest values, in reverse order, and then starts over.
+void test_large_integer_range()
+{
+	scheduler = new Scheduler(std::make_unique<DFSStrategy>((size_t)MAX_INTEGER_CHOICES));
+
+	std::string trace;
+	for (int i = 0; i <= MAX_INTEGER_CHOICES; i++)
+	{
+		scheduler->attach();
+		trace += std::to_string(scheduler->next_integer(2147483647));
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+
+	delete scheduler;
+	assert(trace == "2102", "DFS did not bound the explored integer values.");
+}
+
+// Asks for an integer out of the 'size_t' range that streamcluster passes to 'FFI_next_integer', which
+// does not fit in an 'int', and checks that DFS explores it like the largest 'int' range.
+void test_streamcluster_integer_range()
+{
+	scheduler = new Scheduler(std::make_unique<DFSStrategy>((size_t)MAX_INTEGER_CHOICES));
+
+	std::string trace;
+	for (int i = 0; i <= MAX_INTEGER_CHOICES; i++)
+	{
+		scheduler->attach();
+		trace += std::to_string(scheduler->next_integer((size_t)2147483648));
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+
+	delete scheduler;
+	assert(trace == "2102", "DFS did not explore the clamped integer range.");
+}
+
+// Asks for integers with bounds of every integer type that clients pass, which must all resolve to the
+// same 'next_integer' entry point.
+void test_integer_bound_types()
+{
+	scheduler = new Scheduler(std::make_unique<DFSStrategy>((size_t)MAX_INTEGER_CHOICES));
+	scheduler->attach();
+
+	std::string trace;
+	trace += std::to_string(scheduler->next_integer(4));
+	trace += std::to_string(scheduler->next_integer(4u));
+	trace += std::to_string(scheduler->next_integer(4l));
+	trace += std::to_string(scheduler->next_integer((uint64_t)4));
+	trace += std::to_string(scheduler->next_integer((size_t)4));
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	delete scheduler;
+	assert(trace == "22222", "DFS did not choose from bounds of every integer type.");
+}
+
 // This unit-test is to check all possible combinations of integer choices explored by DFS Strategy.
 // Two threads (with id's 1 and 2) and a next_integer(4) choice are used for testing.
 // 12 uniques traces should be explored by DFS Strategy. 'trace_all' contains all unique combinations of thread and
@@ -100,6 +159,9 @@ int main()
 		delete scheduler;
 
 		assert(trace_all.size() == 0, "All execution paths not covered by DFS testing.");
+		test_large_integer_range();
+		test_streamcluster_integer_range();
+		test_integer_bound_types();
 	}
 	catch (std::string error)
 	{
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_FIBER_HANDOFF_H
+#define COYOTE_FIBER_HANDOFF_H
+
+#if !defined(_WIN32)
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <ucontext.h>
+#include "handoff_engine.h"
+
+namespace coyote
+{
+	// Runs every controlled operation as a stackful fiber on the thread that attached to the scheduler,
+	// so passing control between operations is a user-space stack switch instead of an OS thread wakeup.
+	// Operations must be created with the 'create_operation' overload that takes the body of the
+	// operation, and all scheduler APIs must be invoked from that same thread. Thread-local storage is
+	// shared by all operations in this mode.
+	//
+	// Operations that are still paused when the scheduler detaches are never resumed or unwound, as the
+	// scheduler APIs they are paused in do not throw, so the stack can only be unwound by resuming the
+	// uncontrolled body. The destructors of the objects on their stacks never run, so locks they hold
+	// stay locked, and heap buffers and other resources they own leak. Their stacks are then reused by
+	// the next iteration. Bodies should therefore complete before the main operation detaches, or only
+	// pause while they own no resources.
+	//
+	// Every operation runs on the carrier thread, so a call that blocks the thread inside a body, such
+	// as 'usleep' or a wait on a libevent loop, stalls all the operations until it returns, and deadlocks
+	// if it waits for another operation. Bodies must wait through the scheduler APIs instead.
+	class FiberHandoff : public HandoffEngine
+	{
+	private:
+		struct Fiber
+		{
+			// The saved execution context of this fiber.
+			ucontext_t context;
+
+			// The stack of this fiber, or null if it runs on the stack of the carrier thread.
+			char* stack;
+
+			// The body of the operation that runs on this fiber.
+			std::function<void()> body;
+
+			// The fiber that launched this fiber and is waiting for it to pause for the first time.
+			Fiber* launcher;
+
+			// The engine that owns this fiber.
+			FiberHandoff* engine;
+		};
+
+		// Size in bytes of the stack allocated for each fiber.
+		const size_t stack_size;
+
+		// Map from operation ids to their fibers in the current iteration.
+		std::unordered_map<size_t, std::unique_ptr<Fiber>> fibers;
+
+		// Stacks released by previous iterations that can be reused.
+		std::vector<char*> free_stacks;
+
+		// The fiber of the operation that runs on the stack of the carrier thread.
+		Fiber* carrier;
+
+	public:
+		FiberHandoff(size_t stack_size = 1 << 20) noexcept;
+		~FiberHandoff();
+
+		FiberHandoff(FiberHandoff&& engine) = delete;
+		FiberHandoff(FiberHandoff const&) = delete;
+
+		FiberHandoff& operator=(FiberHandoff&& engine) = delete;
+		FiberHandoff& operator=(FiberHandoff const&) = delete;
+
+		void wait(Operation& op, std::unique_lock<std::mutex>& lock);
+		void notify(Operation& op);
+		void handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock);
+		bool supports_launch();
+		void release(Operation& completed, Operation& next, std::unique_lock<std::mutex>& lock);
+		void launch(Operation& current, Operation& op, std::function<void()> body,
+			std::unique_lock<std::mutex>& lock);
+		void reset(std::unique_lock<std::mutex>& lock);
+		std::string get_description();
+
+	private:
+		// Releases the fibers of the current iteration, and keeps their stacks for reuse.
+		void release_fibers();
+
+		// Returns the fiber of the specified operation, creating one that runs on the stack of the
+		// carrier thread if the operation was not launched by this engine.
+		Fiber& get_fiber(const Operation& op);
+
+		char* allocate_stack();
+
+		static void run(unsigned int high_bits, unsigned int low_bits);
+	};
+}
+
+#endif // !_WIN32
+
+#endif // COYOTE_FIBER_HANDOFF_H
@@ -5,40 +5,98 @@
 #define COYOTE_DFS_STRATEGY_H
 
 #include "../strategy.h"
-#include <list>
-#include <map>
-#include <stack>
+#include <vector>
 
 namespace coyote
 {
 	class DFSStrategy : public Strategy
 	{
 	private:
+		// A scheduling index of the current iteration. Its choices are explored from the last one down to the
+		// first, so the choices left to explore are the ones below the current index.
+		struct Frame
+		{
+			// The index of the current choice, which is also the number of choices left to explore.
+			size_t index;
 
-		// Stack of scheduling choices
-		std::map<int, std::stack<size_t>*>* ScheduleStack;
+			// The offset of the choices in 'operation_choices' if they are operations, else the value of the
+			// first choice, since value choices are consecutive.
+			size_t offset;
+
+			// True if the choices are operations, else false if they are values.
+			bool is_operation_choice;
+		};
+
+		// The scheduling indices of the current iteration, which the next iteration replays up to the last
+		// index that has choices left to explore.
+		std::vector<Frame> frames;
+
+		// The enabled operations of the operation choices of 'frames', stored contiguously in order.
+		std::vector<size_t> operation_choices;
+
+		// The number of values of an integer choice that are explored, starting from the lowest one.
+		const size_t max_integer_choices;
 
 		// Current scheduling index (next sch point)
 		int SchIndex;
 
-		// Returns the next choice (operation or bool or integer)
-		size_t next_choice(std::vector<size_t> choices);
+		// Number of scheduling indices that the current iteration replays from the previous one
+		int ReplayLength;
+
+		// Scheduling index from which the current iteration only reaches known states, or -1
+		int PruneIndex;
+
+		// Returns the next operation choice out of the specified ones.
+		size_t next_choice(const std::vector<size_t>& choices);
+
+		// Returns the next value choice out of the values below 'count'.
+		size_t next_choice(size_t count);
+
+		// Returns the current choice of the specified frame.
+		size_t current_choice(const Frame& frame) const;
+
+		// Drops the frames from the specified scheduling index onwards, with their operation choices.
+		void truncate(size_t index);
 
 	public:
 		DFSStrategy() noexcept;
 
+		// Explores at most the specified number of values of each integer choice, instead of the default of
+		// 64, which bounds the tree of programs that ask for integers out of very large ranges.
+		explicit DFSStrategy(size_t max_integer_choices) noexcept;
+
+		// Explores only the subtree of schedules that start with the specified choices, such as a subtree
+		// that another explorer split off with 'split_subtrees'.
+		explicit DFSStrategy(const std::vector<size_t>& prefix) noexcept;
+
 		// Returns the next operation.
 		size_t next_operation(Operations& operations);
 
 		// Returns the next boolean choice.
 		bool next_boolean();
 
-		// Returns the next integer choice.
+		// Returns the next integer choice, out of at most 'max_integer_choices' values.
 		int next_integer(int max_value);
 
+		// Prunes the choices that continue from the current scheduling index, unless they are replayed.
+		void visit_known_state();
+
 		// Prepares the next iteration.
 		void prepare_next_iteration();
 
+		// Returns true if the iteration that just completed was the last one of the explored tree, else
+		// false. This should be called between iterations.
+		bool is_exhausted() const;
+
+		// Returns the choices of the iteration that just completed, which 'DFSStrategy(prefix)' replays as its
+		// first iteration. This should be called between iterations.
+		std::vector<size_t> current_schedule() const;
+
+		// Hands off the unexplored choices of the shallowest scheduling index that has any, and returns the
+		// prefix of each of their subtrees, which this strategy then skips. Returns no prefix if every choice
+		// of the current path is explored. This should be called between iterations.
+		std::vector<std::vector<size_t>> split_subtrees();
+
 		// Description about the strategy
 		std::string get_description();
 
@@ -244,19 +244,70 @@ void reset_globals(){
 
 int run_coyote_iteration(int, char**);
 
+// Arguments of main, kept for the worker processes of a parallel run
+static int coyote_argc = 0;
+static char** coyote_argv = NULL;
+
+// Wall-clock budget of the testing iterations in milliseconds, or 0 if they are only bounded by count
+static size_t coyote_time_budget_ms = 0;
+
+// Runs one testing iteration, and returns true, as the scheduler reports the bugs that it finds
+static bool run_coyote_iteration_once(){
+
+	FFI_attach_scheduler();
+	fprintf(stderr, "Running iteration with seed: %lu\n", FFI_seed());
+	run_coyote_iteration(coyote_argc, coyote_argv);
+	FFI_detach_scheduler();
+	reset_globals();
+	return true;
+}
+
+// Runs the testing iterations using the scheduler created by the caller, and returns 1 if one found a bug
+static int run_coyote_iterations(size_t num_iterations){
+
+	int bug_found = FFI_run_campaign(num_iterations, coyote_time_budget_ms, false, &run_coyote_iteration_once, NULL);
+	FFI_delete_scheduler();
+	return bug_found;
+}
+
+// Entry point of each worker process forked by FFI_run_parallel
+static void coyote_worker_main(size_t first_seed, size_t num_iterations){
+
+	FFI_create_scheduler_w_seed(first_seed);
+	run_coyote_iterations(num_iterations);
+}
+
 int main(int argc, char* argv[]){
 
-	FFI_create_scheduler();
+	coyote_argc = argc;
+	coyote_argv = argv;
 
-	for(int i = 0; i < 1000; i++){
-		fprintf(stderr, "Running iteration: %d, seed: %lu\n", i, FFI_seed());
-		FFI_attach_scheduler();
-		run_coyote_iteration(argc, argv);
-		FFI_detach_scheduler();
-		reset_globals();
+	// Set COYOTE_ITERATIONS to change the number of iterations, and COYOTE_TIME_BUDGET_MS to also stop
+	// the iterations once that many milliseconds have passed
+	size_t num_iterations = 1000;
+	if(getenv("COYOTE_ITERATIONS") != NULL){
+		num_iterations = strtoull(getenv("COYOTE_ITERATIONS"), NULL, 10);
 	}
 
-	FFI_delete_scheduler();
+	if(getenv("COYOTE_TIME_BUDGET_MS") != NULL){
+		coyote_time_budget_ms = strtoull(getenv("COYOTE_TIME_BUDGET_MS"), NULL, 10);
+	}
+
+	// Set COYOTE_WORKERS to split the iterations across that many worker processes
+	const char* workers = getenv("COYOTE_WORKERS");
+	if(workers != NULL && atoi(workers) > 1){
+
+		size_t bug_seed = 0;
+		if(FFI_run_parallel(atoi(workers), num_iterations, (size_t)time(NULL), &coyote_worker_main, &bug_seed)){
+			fprintf(stderr, "Found a bug in the iteration with seed: %lu\n", bug_seed);
+			return 1;
+		}
+
+		return 0;
+	}
+
+	FFI_create_scheduler();
+	return run_coyote_iterations(num_iterations);
 }
 
 #define main(x, y) run_coyote_iteration(x, y)
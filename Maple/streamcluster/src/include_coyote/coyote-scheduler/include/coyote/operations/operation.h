@@ -5,36 +5,34 @@
 #define COYOTE_OPERATION_H
 
 #include <condition_variable>
-#include <unordered_set>
 #include <vector>
-#include "operation_status.h"
+#include "../handoff/baton.h"
 
 namespace coyote
 {
+	// Parking primitives and wait state of the operation that occupies a slot of an 'OperationTable'.
+	// Records are reused across iterations, so their containers keep their capacity and the hot path
+	// does not allocate once the table has warmed up.
 	class Operation
 	{
-	private:
-		// Set of operations that this operation is waiting to join.
-		std::unordered_set<size_t> pending_join_operation_ids;
-
-		// Set of resources that this operation is waiting for a signal.
-		std::unordered_set<size_t> pending_signal_resource_ids;
-
 	public:
-		// The unique id of this operation.
-		const size_t id;
-
-		// The current status of this operation.
-		OperationStatus status;
+		// The unique id of the operation that currently occupies this record.
+		size_t id;
 
 		// Conditional variable that can be used to block and schedule this operation.
 		std::condition_variable cv;
 
-		// Set of operations that are blocked until this operation completes.
-		std::unordered_set<size_t> blocked_operation_ids;
+		// Baton that can be used to block and schedule this operation.
+		Baton baton;
+
+		// Indices of the operations that are blocked until this operation completes.
+		std::vector<size_t> blocked_operation_indices;
+
+		// Indices of the operations that this operation is waiting to join.
+		std::vector<size_t> pending_join_operation_indices;
 
-		// True if this operation is currently scheduled, else false.
-		bool is_scheduled;
+		// Set of resources that this operation is waiting for a signal.
+		std::vector<size_t> pending_signal_resource_ids;
 
 		Operation(size_t operation_id) noexcept;
 
@@ -44,23 +42,9 @@ namespace coyote
 		Operation& operator=(Operation&& op) = delete;
 		Operation& operator=(Operation const&) = delete;
 
-		// Waits until the specified operation has completed.
-		void join_operation(size_t operation_id);
-
-		// Waits until the specified operations have completed.
-		void join_operations(const std::vector<size_t>& operation_ids, bool wait_all);
-
-		// Waits until the specified resource sends a signal.
-		void wait_resource_signal(size_t resource_id);
-
-		// Waits until the specified resources send a signal.
-		void wait_resource_signals(const size_t* resource_ids, size_t size, bool wait_all);
-
-		// Invoked when the specified operation completes.
-		bool on_join_operation(size_t operation_id);
-
-		// Invoked when the specified resource sends a signal.
-		bool on_resource_signal(size_t resource_id);
+		// Assigns this record to the operation with the specified id, and clears its wait state. Must not
+		// be called while a thread is waiting on the baton.
+		void reset(size_t operation_id) noexcept;
 	};
 }
 
@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_RECORDER_H
+#define COYOTE_TRACE_RECORDER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace coyote
+{
+	// The kinds of scheduling decisions in a trace.
+	enum class TraceDecision : unsigned char
+	{
+		Operation = 0,
+		Boolean = 1,
+		Integer = 2
+	};
+
+	// Layout of a trace file. The file starts with a header of four little-endian fields: the magic
+	// number, the format version, the iteration that was recorded, and the size of the payload in bytes.
+	// The payload follows the header, and holds one varint per decision that encodes the decided value
+	// shifted left by two bits, combined with the kind of the decision in the low two bits.
+	struct TraceFormat
+	{
+		static const uint32_t MAGIC = 0x52545943;
+		static const uint32_t VERSION = 1;
+		static const size_t ITERATION_OFFSET = 8;
+		static const size_t PAYLOAD_SIZE_OFFSET = 16;
+		static const size_t HEADER_SIZE = 24;
+
+		// The maximum size of an encoded decision.
+		static const size_t MAX_RECORD_SIZE = 10;
+	};
+
+	// Records the scheduling decisions of the current iteration into a trace file, so that a failing
+	// iteration can be replayed with 'ReplayStrategy'. On POSIX systems the file is memory-mapped, and
+	// the payload size in the header is updated with each decision, so the trace survives a crash of
+	// the program under test. Elsewhere, the trace is buffered and written when the iteration ends.
+	class TraceRecorder
+	{
+	private:
+		// The path of the trace file.
+		std::string path;
+
+		// The descriptor of the trace file, or -1 if the trace is buffered.
+		int file;
+
+		// The mapped or buffered contents of the trace file.
+		unsigned char* data;
+
+		// The number of bytes that fit in 'data'.
+		size_t capacity;
+
+		// The number of bytes of 'data' in use, including the header.
+		size_t size;
+
+	public:
+		// Creates the trace file at the specified path, or throws if it cannot be created.
+		TraceRecorder(const std::string& path);
+		~TraceRecorder();
+
+		TraceRecorder(TraceRecorder&& recorder) = delete;
+		TraceRecorder(TraceRecorder const&) = delete;
+
+		TraceRecorder& operator=(TraceRecorder&& recorder) = delete;
+		TraceRecorder& operator=(TraceRecorder const&) = delete;
+
+		// Discards the recorded decisions, and starts recording the specified iteration.
+		void begin_iteration(size_t iteration);
+
+		// Records a decision of the specified kind. Values must be less than 2^62. If the trace cannot
+		// grow, then the decision is dropped and the trace ends early.
+		void record(TraceDecision decision, size_t value) noexcept
+		{
+			if (capacity - size < TraceFormat::MAX_RECORD_SIZE && !grow())
+			{
+				return;
+			}
+
+			uint64_t encoded = (static_cast<uint64_t>(value) << 2) | static_cast<uint64_t>(decision);
+			while (encoded >= 0x80)
+			{
+				data[size++] = static_cast<unsigned char>(encoded | 0x80);
+				encoded >>= 7;
+			}
+
+			data[size++] = static_cast<unsigned char>(encoded);
+
+			const uint64_t payload_size = size - TraceFormat::HEADER_SIZE;
+			std::memcpy(data + TraceFormat::PAYLOAD_SIZE_OFFSET, &payload_size, sizeof(payload_size));
+		}
+
+		// Makes the decisions recorded so far visible in the trace file.
+		void flush();
+
+		// Returns the size of the recorded payload in bytes.
+		size_t payload_size() const noexcept;
+
+	private:
+		// Doubles the capacity of the trace. Returns false if the trace could not grow.
+		bool grow() noexcept;
+	};
+}
+
+#endif // COYOTE_TRACE_RECORDER_H
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "handoff/baton_handoff.h"
+
+namespace coyote
+{
+	BatonHandoff::BatonHandoff() noexcept :
+		parked_thread_count(0)
+	{
+	}
+
+	void BatonHandoff::wait(Operation& op, std::unique_lock<std::mutex>& lock)
+	{
+		parked_thread_count += 1;
+		lock.unlock();
+		op.baton.wait();
+		lock.lock();
+		unpark();
+	}
+
+	void BatonHandoff::notify(Operation& op)
+	{
+		op.baton.post();
+	}
+
+	void BatonHandoff::handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock)
+	{
+		parked_thread_count += 1;
+		lock.unlock();
+		next.baton.post();
+		current.baton.wait();
+		lock.lock();
+		unpark();
+	}
+
+	// A canceled thread can still be waking up from its baton when the scheduler detaches. If the next
+	// occupant of its slot parked on the same baton, the two threads would race for a single permit and
+	// one wakeup would be lost, so the slots are only released once every parked thread has left.
+	void BatonHandoff::reset(std::unique_lock<std::mutex>& lock)
+	{
+		while (parked_thread_count > 0)
+		{
+			unparked_cv.wait(lock);
+		}
+	}
+
+	std::string BatonHandoff::get_description()
+	{
+		return "Baton handoff.";
+	}
+
+	void BatonHandoff::unpark()
+	{
+		parked_thread_count -= 1;
+		if (parked_thread_count == 0)
+		{
+			unparked_cv.notify_all();
+		}
+	}
+}
@@ -0,0 +1,215 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include "metrics/scheduler_metrics.h"
+
+namespace coyote
+{
+	constexpr size_t NUM_METRICS = static_cast<size_t>(Metric::Count);
+
+	std::string metric_name(Metric metric)
+	{
+		switch (metric)
+		{
+		case Metric::SchedulingDecisions:
+			return "scheduling_decisions";
+		case Metric::ElidedSteps:
+			return "elided_steps";
+		case Metric::ContextSwitches:
+			return "context_switches";
+		case Metric::BlockedNanoseconds:
+			return "blocked_ns";
+		case Metric::ResourceWaits:
+			return "resource_waits";
+		case Metric::ResourceSignals:
+			return "resource_signals";
+		case Metric::AttachNanoseconds:
+			return "attach_ns";
+		case Metric::DetachNanoseconds:
+			return "detach_ns";
+		default:
+			return "unknown";
+		}
+	}
+
+	Histogram::Histogram() noexcept
+	{
+		clear();
+	}
+
+	void Histogram::merge(const Histogram& histogram) noexcept
+	{
+		for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+		{
+			buckets[bucket] += histogram.buckets[bucket];
+		}
+
+		count += histogram.count;
+		sum += histogram.sum;
+		max = std::max(max, histogram.max);
+	}
+
+	uint64_t Histogram::percentile(double fraction) const noexcept
+	{
+		const uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count));
+		uint64_t cumulative_count = 0;
+		for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+		{
+			cumulative_count += buckets[bucket];
+			if (cumulative_count >= rank && cumulative_count > 0)
+			{
+				// The largest value of the bucket, which is never larger than the largest recorded value.
+				const uint64_t bucket_max = bucket == 0 ? 0 : (UINT64_MAX >> (64 - bucket));
+				return std::min(bucket_max, max);
+			}
+		}
+
+		return max;
+	}
+
+	void Histogram::clear() noexcept
+	{
+		std::fill(buckets, buckets + NUM_BUCKETS, 0);
+		count = 0;
+		sum = 0;
+		max = 0;
+	}
+
+	IterationMetrics::IterationMetrics() noexcept
+	{
+		clear();
+	}
+
+	void IterationMetrics::merge(const IterationMetrics& metrics) noexcept
+	{
+		for (size_t i = 0; i < NUM_METRICS; i++)
+		{
+			counters[i] += metrics.counters[i];
+		}
+
+		enabled_operations.merge(metrics.enabled_operations);
+		blocked_nanoseconds.merge(metrics.blocked_nanoseconds);
+	}
+
+	void IterationMetrics::clear() noexcept
+	{
+		std::fill(counters, counters + NUM_METRICS, 0);
+		enabled_operations.clear();
+		blocked_nanoseconds.clear();
+	}
+
+	SchedulerMetrics::SchedulerMetrics() noexcept
+	{
+	}
+
+	void SchedulerMetrics::begin_iteration() noexcept
+	{
+		current.clear();
+	}
+
+	void SchedulerMetrics::end_iteration()
+	{
+		aggregate.merge(current);
+		history.insert(history.end(), current.counters, current.counters + NUM_METRICS);
+	}
+
+	const IterationMetrics& SchedulerMetrics::last_iteration() const noexcept
+	{
+		return current;
+	}
+
+	const IterationMetrics& SchedulerMetrics::total() const noexcept
+	{
+		return aggregate;
+	}
+
+	size_t SchedulerMetrics::iteration_count() const noexcept
+	{
+		return history.size() / NUM_METRICS;
+	}
+
+	uint64_t SchedulerMetrics::value(size_t iteration, Metric metric) const noexcept
+	{
+		return history[iteration * NUM_METRICS + static_cast<size_t>(metric)];
+	}
+
+	void SchedulerMetrics::write_csv(std::ostream& stream) const
+	{
+		stream << "iteration";
+		for (size_t i = 0; i < NUM_METRICS; i++)
+		{
+			stream << "," << metric_name(static_cast<Metric>(i));
+		}
+
+		stream << "\n";
+		for (size_t iteration = 0; iteration < iteration_count(); iteration++)
+		{
+			stream << iteration + 1;
+			for (size_t i = 0; i < NUM_METRICS; i++)
+			{
+				stream << "," << value(iteration, static_cast<Metric>(i));
+			}
+
+			stream << "\n";
+		}
+	}
+
+	static void write_json_counters(std::ostream& stream, const uint64_t* counters)
+	{
+		for (size_t i = 0; i < NUM_METRICS; i++)
+		{
+			stream << (i == 0 ? "" : ", ") << "\"" << metric_name(static_cast<Metric>(i)) << "\": " << counters[i];
+		}
+	}
+
+	static void write_json_histogram(std::ostream& stream, const Histogram& histogram)
+	{
+		stream << "{\"count\": " << histogram.count << ", \"sum\": " << histogram.sum << ", \"max\": " << histogram.max <<
+			", \"p50\": " << histogram.percentile(0.5) << ", \"p90\": " << histogram.percentile(0.9) <<
+			", \"p99\": " << histogram.percentile(0.99) << ", \"buckets\": [";
+
+		// Only the buckets that hold values are written, each as a pair of its upper bound and its count.
+		bool is_first = true;
+		for (size_t bucket = 0; bucket < Histogram::NUM_BUCKETS; bucket++)
+		{
+			if (histogram.buckets[bucket] > 0)
+			{
+				const uint64_t bucket_max = bucket == 0 ? 0 : (UINT64_MAX >> (64 - bucket));
+				stream << (is_first ? "" : ", ") << "[" << bucket_max << ", " << histogram.buckets[bucket] << "]";
+				is_first = false;
+			}
+		}
+
+		stream << "]}";
+	}
+
+	static void write_json_metrics(std::ostream& stream, const IterationMetrics& metrics)
+	{
+		stream << "{";
+		write_json_counters(stream, metrics.counters);
+		stream << ", \"enabled_operations_histogram\": ";
+		write_json_histogram(stream, metrics.enabled_operations);
+		stream << ", \"blocked_ns_histogram\": ";
+		write_json_histogram(stream, metrics.blocked_nanoseconds);
+		stream << "}";
+	}
+
+	void SchedulerMetrics::write_json(std::ostream& stream) const
+	{
+		stream << "{\n  \"iterations\": " << iteration_count() << ",\n  \"total\": ";
+		write_json_metrics(stream, aggregate);
+		stream << ",\n  \"last_iteration\": ";
+		write_json_metrics(stream, current);
+		stream << ",\n  \"per_iteration\": [";
+		for (size_t iteration = 0; iteration < iteration_count(); iteration++)
+		{
+			stream << (iteration == 0 ? "\n    {" : ",\n    {");
+			write_json_counters(stream, history.data() + iteration * NUM_METRICS);
+			stream << "}";
+		}
+
+		stream << "\n  ]\n}\n";
+	}
+}
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <cstdio>
+#include <dirent.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "runners/fork_server.h"
+
+namespace coyote
+{
+	// Returns the number of threads of this process, or '0' if it is unknown, such as on systems without
+	// a '/proc' file system.
+	static size_t thread_count() noexcept
+	{
+		DIR* dir = opendir("/proc/self/task");
+		if (dir == nullptr)
+		{
+			return 0;
+		}
+
+		size_t count = 0;
+		while (dirent* entry = readdir(dir))
+		{
+			if (entry->d_name[0] != '.')
+			{
+				count += 1;
+			}
+		}
+
+		closedir(dir);
+		return count;
+	}
+
+	ForkServer::ForkServer(size_t num_iterations, size_t first_seed, bool stop_on_first_bug) noexcept :
+		num_iterations(num_iterations),
+		first_seed(first_seed),
+		stop_on_first_bug(stop_on_first_bug),
+		is_child_process(false),
+		child_seed(0),
+		completed_iteration_count(0),
+		failed_iteration_count(0),
+		first_bug_seed(0)
+	{
+	}
+
+	ErrorCode ForkServer::fork_children() noexcept
+	{
+		try
+		{
+			if (is_child_process)
+			{
+				throw ErrorCode::Failure;
+			}
+			else if (thread_count() > 1)
+			{
+				// The other threads would not exist in the children, which would block on them.
+				throw ErrorCode::NotSupported;
+			}
+
+			for (size_t i = 0; i < num_iterations; i++)
+			{
+				if (stop_on_first_bug && failed_iteration_count > 0)
+				{
+					break;
+				}
+
+				// Flush buffered output, so that the child does not inherit and print it again.
+				fflush(nullptr);
+
+				const size_t seed = first_seed + i;
+				pid_t pid = fork();
+				if (pid < 0)
+				{
+					throw ErrorCode::Failure;
+				}
+				else if (pid == 0)
+				{
+					is_child_process = true;
+					child_seed = seed;
+					return ErrorCode::Success;
+				}
+
+				int status = 0;
+				while (waitpid(pid, &status, 0) < 0)
+				{
+					if (errno != EINTR)
+					{
+						throw ErrorCode::Failure;
+					}
+				}
+
+				if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+				{
+					completed_iteration_count += 1;
+				}
+				else
+				{
+					// The child reported a bug, or crashed in the middle of its iteration.
+					if (failed_iteration_count == 0)
+					{
+						first_bug_seed = seed;
+					}
+
+					failed_iteration_count += 1;
+				}
+			}
+		}
+		catch (ErrorCode error_code)
+		{
+			return error_code;
+		}
+		catch (...)
+		{
+			return ErrorCode::Failure;
+		}
+
+		return ErrorCode::Success;
+	}
+
+	bool ForkServer::is_child() const noexcept
+	{
+		return is_child_process;
+	}
+
+	size_t ForkServer::seed() const noexcept
+	{
+		return child_seed;
+	}
+
+	void ForkServer::exit_child(bool bug_found) noexcept
+	{
+		fflush(nullptr);
+		_exit(bug_found ? 1 : 0);
+	}
+
+	bool ForkServer::bug_found() const noexcept
+	{
+		return failed_iteration_count > 0;
+	}
+
+	size_t ForkServer::bug_seed() const noexcept
+	{
+		return first_bug_seed;
+	}
+
+	size_t ForkServer::completed_iterations() const noexcept
+	{
+		return completed_iteration_count;
+	}
+
+	size_t ForkServer::failed_iterations() const noexcept
+	{
+		return failed_iteration_count;
+	}
+}
+
+#endif // !_WIN32
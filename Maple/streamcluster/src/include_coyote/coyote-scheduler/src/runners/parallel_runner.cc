@@ -0,0 +1,332 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "runners/parallel_runner.h"
+
+namespace coyote
+{
+	// Kinds of records that a worker sends to the runner. Each record is a kind followed by a seed.
+	static constexpr uint64_t ITERATION_STARTED = 0;
+	static constexpr uint64_t ITERATION_PASSED = 1;
+	static constexpr uint64_t ITERATION_FAILED = 2;
+
+	// Reads exactly the specified number of bytes, and returns false if the pipe was closed first.
+	static bool read_fully(int fd, void* buffer, size_t size) noexcept
+	{
+		char* data = static_cast<char*>(buffer);
+		while (size > 0)
+		{
+			ssize_t count = read(fd, data, size);
+			if (count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (count <= 0)
+			{
+				return false;
+			}
+
+			data += count;
+			size -= count;
+		}
+
+		return true;
+	}
+
+	ParallelWorker::ParallelWorker(size_t index, size_t first_seed, size_t num_iterations, int pipe_fd) noexcept :
+		pipe_fd(pipe_fd),
+		started_iteration_count(0),
+		index(index),
+		first_seed(first_seed),
+		num_iterations(num_iterations)
+	{
+	}
+
+	size_t ParallelWorker::start_iteration() noexcept
+	{
+		started_iteration_count += 1;
+		const size_t seed = first_seed + started_iteration_count - 1;
+		send(ITERATION_STARTED, seed);
+		return seed;
+	}
+
+	void ParallelWorker::complete_iteration(bool bug_found) noexcept
+	{
+		send(bug_found ? ITERATION_FAILED : ITERATION_PASSED, first_seed + started_iteration_count - 1);
+	}
+
+	void ParallelWorker::send(size_t kind, size_t seed) noexcept
+	{
+		// Records are smaller than 'PIPE_BUF', so each write is atomic.
+		uint64_t record[2] = { kind, seed };
+		while (write(pipe_fd, record, sizeof(record)) < 0 && errno == EINTR)
+		{
+		}
+	}
+
+	ParallelRunner::ParallelRunner(size_t num_workers, size_t num_iterations, size_t seed) noexcept :
+		num_workers(num_workers),
+		num_iterations(num_iterations),
+		seed(seed),
+		completed_iteration_count(0),
+		is_bug_found(false),
+		first_bug_seed(0)
+	{
+	}
+
+	ErrorCode ParallelRunner::run(std::function<void(ParallelWorker&)> worker_main) noexcept
+	{
+		struct WorkerProcess
+		{
+			// The process id, or '-1' if the process was reaped.
+			pid_t pid;
+
+			// Read end of the pipe from the worker, or '-1' if it was closed.
+			int fd;
+
+			// True if the worker started an iteration that has not completed yet.
+			bool has_pending_iteration;
+
+			// The seed of the last iteration that the worker started.
+			size_t pending_seed;
+		};
+
+		std::vector<WorkerProcess> workers;
+		bool is_stopping = false;
+
+		auto stop_workers = [&workers, &is_stopping]()
+		{
+			is_stopping = true;
+			for (auto& worker : workers)
+			{
+				if (worker.pid > 0)
+				{
+					kill(worker.pid, SIGTERM);
+				}
+			}
+		};
+
+		auto report_bug = [this, &stop_workers, &is_stopping](size_t bug_seed)
+		{
+			if (!is_bug_found)
+			{
+				is_bug_found = true;
+				first_bug_seed = bug_seed;
+			}
+
+			if (!is_stopping)
+			{
+				stop_workers();
+			}
+		};
+
+		auto reap = [&report_bug, &is_stopping](WorkerProcess& worker)
+		{
+			int status = 0;
+			while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+			{
+			}
+
+			worker.pid = -1;
+			bool exited_normally = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+			if (!exited_normally && !is_stopping && worker.has_pending_iteration)
+			{
+				// The worker crashed in the middle of an iteration, which is how most assertions in
+				// the programs under test manifest.
+				report_bug(worker.pending_seed);
+			}
+		};
+
+		// Stops the workers after a failure, and closes their pipes and reaps them, so that no file
+		// descriptors or zombie processes are left behind.
+		auto release_workers = [&workers, &stop_workers, &reap]()
+		{
+			stop_workers();
+			for (auto& worker : workers)
+			{
+				if (worker.fd >= 0)
+				{
+					close(worker.fd);
+					worker.fd = -1;
+				}
+
+				if (worker.pid > 0)
+				{
+					reap(worker);
+				}
+			}
+		};
+
+		try
+		{
+			if (num_workers == 0)
+			{
+				throw ErrorCode::Failure;
+			}
+
+			completed_iteration_count = 0;
+			is_bug_found = false;
+			first_bug_seed = 0;
+
+			// Flush buffered output, so that the workers do not inherit and print it again.
+			fflush(nullptr);
+
+			const size_t iterations_per_worker = num_iterations / num_workers;
+			const size_t remaining_iterations = num_iterations % num_workers;
+			size_t next_seed = seed;
+			for (size_t i = 0; i < num_workers; i++)
+			{
+				const size_t worker_iterations = iterations_per_worker + (i < remaining_iterations ? 1 : 0);
+				if (worker_iterations == 0)
+				{
+					continue;
+				}
+
+				int fds[2];
+				if (pipe(fds) != 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				pid_t pid = fork();
+				if (pid < 0)
+				{
+					close(fds[0]);
+					close(fds[1]);
+					throw ErrorCode::Failure;
+				}
+				else if (pid == 0)
+				{
+					close(fds[0]);
+					for (auto& worker : workers)
+					{
+						close(worker.fd);
+					}
+
+					int exit_status = 0;
+					try
+					{
+						ParallelWorker worker(i, next_seed, worker_iterations, fds[1]);
+						worker_main(worker);
+					}
+					catch (...)
+					{
+						exit_status = 1;
+					}
+
+					fflush(nullptr);
+					_exit(exit_status);
+				}
+
+				close(fds[1]);
+				workers.push_back({ pid, fds[0], false, 0 });
+				next_seed += worker_iterations;
+			}
+
+			std::vector<pollfd> poll_fds;
+			std::vector<WorkerProcess*> polled_workers;
+			while (true)
+			{
+				poll_fds.clear();
+				polled_workers.clear();
+				for (auto& worker : workers)
+				{
+					if (worker.fd >= 0)
+					{
+						poll_fds.push_back({ worker.fd, POLLIN, 0 });
+						polled_workers.push_back(&worker);
+					}
+				}
+
+				if (poll_fds.empty())
+				{
+					break;
+				}
+
+				if (poll(poll_fds.data(), poll_fds.size(), -1) < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+
+					throw ErrorCode::Failure;
+				}
+
+				for (size_t i = 0; i < poll_fds.size(); i++)
+				{
+					if (poll_fds[i].revents == 0)
+					{
+						continue;
+					}
+
+					WorkerProcess& worker = *polled_workers[i];
+					uint64_t record[2];
+					if (!read_fully(worker.fd, record, sizeof(record)))
+					{
+						// The worker has exited.
+						close(worker.fd);
+						worker.fd = -1;
+						reap(worker);
+						continue;
+					}
+
+					if (record[0] == ITERATION_STARTED)
+					{
+						worker.has_pending_iteration = true;
+						worker.pending_seed = record[1];
+					}
+					else if (record[0] == ITERATION_PASSED)
+					{
+						worker.has_pending_iteration = false;
+						completed_iteration_count += 1;
+					}
+					else
+					{
+						worker.has_pending_iteration = false;
+						report_bug(record[1]);
+					}
+				}
+			}
+		}
+		catch (ErrorCode error_code)
+		{
+			release_workers();
+			return error_code;
+		}
+		catch (...)
+		{
+			release_workers();
+			return ErrorCode::Failure;
+		}
+
+		return ErrorCode::Success;
+	}
+
+	bool ParallelRunner::bug_found() noexcept
+	{
+		return is_bug_found;
+	}
+
+	size_t ParallelRunner::bug_seed() noexcept
+	{
+		return first_bug_seed;
+	}
+
+	size_t ParallelRunner::completed_iterations() noexcept
+	{
+		return completed_iteration_count;
+	}
+}
+
+#endif // !_WIN32
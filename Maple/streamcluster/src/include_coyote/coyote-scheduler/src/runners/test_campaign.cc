@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "runners/test_campaign.h"
+
+namespace coyote
+{
+	TestCampaign::TestCampaign(Scheduler& scheduler, size_t max_iterations, std::chrono::milliseconds time_budget,
+		bool stop_on_first_bug) noexcept :
+		scheduler(scheduler),
+		max_iterations(max_iterations),
+		time_budget(time_budget),
+		stop_on_first_bug(stop_on_first_bug),
+		start_time(),
+		elapsed_time(0),
+		completed_iteration_count(0),
+		bugs()
+	{
+	}
+
+	ErrorCode TestCampaign::run(std::function<bool()> test) noexcept
+	{
+		try
+		{
+			while (next_iteration())
+			{
+				ErrorCode error_code = scheduler.attach();
+				if (error_code != ErrorCode::Success)
+				{
+					// The scheduler could not start the iteration, so the campaign cannot make progress.
+					return error_code;
+				}
+
+				bool passed = false;
+				try
+				{
+					passed = test();
+				}
+				catch (...)
+				{
+					// An exception that escapes the test is reported as a bug of the iteration.
+				}
+
+				scheduler.detach();
+				complete_iteration(passed);
+			}
+		}
+		catch (ErrorCode error_code)
+		{
+			return error_code;
+		}
+		catch (...)
+		{
+			return ErrorCode::Failure;
+		}
+
+		return ErrorCode::Success;
+	}
+
+	bool TestCampaign::next_iteration() noexcept
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if (completed_iteration_count == 0)
+		{
+			start_time = now;
+		}
+
+		if (max_iterations > 0 && completed_iteration_count >= max_iterations)
+		{
+			return false;
+		}
+		else if (time_budget.count() > 0 && completed_iteration_count > 0 && now - start_time >= time_budget)
+		{
+			return false;
+		}
+		else if (stop_on_first_bug && !bugs.empty())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
+	void TestCampaign::complete_iteration(bool passed)
+	{
+		elapsed_time = std::chrono::steady_clock::now() - start_time;
+
+		const ErrorCode error_code = scheduler.error_code();
+		if (!passed || error_code != ErrorCode::Success)
+		{
+			bugs.push_back({ completed_iteration_count, scheduler.seed(), error_code, elapsed_time });
+			scheduler.report_bug();
+		}
+
+		completed_iteration_count += 1;
+	}
+
+	size_t TestCampaign::completed_iterations() const noexcept
+	{
+		return completed_iteration_count;
+	}
+
+	double TestCampaign::elapsed_seconds() const noexcept
+	{
+		return std::chrono::duration<double>(elapsed_time).count();
+	}
+
+	double TestCampaign::iterations_per_second() const noexcept
+	{
+		const double seconds = elapsed_seconds();
+		return seconds > 0 ? completed_iteration_count / seconds : 0;
+	}
+
+	bool TestCampaign::bug_found() const noexcept
+	{
+		return !bugs.empty();
+	}
+
+	const std::vector<CampaignBug>& TestCampaign::found_bugs() const noexcept
+	{
+		return bugs;
+	}
+
+	double TestCampaign::time_to_first_bug_seconds() const noexcept
+	{
+		return bugs.empty() ? -1 : std::chrono::duration<double>(bugs.front().time).count();
+	}
+}
@@ -2,39 +2,79 @@
 // Licensed under the MIT License.
 
 #include "strategies/Probabilistic/pct_strategy.h"
-#include <iostream>
+#include <algorithm>
+
+// Random priorities have their highest bit set, so that lowered priorities, which count down from below
+// it, are lower than all of them.
+constexpr uint64_t RANDOM_PRIORITY_BIT = (uint64_t)1 << 63;
 
 namespace coyote
 {
 	PCTStrategy::PCTStrategy(int max_priority_switch_points) noexcept : 
 		max_priority_switch_points(max_priority_switch_points), 
-		random_generator(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+		random_generator(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
+		operation_slots(nullptr),
+		next_lowered_priority(RANDOM_PRIORITY_BIT - 1),
+		next_change_point_index(0)
 	{
 		this->schedule_length = 0;
 		this->scheduled_steps = 0;
-		this->prioritized_operations = new std::list<size_t>();
-		this->priority_change_points = new std::set<int>();
+		this->priority_change_points.reserve(max_priority_switch_points > 0 ? max_priority_switch_points : 0);
 	}
 
 	size_t PCTStrategy::next_operation(Operations& operations)
 	{
-		std::vector<size_t> enabled_oprs = operations.get_enabled_operation_ids();
 		this->scheduled_steps++;
-		return get_prioritized_operation(enabled_oprs);
-	}
+		const std::vector<size_t>& ops = operations.enabled_operation_ids();
 
-	bool PCTStrategy::next_boolean()
-	{
-		this->scheduled_steps++;
-		return random_generator.next() & 1;
+		// Change points on steps that were taken by boolean or integer choices are not reached.
+		while (this->next_change_point_index < this->priority_change_points.size() &&
+			this->priority_change_points[this->next_change_point_index] < this->scheduled_steps)
+		{
+			this->next_change_point_index++;
+		}
+
+		if (this->next_change_point_index < this->priority_change_points.size() &&
+			this->priority_change_points[this->next_change_point_index] == this->scheduled_steps)
+		{
+			if (ops.size() == 1)
+			{
+				move_priority_change_point_forward(this->scheduled_steps);
+			}
+			else
+			{
+				priority(get_highest_priority_enabled_operation(ops)) = this->next_lowered_priority--;
+				this->next_change_point_index++;
+			}
+		}
+
+		return get_highest_priority_enabled_operation(ops);
 	}
 
-	int PCTStrategy::next_integer(int max_value)
+	void PCTStrategy::skip_steps(size_t /*operation_id*/, size_t count)
 	{
-		this->scheduled_steps++;
-		return random_generator.next() % max_value;
+		// A priority change point on a step with a single enabled operation moves forward to the next
+		// free step (see 'next_operation'), so change points on elided steps end up on the first free
+		// steps after them.
+		const int last_step = this->scheduled_steps + (int)count;
+		while (this->next_change_point_index < this->priority_change_points.size() &&
+			this->priority_change_points[this->next_change_point_index] <= last_step)
+		{
+			if (this->priority_change_points[this->next_change_point_index] <= this->scheduled_steps)
+			{
+				this->next_change_point_index++;
+			}
+			else
+			{
+				move_priority_change_point_forward(last_step);
+			}
+		}
+
+		this->scheduled_steps = last_step;
 	}
 
+	// The change points of an iteration are distinct steps chosen uniformly at random from the length of
+	// the longest schedule so far. They are sampled by rejection, since there are only a few of them.
 	void PCTStrategy::prepare_next_iteration()
 	{
 		if (this->schedule_length < this->scheduled_steps)
@@ -43,35 +83,25 @@ namespace coyote
 		}
 
 		this->scheduled_steps = 0;
-		this->prioritized_operations = new std::list<size_t>();
-		this->priority_change_points = new std::set<int>();
-
-		std::list<int> range;
-		for (int i = 0; i < this->schedule_length; i++)
+		this->operation_slots = nullptr;
+		this->arena.reset();
+		this->priorities.clear();
+		this->next_lowered_priority = RANDOM_PRIORITY_BIT - 1;
+
+		this->priority_change_points.clear();
+		this->next_change_point_index = 0;
+		const size_t num_change_points = (size_t)std::min(this->max_priority_switch_points, this->schedule_length);
+		while (this->priority_change_points.size() < num_change_points)
 		{
-			range.push_back(i);
-		}
-
-		// Shuffling the "range" list using Fisher-Yates algorithm.
-		for (int idx = (range.size() - 1); idx >= 1; idx--)
-		{
-			int point = this->random_generator.next() % this->schedule_length;
-
-			std::list<int>::iterator idx_itr = range.begin();
-			std::advance(idx_itr, idx);
-
-			std::list<int>::iterator point_itr = range.begin();
-			std::advance(point_itr, point);
-
-			std::iter_swap(idx_itr, point_itr);
+			const int point = (int)(this->random_generator.next() % this->schedule_length);
+			if (std::find(this->priority_change_points.begin(), this->priority_change_points.end(), point) ==
+				this->priority_change_points.end())
+			{
+				this->priority_change_points.push_back(point);
+			}
 		}
 
-		std::list<int>::iterator pri_it = range.begin();
-		for (int i = 0; i < this->max_priority_switch_points && pri_it != range.end(); i++)
-		{
-			this->priority_change_points->insert(*pri_it);
-			pri_it++;
-		}
+		std::sort(this->priority_change_points.begin(), this->priority_change_points.end());
 	}
 
 	bool PCTStrategy::is_fair()
@@ -89,69 +119,60 @@ namespace coyote
 		return "Testing using PCT Strategy with priority change points - " + std::to_string(this->max_priority_switch_points);
 	}
 
-	size_t PCTStrategy::get_prioritized_operation(std::vector<size_t> ops)
+	// A new operation gets a random priority, so it is equally likely to rank at any position among the
+	// priorities of the existing operations.
+	uint64_t& PCTStrategy::priority(size_t operation_id)
 	{
-		for (std::vector<size_t>::iterator it = ops.begin(); it != ops.end(); it++)
+		if (this->operation_slots == nullptr)
 		{
-			bool flag = true;
-			for (std::list<size_t>::iterator pri_it = this->prioritized_operations->begin(); pri_it != this->prioritized_operations->end(); pri_it++)
-			{
-				if (*it == *pri_it)
-				{
-					flag = false;
-					break;
-				}
-			}
-
-			if (flag)
-			{
-				auto mIndex = this->random_generator.next() % (this->prioritized_operations->size() + 1);
-				std::list<size_t>::iterator iter = this->prioritized_operations->begin();
-				std::advance(iter, mIndex);
-				this->prioritized_operations->insert(iter, *it);
-			}
+			this->operation_slots = this->arena.create<SlotMap>(SlotMap::allocator_type(this->arena));
 		}
 
-		if (this->priority_change_points->find(this->scheduled_steps) != this->priority_change_points->end())
+		auto it = this->operation_slots->find(operation_id);
+		if (it == this->operation_slots->end())
 		{
-			if (ops.size() == 1)
-			{
-				move_priority_change_point_forward();
-			}
-			else
-			{
-				size_t opr = get_highest_priority_enabled_operation(ops);
-				this->prioritized_operations->remove(opr);
-				this->prioritized_operations->push_back(opr);
-			}
+			it = this->operation_slots->emplace(operation_id, this->priorities.size()).first;
+			this->priorities.push_back(this->random_generator.next() | RANDOM_PRIORITY_BIT);
 		}
 
-		return get_highest_priority_enabled_operation(ops);
+		return this->priorities[it->second];
 	}
 
-	size_t PCTStrategy::get_highest_priority_enabled_operation(std::vector<size_t> choices)
+	size_t PCTStrategy::get_highest_priority_enabled_operation(const std::vector<size_t>& choices)
 	{
-		for (std::list<size_t>::iterator pri_it = this->prioritized_operations->begin(); pri_it != this->prioritized_operations->end(); pri_it++)
+		size_t highest_operation_id = choices.front();
+		uint64_t highest_priority = priority(highest_operation_id);
+		for (size_t i = 1; i < choices.size(); i++)
 		{
-			for (std::vector<size_t>::iterator it = choices.begin(); it != choices.end(); it++)
+			const uint64_t operation_priority = priority(choices[i]);
+			if (operation_priority > highest_priority)
 			{
-				if (*it == *pri_it)
-				{
-					return *it;
-				}
+				highest_operation_id = choices[i];
+				highest_priority = operation_priority;
 			}
 		}
+
+		return highest_operation_id;
 	}
 
-	void PCTStrategy::move_priority_change_point_forward()
+	// The next change point moves past the run of consecutive change points that follows the step, which
+	// keeps the change points sorted and distinct.
+	void PCTStrategy::move_priority_change_point_forward(int step)
 	{
-		this->priority_change_points->erase(this->scheduled_steps);
-		int new_priority_change_point = this->scheduled_steps + 1;
-		while (this->priority_change_points->find(new_priority_change_point) != this->priority_change_points->end())
+		size_t index = this->next_change_point_index;
+		int new_priority_change_point = step + 1;
+		while (index + 1 < this->priority_change_points.size() &&
+			this->priority_change_points[index + 1] <= new_priority_change_point)
 		{
-			new_priority_change_point = new_priority_change_point + 1;
+			if (this->priority_change_points[index + 1] == new_priority_change_point)
+			{
+				new_priority_change_point++;
+			}
+
+			this->priority_change_points[index] = this->priority_change_points[index + 1];
+			index++;
 		}
 
-		this->priority_change_points->insert(new_priority_change_point);
+		this->priority_change_points[index] = new_priority_change_point;
 	}
-}
\ No newline at end of file
+}
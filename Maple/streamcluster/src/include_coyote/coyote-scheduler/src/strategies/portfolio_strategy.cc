@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "strategies/portfolio_strategy.h"
+#include <cmath>
+
+//#define DEBUG_PORTFOLIO_STRATEGY
+
+#ifdef DEBUG_PORTFOLIO_STRATEGY
+#include <iostream>
+#endif
+
+// The prefix length of the fair PCT strategy until the first iteration took any scheduling step.
+constexpr auto INITIAL_PREFIX_LENGTH = 1000;
+
+namespace coyote
+{
+	PortfolioStrategy::PortfolioStrategy() :
+		current_arm(0),
+		fair_pct(nullptr),
+		scheduled_steps(0),
+		mean_schedule_length(0),
+		scheduled_iterations(0),
+		new_state_count(0),
+		known_state_count(0),
+		is_bug_found(false)
+	{
+		std::unique_ptr<ComboStrategy> combo(new ComboStrategy("PCTStrategy", "RandomStrategy", INITIAL_PREFIX_LENGTH));
+		fair_pct = combo.get();
+
+		arms.push_back({ std::unique_ptr<Strategy>(new RandomStrategy(
+			std::chrono::high_resolution_clock::now().time_since_epoch().count())), 0, 0 });
+		arms.push_back({ std::move(combo), 0, 0 });
+		arms.push_back({ std::unique_ptr<Strategy>(new ProbabilisticRandomStrategy(
+			std::chrono::high_resolution_clock::now().time_since_epoch().count())), 0, 0 });
+	}
+
+	PortfolioStrategy::PortfolioStrategy(std::vector<std::unique_ptr<Strategy>> strategies) :
+		current_arm(0),
+		fair_pct(nullptr),
+		scheduled_steps(0),
+		mean_schedule_length(0),
+		scheduled_iterations(0),
+		new_state_count(0),
+		known_state_count(0),
+		is_bug_found(false)
+	{
+		for (auto& strategy : strategies)
+		{
+			arms.push_back({ std::move(strategy), 0, 0 });
+		}
+
+		if (arms.empty())
+		{
+			throw "The portfolio has no strategy.";
+		}
+	}
+
+	size_t PortfolioStrategy::next_operation(Operations& operations)
+	{
+		scheduled_steps += 1;
+		return arms[current_arm].strategy->next_operation(operations);
+	}
+
+	void PortfolioStrategy::skip_steps(size_t operation_id, size_t count)
+	{
+		scheduled_steps += count;
+		arms[current_arm].strategy->skip_steps(operation_id, count);
+	}
+
+	void PortfolioStrategy::visit_known_state()
+	{
+		known_state_count += 1;
+		arms[current_arm].strategy->visit_known_state();
+	}
+
+	void PortfolioStrategy::visit_new_state()
+	{
+		new_state_count += 1;
+		arms[current_arm].strategy->visit_new_state();
+	}
+
+	void PortfolioStrategy::report_bug()
+	{
+		is_bug_found = true;
+		arms[current_arm].strategy->report_bug();
+	}
+
+	double PortfolioStrategy::iteration_reward() const
+	{
+		if (is_bug_found)
+		{
+			return 1;
+		}
+		else if (new_state_count + known_state_count == 0)
+		{
+			return 0;
+		}
+
+		return (double)new_state_count / (double)(new_state_count + known_state_count);
+	}
+
+	// A strategy that did not run yet is selected first. Ties go to the first strategy with the highest score,
+	// so that strategies with the same rewards and iterations take turns.
+	size_t PortfolioStrategy::select_arm() const
+	{
+		size_t total_iterations = 0;
+		for (const Arm& arm : arms)
+		{
+			if (arm.iterations == 0)
+			{
+				return &arm - arms.data();
+			}
+
+			total_iterations += arm.iterations;
+		}
+
+		size_t best_arm = 0;
+		double best_score = 0;
+		for (size_t i = 0; i < arms.size(); i++)
+		{
+			const double mean_reward = arms[i].total_reward / (double)arms[i].iterations;
+			const double score = mean_reward + std::sqrt(2 * std::log((double)total_iterations) / (double)arms[i].iterations);
+			if (i == 0 || score > best_score)
+			{
+				best_arm = i;
+				best_score = score;
+			}
+		}
+
+		return best_arm;
+	}
+
+	// The iterations without any scheduling step, such as ones that ended before the client program created an
+	// operation, do not shorten the learned schedule length.
+	void PortfolioStrategy::prepare_next_iteration()
+	{
+		Arm& last_arm = arms[current_arm];
+		last_arm.iterations += 1;
+		last_arm.total_reward += iteration_reward();
+
+		if (scheduled_steps > 0)
+		{
+			scheduled_iterations += 1;
+			mean_schedule_length += ((double)scheduled_steps - mean_schedule_length) / (double)scheduled_iterations;
+		}
+
+		scheduled_steps = 0;
+		new_state_count = 0;
+		known_state_count = 0;
+		is_bug_found = false;
+
+		current_arm = select_arm();
+		Arm& next_arm = arms[current_arm];
+		if (next_arm.strategy.get() == fair_pct && scheduled_iterations > 0)
+		{
+			fair_pct->set_prefix_length((long long unsigned)std::ceil(mean_schedule_length));
+		}
+
+		// A strategy that did not run yet is already prepared for its first iteration.
+		if (next_arm.iterations > 0)
+		{
+			next_arm.strategy->prepare_next_iteration();
+		}
+
+#ifdef DEBUG_PORTFOLIO_STRATEGY
+		std::cout << "Portfolio: selected strategy " << current_arm << std::endl;
+#endif
+	}
+
+	size_t PortfolioStrategy::arm_iterations(size_t index) const
+	{
+		return arms[index].iterations;
+	}
+
+	std::string PortfolioStrategy::get_description()
+	{
+		std::string description = "Using Portfolio strategy that allocates iterations by their yield to:";
+		for (const Arm& arm : arms)
+		{
+			description += " " + arm.strategy->get_description();
+		}
+
+		return description + "\n";
+	}
+}
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <string>
+#include "test.h"
+
+using namespace coyote;
+
+// Number of calls that each measurement performs.
+constexpr size_t NUM_CALLS = 20000000;
+
+// Prevents the compiler from discarding the results of the measured calls.
+volatile size_t sink;
+
+// Prevents the compiler from hoisting the measured calls out of the loop.
+Scheduler* volatile scheduler;
+
+template <typename F>
+void measure(const std::string& strategy_name, const std::string& call_name, F call)
+{
+	size_t total = 0;
+	auto start_time = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < NUM_CALLS; i++)
+	{
+		total += call(i);
+	}
+
+	auto end_time = std::chrono::steady_clock::now();
+	sink = total;
+
+	double nanoseconds = std::chrono::duration<double, std::nano>(end_time - start_time).count();
+	std::cout << "[benchmark] " << strategy_name << ", " << call_name << ": " << nanoseconds / NUM_CALLS <<
+		" ns/call." << std::endl;
+}
+
+void run(Scheduler* new_scheduler, const std::string& strategy_name)
+{
+	scheduler = new_scheduler;
+	scheduler->attach();
+	measure(strategy_name, "next_boolean", [](size_t) { return (size_t)scheduler->next_boolean(); });
+	measure(strategy_name, "next_integer", [](size_t i) { return (size_t)scheduler->next_integer((int)(i % 100) + 1); });
+	measure(strategy_name, "get_operation_id", [](size_t) { return scheduler->get_operation_id(); });
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	delete scheduler;
+}
+
+// Measures the cost of the nondeterministic choices and operation id queries that instrumented programs
+// issue on hot paths, such as on every allocation.
+int main()
+{
+	std::cout << "[benchmark] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		run(new Scheduler((size_t)42), "RandomStrategy");
+		run(new Scheduler("ProbabilisticRandomStrategy"), "ProbabilisticRandomStrategy");
+		run(new Scheduler("PCTStrategy"), "PCTStrategy");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[benchmark] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[benchmark] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <condition_variable>
+#include <thread>
+#include "test.h"
+#include "coyote/handoff/fiber_handoff.h"
+#include "coyote/runners/fork_server.h"
+
+using namespace coyote;
+
+constexpr auto WORK_FIBER_1_ID = 1;
+constexpr auto WORK_FIBER_2_ID = 2;
+constexpr auto NUM_ITERATIONS = 50;
+constexpr auto FIRST_SEED = 1000;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+void work(void* /*arg*/)
+{
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + 1;
+}
+
+// Runs the prefix of an iteration up to the ready point, forks the children there, and runs the racy suffix
+// in each child and in the server.
+void run_iteration(ForkServer& server)
+{
+	scheduler = new Scheduler((size_t)42);
+	assert(scheduler->set_handoff_engine(std::make_unique<FiberHandoff>()), ErrorCode::Success);
+	assert(scheduler->attach(), ErrorCode::Success);
+	shared_var = 0;
+	scheduler->schedule_next();
+
+	assert(server.fork_children(), ErrorCode::Success);
+	if (server.is_child())
+	{
+		assert(scheduler->reseed(server.seed()), ErrorCode::Success);
+		assert(scheduler->seed() == server.seed(), "the child did not reseed its scheduler.");
+	}
+
+	assert(scheduler->create_operation(WORK_FIBER_1_ID, work, nullptr), ErrorCode::Success);
+	assert(scheduler->create_operation(WORK_FIBER_2_ID, work, nullptr), ErrorCode::Success);
+	scheduler->join_operation(WORK_FIBER_1_ID);
+	scheduler->join_operation(WORK_FIBER_2_ID);
+	assert(scheduler->detach(), ErrorCode::Success);
+	delete scheduler;
+
+	if (server.is_child())
+	{
+		server.exit_child(shared_var != 2);
+	}
+}
+
+void test_fork_children()
+{
+	ForkServer server(NUM_ITERATIONS, FIRST_SEED, false);
+	run_iteration(server);
+
+	assert(server.completed_iterations() + server.failed_iterations() == NUM_ITERATIONS,
+		"not every child reported its iteration.");
+	assert(server.bug_found(), "the children did not find the race.");
+	assert(server.completed_iterations() > 0, "the children explored the same suffix.");
+	assert(server.bug_seed() >= FIRST_SEED && server.bug_seed() < FIRST_SEED + NUM_ITERATIONS,
+		"the seed of the bug is not the seed of a child.");
+
+	// The seed of the buggy child reproduces the race from the same snapshot.
+	ForkServer replay_server(1, server.bug_seed(), false);
+	run_iteration(replay_server);
+	assert(replay_server.failed_iterations() == 1, "the seed of the bug did not reproduce the race.");
+}
+
+void test_stop_on_first_bug()
+{
+	ForkServer server(NUM_ITERATIONS, FIRST_SEED, true);
+	run_iteration(server);
+
+	assert(server.failed_iterations() == 1, "the server did not stop at the first bug.");
+	assert(server.completed_iterations() == server.bug_seed() - FIRST_SEED, "the server ran past the first bug.");
+}
+
+void test_multiple_threads()
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool is_done = false;
+	std::thread thread([&]() {
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&]() { return is_done; });
+	});
+
+	ForkServer server(NUM_ITERATIONS, FIRST_SEED, false);
+	assert(server.fork_children(), ErrorCode::NotSupported);
+	assert(!server.is_child(), "forked a process that runs more than one thread.");
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		is_done = true;
+	}
+
+	cv.notify_one();
+	thread.join();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_fork_children();
+		test_stop_on_first_bug();
+		test_multiple_threads();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
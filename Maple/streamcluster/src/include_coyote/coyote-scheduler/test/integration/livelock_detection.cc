@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+// Maximum number of scheduling steps without progress.
+constexpr size_t LIVELOCK_BOUND = 100;
+
+// Number of steps that the progressing operation takes, which is larger than the bound.
+constexpr size_t NUM_PROGRESS_STEPS = 10 * LIVELOCK_BOUND;
+
+Scheduler* scheduler;
+
+bool is_flag_set;
+size_t spin_step_count;
+ErrorCode spin_error_code;
+
+// Spins until the flag is set, which never happens, or until the scheduler reports a livelock.
+void spin()
+{
+	scheduler->start_operation(WORK_THREAD_1_ID);
+
+	spin_step_count = 0;
+	spin_error_code = ErrorCode::Success;
+	while (!is_flag_set)
+	{
+		spin_error_code = scheduler->schedule_next();
+		if (spin_error_code != ErrorCode::Success)
+		{
+			break;
+		}
+
+		spin_step_count++;
+	}
+
+	scheduler->complete_operation(WORK_THREAD_1_ID);
+}
+
+// Takes more steps than the bound, but signals progress on each of them.
+void progress(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	for (size_t i = 0; i < NUM_PROGRESS_STEPS; i++)
+	{
+		scheduler->signal_progress();
+		assert(scheduler->schedule_next(), ErrorCode::Success);
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+void run_livelocked_iteration()
+{
+	is_flag_set = false;
+
+	scheduler->attach();
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(spin);
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	t1.join();
+	scheduler->detach();
+
+	assert(spin_error_code, ErrorCode::LivelockDetected);
+	assert(scheduler->error_code(), ErrorCode::LivelockDetected);
+	assert(spin_step_count < LIVELOCK_BOUND, "livelock was reported after the bound.");
+	assert(spin_step_count > LIVELOCK_BOUND / 2, "livelock was reported too early.");
+}
+
+void run_progressing_iteration()
+{
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(progress, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(progress, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test(Scheduler* new_scheduler, bool is_elision_enabled)
+{
+	scheduler = new_scheduler;
+	assert(scheduler->set_livelock_bound(LIVELOCK_BOUND), ErrorCode::Success);
+	assert(scheduler->set_scheduling_elision(is_elision_enabled), ErrorCode::Success);
+
+	for (int i = 0; i < 10; i++)
+	{
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+		run_livelocked_iteration();
+		run_progressing_iteration();
+	}
+
+	scheduler->attach();
+	assert(scheduler->set_livelock_bound(0), ErrorCode::ClientAttached);
+	scheduler->detach();
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test(new Scheduler((size_t)42), false);
+		test(new Scheduler((size_t)42), true);
+		test(new Scheduler("ProbabilisticRandomStrategy"), true);
+		test(new Scheduler("PCTStrategy"), false);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
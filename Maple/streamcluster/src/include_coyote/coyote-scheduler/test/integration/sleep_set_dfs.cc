@@ -0,0 +1,186 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 2;
+constexpr auto MAX_ITERATIONS = 1000;
+
+Scheduler* scheduler;
+
+// The counters of the operations, which they either increment separately or share.
+int counters[2];
+
+bool is_counter_shared;
+
+// The scheduling decisions of the current iteration.
+std::string schedule;
+
+// Records the decisions of a DFS strategy, which only repeats a schedule once it has explored every schedule.
+template <typename StrategyT>
+class RecordingStrategy : public StrategyT
+{
+public:
+	size_t next_operation(Operations& operations) override
+	{
+		const size_t operation_id = StrategyT::next_operation(operations);
+		schedule += std::to_string(operation_id);
+		return operation_id;
+	}
+};
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	int* counter = is_counter_shared ? &counters[0] : &counters[id - 1];
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		scheduler->schedule_next((size_t)counter, false);
+		int value = *counter;
+		scheduler->schedule_next((size_t)counter, true);
+		*counter = value + 1;
+	}
+
+	scheduler->complete_operation(id);
+}
+
+// Runs an iteration, and returns true if no increment was lost.
+bool run_iteration()
+{
+	counters[0] = 0;
+	counters[1] = 0;
+	schedule.clear();
+
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return counters[0] + counters[1] == 2 * NUM_STEPS;
+}
+
+// Runs the strategy until it starts over with the first schedule, and returns the number of explored
+// schedules. Counts the schedules that lost an increment in 'bug_count'.
+template <typename StrategyT>
+size_t explore(bool is_shared, size_t& bug_count, bool is_elision_enabled = false)
+{
+	is_counter_shared = is_shared;
+	scheduler = new Scheduler(std::make_unique<RecordingStrategy<StrategyT>>());
+	assert(scheduler->set_scheduling_elision(is_elision_enabled), ErrorCode::Success);
+
+	bug_count = run_iteration() ? 0 : 1;
+	const std::string first_schedule = schedule;
+
+	size_t iterations = 1;
+	while (iterations < MAX_ITERATIONS)
+	{
+		const bool is_correct = run_iteration();
+		if (schedule == first_schedule)
+		{
+			break;
+		}
+
+		bug_count += is_correct ? 0 : 1;
+		iterations++;
+	}
+
+	assert(iterations < MAX_ITERATIONS, "the strategy did not start over.");
+	delete scheduler;
+	return iterations;
+}
+
+void test_independent_accesses()
+{
+	size_t bug_count = 0;
+	const size_t iterations = explore<DFSStrategy>(false, bug_count);
+	const size_t reduced_iterations = explore<SleepSetDFSStrategy>(false, bug_count);
+	std::cout << "[test] explored " << iterations << " schedules, and " << reduced_iterations <<
+		" schedules with sleep sets." << std::endl;
+	assert(reduced_iterations * 4 < iterations, "sleep sets did not skip the independent interleavings.");
+	assert(bug_count == 0, "separate counters lost an increment.");
+}
+
+void test_dependent_accesses()
+{
+	size_t bug_count = 0;
+	const size_t iterations = explore<DFSStrategy>(true, bug_count);
+	assert(bug_count > 0, "DFS did not find the lost increment.");
+
+	const size_t reduced_iterations = explore<SleepSetDFSStrategy>(true, bug_count);
+	assert(bug_count > 0, "sleep sets skipped the lost increment.");
+	assert(reduced_iterations < iterations, "sleep sets did not skip the interleavings of the reads.");
+}
+
+// With elision, the operation that runs alone after the other completed skips its declared scheduling
+// points, so the strategy must not treat its step as only its first declared access.
+void test_elided_accesses()
+{
+	size_t bug_count = 0;
+	const size_t iterations = explore<DFSStrategy>(true, bug_count, true);
+	assert(bug_count > 0, "DFS did not find the lost increment with elision.");
+
+	const size_t reduced_iterations = explore<SleepSetDFSStrategy>(true, bug_count, true);
+	assert(bug_count > 0, "sleep sets skipped the lost increment with elision.");
+	assert(reduced_iterations <= iterations, "sleep sets explored more interleavings than DFS with elision.");
+
+	explore<SleepSetDFSStrategy>(false, bug_count, true);
+	assert(bug_count == 0, "separate counters lost an increment with elision.");
+}
+
+// Asks for an integer out of the largest range and out of an empty one, and checks that the strategy explores
+// only the lowest values of the first, in order, and then starts over.
+void test_integer_ranges()
+{
+	constexpr auto MAX_INTEGER_CHOICES = 3;
+	scheduler = new Scheduler(std::make_unique<SleepSetDFSStrategy>((size_t)MAX_INTEGER_CHOICES));
+
+	std::string trace;
+	for (int i = 0; i <= MAX_INTEGER_CHOICES; i++)
+	{
+		scheduler->attach();
+		trace += std::to_string(scheduler->next_integer(2147483647));
+		trace += std::to_string(scheduler->next_integer(0));
+		scheduler->detach();
+		assert(scheduler->error_code(), ErrorCode::Success);
+	}
+
+	delete scheduler;
+	assert(trace == "00102000", "the strategy did not bound the explored integer values.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_independent_accesses();
+		test_dependent_accesses();
+		test_elided_accesses();
+		test_integer_ranges();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
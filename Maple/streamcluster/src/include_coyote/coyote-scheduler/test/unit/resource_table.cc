@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <vector>
+#include "test.h"
+#include "coyote/resources/resource_table.h"
+
+using namespace coyote;
+
+std::vector<size_t> to_vector(const ResourceWaiters& waiters)
+{
+	return std::vector<size_t>(waiters.begin(), waiters.end());
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		Arena arena(1024);
+		ResourceTable table(arena);
+
+		// Resource ids that look like addresses of lock objects.
+		const size_t base_id = 0x7ffd0000;
+		for (size_t i = 0; i < 100; i++)
+		{
+			table.insert(base_id + i * 64);
+		}
+
+		assert(table.size() == 100, "unexpected size [0]");
+		assert(table.at(base_id + 99 * 64).size() == 0, "unexpected waiters [0]");
+
+		ErrorCode error_code = ErrorCode::Success;
+		try
+		{
+			table.insert(base_id);
+		}
+		catch (ErrorCode code)
+		{
+			error_code = code;
+		}
+
+		assert(error_code, ErrorCode::DuplicateResource);
+
+		error_code = ErrorCode::Success;
+		try
+		{
+			table.at(base_id + 1);
+		}
+		catch (ErrorCode code)
+		{
+			error_code = code;
+		}
+
+		assert(error_code, ErrorCode::NotExistingResource);
+
+		// Waiters are kept in the order in which they started waiting, without duplicates, both inline
+		// and after spilling into the arena.
+		for (size_t i = 0; i < 10; i++)
+		{
+			table.add_waiter(base_id, 10 - i);
+			table.add_waiter(base_id, 10 - i);
+		}
+
+		assert(to_vector(table.at(base_id)) == std::vector<size_t>({ 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 }),
+			"unexpected waiters [1]");
+		assert(table.at(base_id).erase(7), "failed to erase waiter [1]");
+		assert(!table.at(base_id).erase(7), "erased missing waiter [1]");
+		assert(to_vector(table.at(base_id)) == std::vector<size_t>({ 10, 9, 8, 6, 5, 4, 3, 2, 1 }),
+			"unexpected waiters after erase [1]");
+
+		// Erasing resources keeps the rest of the probe sequences reachable.
+		for (size_t i = 0; i < 100; i += 2)
+		{
+			table.erase(base_id + i * 64);
+		}
+
+		assert(table.size() == 50, "unexpected size after erase [2]");
+		for (size_t i = 1; i < 100; i += 2)
+		{
+			table.add_waiter(base_id + i * 64, i);
+			assert(to_vector(table.at(base_id + i * 64)) == std::vector<size_t>({ i }), "unexpected waiters [2]");
+		}
+
+		// Clearing empties the table at once, and resources can be created again in the next iteration.
+		table.clear();
+		arena.reset();
+		assert(table.size() == 0, "unexpected size after clear [3]");
+		table.insert(base_id + 64);
+		assert(table.at(base_id + 64).size() == 0, "waiters survived clear [3]");
+
+		error_code = ErrorCode::Success;
+		try
+		{
+			table.erase(base_id + 3 * 64);
+		}
+		catch (ErrorCode code)
+		{
+			error_code = code;
+		}
+
+		assert(error_code, ErrorCode::NotExistingResource);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
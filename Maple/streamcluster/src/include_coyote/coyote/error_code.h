@@ -13,6 +13,9 @@ namespace coyote
         Success = 0,
         Failure = 100,
         DeadlockDetected = 101,
+        NotSupported = 102,
+        LivelockDetected = 103,
+        ReplayDiverged = 104,
         DuplicateOperation = 200,
         NotExistingOperation = 201,
         MainOperationExplicitlyCreated = 202,
@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PARALLEL_RUNNER_H
+#define COYOTE_PARALLEL_RUNNER_H
+
+#if !defined(_WIN32)
+
+#include <cstddef>
+#include <functional>
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Handle through which the code running in a worker process of a 'ParallelRunner' reports the
+	// testing iterations that it executes.
+	class ParallelWorker
+	{
+	private:
+		// Write end of the pipe to the runner.
+		const int pipe_fd;
+
+		// Number of iterations that this worker has started.
+		size_t started_iteration_count;
+
+	public:
+		// The index of this worker.
+		const size_t index;
+
+		// The seed of the first iteration assigned to this worker. The iterations of the worker use
+		// consecutive seeds, which is how the random strategy seeds each new iteration.
+		const size_t first_seed;
+
+		// The number of iterations assigned to this worker.
+		const size_t num_iterations;
+
+		ParallelWorker(size_t index, size_t first_seed, size_t num_iterations, int pipe_fd) noexcept;
+
+		ParallelWorker(ParallelWorker&& worker) = delete;
+		ParallelWorker(ParallelWorker const&) = delete;
+
+		ParallelWorker& operator=(ParallelWorker&& worker) = delete;
+		ParallelWorker& operator=(ParallelWorker const&) = delete;
+
+		// Reports that the next iteration is starting, and returns its seed. If the worker process
+		// exits abnormally before the iteration completes, the runner reports this seed as buggy.
+		size_t start_iteration() noexcept;
+
+		// Reports that the current iteration has completed, and whether it found a bug.
+		void complete_iteration(bool bug_found) noexcept;
+
+	private:
+		void send(size_t kind, size_t seed) noexcept;
+	};
+
+	// Splits a budget of testing iterations across forked worker processes with disjoint seed ranges,
+	// and stops all workers as soon as one of them finds a bug. The runner must be used from a process
+	// that has not yet started any other threads.
+	class ParallelRunner
+	{
+	private:
+		// The number of worker processes.
+		const size_t num_workers;
+
+		// The total number of iterations across all workers.
+		const size_t num_iterations;
+
+		// The seed of the first iteration of the first worker.
+		const size_t seed;
+
+		// The number of iterations that completed without finding a bug.
+		size_t completed_iteration_count;
+
+		// True if a worker found a bug, else false.
+		bool is_bug_found;
+
+		// The seed of the first iteration that found a bug.
+		size_t first_bug_seed;
+
+	public:
+		ParallelRunner(size_t num_workers, size_t num_iterations, size_t seed) noexcept;
+
+		ParallelRunner(ParallelRunner&& runner) = delete;
+		ParallelRunner(ParallelRunner const&) = delete;
+
+		ParallelRunner& operator=(ParallelRunner&& runner) = delete;
+		ParallelRunner& operator=(ParallelRunner const&) = delete;
+
+		// Forks the worker processes, runs the specified function in each of them, and waits until all
+		// workers exit. The function runs the iterations assigned to the worker it receives.
+		ErrorCode run(std::function<void(ParallelWorker&)> worker_main) noexcept;
+
+		// Returns true if a worker found a bug, else false.
+		bool bug_found() noexcept;
+
+		// Returns the seed of the iteration that found the reported bug.
+		size_t bug_seed() noexcept;
+
+		// Returns the number of iterations that completed without finding a bug.
+		size_t completed_iterations() noexcept;
+	};
+}
+
+#endif // !_WIN32
+
+#endif // COYOTE_PARALLEL_RUNNER_H
@@ -4,45 +4,68 @@
 #ifndef COYOTE_SCHEDULER_H
 #define COYOTE_SCHEDULER_H
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
-#include <map>
+#include <limits>
 #include <memory>
 #include <unordered_set>
+#ifdef COYOTE_DEBUG_LOG
+#include <iostream>
+#endif // COYOTE_DEBUG_LOG
 #include "error_code.h"
+#include "handoff/handoff_engine.h"
+#include "memory/arena.h"
+#include "metrics/scheduler_metrics.h"
 #include "operations/operation.h"
+#include "operations/operation_table.h"
 #include "operations/operations.h"
+#include "resources/resource_table.h"
 #include "strategies/Probabilistic/random_strategy.h"
 #include "strategies/Exhaustive/dfs_strategy.h"
+#include "strategies/replay_strategy.h"
 #include "strategies/strategy.h"
 #include "strategies/testing_strategy.h"
+#include "trace/trace_recorder.h"
 
 namespace coyote
 {
-	class Scheduler
+	// Controls the execution of the client program, and explores its interleavings with a strategy of type
+	// 'StrategyT'. The strategy is called directly, so picking a concrete strategy at compile time removes
+	// the virtual dispatch from every scheduling decision. The library instantiates this template for
+	// 'TestingStrategy' and for each of the strategies it wraps.
+	template <typename StrategyT>
+	class BasicScheduler
 	{
 	private:
 		// Strategy for exploring the execution of the client program.
-		std::unique_ptr<TestingStrategy> strategy;
+		std::unique_ptr<StrategyT> strategy;
 
 		// The testing strategy to use.
 		std::string scheduling_strategy;
 
-		// The seed used by random strategy. By default '0' for other strategy.
-		size_t random_seed = 0;
-
-		// Map from unique operation ids to operations.
-		std::map<size_t, std::unique_ptr<Operation>> operation_map;
+		// Table of the operations of the current iteration, addressed by compact slot indices.
+		OperationTable operation_table;
 
 		// Vector of enabled and disabled operation ids.
 		Operations operations;
 
-		// Map from unique resource ids to blocked operation ids.
-		std::map<size_t, std::shared_ptr<std::unordered_set<size_t>>> resource_map;
+		// Arena that holds the bookkeeping of the current iteration. It is reset on each detach.
+		Arena arena;
+
+		// Table from unique resource ids to the slot indices of blocked operations. Waiter lists that
+		// outgrow their bucket live in the arena.
+		ResourceTable resource_table;
+
+		// Slot indices of the operations joined by the current 'join_operations' call, reused across calls.
+		std::vector<size_t> join_operation_indices;
 
 		// Mutex that synchronizes access to the scheduler.
 		std::unique_ptr<std::mutex> mutex;
 
+		// Engine that parks and resumes the threads of controlled operations.
+		std::unique_ptr<HandoffEngine> handoff_engine;
+
 		// Conditional variable that can be used to block scheduling a next operation until all pending
 		// operations have started.
 		std::condition_variable pending_operations_cv;
@@ -50,6 +73,9 @@ namespace coyote
 		// The id of the currently scheduled operation.
 		size_t scheduled_operation_id;
 
+		// The slot index of the currently scheduled operation.
+		size_t scheduled_operation_index;
+
 		// Count of newly created operations that have not started yet.
 		size_t pending_start_operation_count;
 
@@ -65,11 +91,44 @@ namespace coyote
 		// The last assigned error code, else success.
 		ErrorCode last_error_code;
 
+		// True if scheduling points where a single operation is enabled return without consulting the
+		// strategy, else false.
+		bool is_elision_enabled;
+
+		// True if the scheduled operation is the only enabled operation and no created operation is
+		// pending to start, so that its next scheduling point can be elided. It is cleared under the
+		// lock whenever another operation might become enabled, and read by 'schedule_next' without it.
+		std::atomic<bool> is_scheduling_elidable;
+
+		// Count of scheduling points elided since the strategy was last consulted. Only the scheduled
+		// operation updates it while elision is possible.
+		size_t elided_step_count;
+
+		// Records the scheduling decisions of the current iteration, if a trace was requested.
+		std::unique_ptr<TraceRecorder> trace_recorder;
+
+		// Maximum number of scheduling steps that an iteration can take without signaling progress, or
+		// the maximum value of 'size_t' if livelock detection is disabled.
+		size_t livelock_bound;
+
+		// Collects the metrics of each iteration, if metrics were enabled.
+		std::unique_ptr<SchedulerMetrics> scheduler_metrics;
+
+		// Count of scheduling steps since the iteration started or last signaled progress, minus the elided
+		// steps that are not reported yet. Its sum with 'elided_step_count' is the number of steps taken
+		// without progress, and it wraps around if progress was signaled before the elided steps are reported.
+		size_t progress_step_count;
+
+		// Hashes of the program states reported across all iterations.
+		std::unordered_set<size_t> known_states;
+
+		// The access of the next step of the scheduled operation, if 'schedule_next' declared it. It is
+		// declared to the strategy, and cleared, on the next scheduling decision.
+		StepAccess next_access;
+
 	public:
-		Scheduler() noexcept;
-		Scheduler(size_t seed) noexcept;
-		Scheduler(std::string str) noexcept;
-		Scheduler(std::string str, long long unsigned llu) noexcept;
+		// Creates a scheduler that explores the client program with the specified strategy.
+		explicit BasicScheduler(std::unique_ptr<StrategyT> strategy) noexcept;
 
 		// Attaches to the scheduler. This should be called at the beginning of a testing iteration.
 		// It creates a main operation with id '0'.
@@ -82,6 +141,12 @@ namespace coyote
 		// Creates a new operation with the specified id.
 		ErrorCode create_operation(size_t operation_id) noexcept;
 
+		// Creates a new operation with the specified id that runs the specified function, and starts
+		// executing it. This requires a handoff engine that runs operations as fibers, such as
+		// 'FiberHandoff'. It returns once the new operation pauses for the first time, and the operation
+		// completes when the function returns.
+		ErrorCode create_operation(size_t operation_id, void (*func)(void*), void* arg) noexcept;
+
 		// Starts executing the operation with the specified id.
 		ErrorCode start_operation(size_t operation_id) noexcept;
 
@@ -116,31 +181,167 @@ namespace coyote
 		// Only operations that are not blocked nor completed can be scheduled.
 		ErrorCode schedule_next() noexcept;
 
-		// Returns a controlled nondeterministic boolean value.
-		bool next_boolean() noexcept;
-
-		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range.
-		int next_integer(int max_value) noexcept;
-
-		// Returns a seed that can be used to reproduce the current testing iteration.
+		// Schedules the next operation, like 'schedule_next', and declares that the next step of the current
+		// operation, up to its next scheduling point, only accesses the resource or memory location with the
+		// specified id, and only reads it unless 'is_write' is true. Strategies like 'SleepSetDFSStrategy'
+		// skip the interleavings that only reorder steps that access different locations, or that only read
+		// the same one. The step must not create, complete, join, wait or signal operations or resources,
+		// and steps after other scheduling points are assumed to access anything.
+		ErrorCode schedule_next(size_t location, bool is_write) noexcept;
+
+		// Signals that the client program made progress, which restarts the step budget of livelock detection.
+		// This should be called by the currently scheduled operation.
+		void signal_progress() noexcept
+		{
+			progress_step_count = 0 - elided_step_count;
+		}
+
+		// Reports the hash of the current program state, such as a hash of the data structures of the client
+		// program. The scheduler keeps the hashes that were reported across all iterations, and notifies the
+		// strategy when a state is reached again, so that strategies like 'DFSStrategy' can prune the schedules
+		// that continue from it. Pruning assumes that the hash identifies the state of every operation, so a
+		// coarser hash trades completeness for speed. This should be called by the currently scheduled operation.
+		ErrorCode report_state(size_t state_hash) noexcept;
+
+		// Reports that the last iteration found a bug, such as when the client program fails an assertion, so
+		// that strategies like 'PortfolioStrategy' can favor the strategies that find bugs. This can be called
+		// while the client program is attached, or after it detached and before it attaches again.
+		ErrorCode report_bug() noexcept;
+
+		// Returns the number of distinct program states that were reported across all iterations.
+		size_t distinct_state_count() const noexcept
+		{
+			return known_states.size();
+		}
+
+		// Returns a controlled nondeterministic boolean value. This and 'next_integer' are inline, as
+		// instrumented programs call them on hot paths, such as on every allocation.
+		bool next_boolean() noexcept
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::next_boolean] " << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			const bool value = strategy->StrategyT::next_boolean();
+			if (trace_recorder != nullptr)
+			{
+				trace_recorder->record(TraceDecision::Boolean, value);
+			}
+
+			return value;
+		}
+
+		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range. The bound
+		// is taken as a wide integer, so that clients can pass 'size_t' bounds, and bounds that do not fit in
+		// an 'int' are clamped to it, instead of wrapping to a negative bound that no strategy can choose from.
+		int next_integer(int64_t max_value) noexcept
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::next_integer] " << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			const int64_t max_int = std::numeric_limits<int>::max();
+			const int64_t min_int = std::numeric_limits<int>::min();
+			const int value = strategy->StrategyT::next_integer(static_cast<int>(
+				max_value > max_int ? max_int : max_value < min_int ? min_int : max_value));
+			if (trace_recorder != nullptr)
+			{
+				trace_recorder->record(TraceDecision::Integer, value);
+			}
+
+			return value;
+		}
+
+		// Returns a seed that can be used to reproduce the current testing iteration, or the last one if no
+		// client is attached. The seed is asked from the strategy, so strategies that are not seeded return '0'.
 		size_t seed() noexcept;
 
+		// Restarts the choices of the strategy from the specified seed in the middle of the current iteration,
+		// so that processes forked from a snapshot of the iteration explore different suffixes. Afterwards,
+		// 'seed()' returns the specified seed. Fails with 'ErrorCode::NotSupported' if the strategy is not seeded.
+		ErrorCode reseed(size_t seed) noexcept;
+
 		// Returns the last error code, if there is one assigned.
 		ErrorCode error_code() noexcept;
 
 		// Return id of the current operation
-		size_t get_operation_id() noexcept;
+		size_t get_operation_id() noexcept
+		{
+			return scheduled_operation_id;
+		}
+
+		// Replaces the engine that parks and resumes controlled operations. By default, the scheduler
+		// uses the 'ConditionVariableHandoff' engine. This can only be called while no client is attached.
+		ErrorCode set_handoff_engine(std::unique_ptr<HandoffEngine> engine) noexcept;
+
+		// Enables or disables eliding scheduling points while a single operation is enabled. With elision,
+		// 'schedule_next' returns immediately, without locking or asking the strategy, whenever the strategy
+		// could only pick the current operation. The elided steps are reported to the strategy in a batch
+		// before its next decision. Elision changes which random choices a seed maps to, so a seed must be
+		// replayed with the same setting. It is disabled by default, and can only be changed while no
+		// client is attached.
+		ErrorCode set_scheduling_elision(bool is_enabled) noexcept;
+
+		// Records the scheduling decisions of each iteration into a trace file at the specified path, which
+		// 'ReplayStrategy' can replay. The file holds the latest iteration, so after a failure or crash it
+		// holds the failing one. This can only be called while no client is attached.
+		ErrorCode record_trace(const std::string& path) noexcept;
+
+		// Bounds the number of scheduling steps that an iteration can take without calling 'signal_progress'.
+		// Once an iteration exceeds the bound, 'schedule_next' fails with 'ErrorCode::LivelockDetected', so
+		// that spinning operations can abort the iteration. Blocking calls count as steps, but only report the
+		// livelock at the next 'schedule_next'. A bound of '0' disables detection, which is the default. This
+		// can only be called while no client is attached.
+		ErrorCode set_livelock_bound(size_t max_steps) noexcept;
+
+		// Enables collecting metrics about each iteration, such as the number of scheduling decisions and
+		// context switches, and the time that operations spend paused. While disabled, which is the default,
+		// the scheduler only checks a pointer on its hot paths. This can only be called while no client is
+		// attached.
+		ErrorCode enable_metrics() noexcept;
+
+		// Returns the collected metrics, or 'nullptr' if metrics are disabled. The metrics should only be
+		// read while no client is attached.
+		const SchedulerMetrics* get_metrics() const noexcept
+		{
+			return scheduler_metrics.get();
+		}
+
+	protected:
+		BasicScheduler(std::unique_ptr<StrategyT> strategy, std::string strategy_name) noexcept;
 
 	private:
-		Scheduler(Scheduler&& op) = delete;
-		Scheduler(Scheduler const&) = delete;
+		BasicScheduler(BasicScheduler&& op) = delete;
+		BasicScheduler(BasicScheduler const&) = delete;
 
-		Scheduler& operator=(Scheduler&& op) = delete;
-		Scheduler& operator=(Scheduler const&) = delete;
+		BasicScheduler& operator=(BasicScheduler&& op) = delete;
+		BasicScheduler& operator=(BasicScheduler const&) = delete;
 
-		void create_operation_inner(size_t operation_id);
+		size_t create_operation_inner(size_t operation_id);
 		void start_operation_inner(size_t operation_id, std::unique_lock<std::mutex>& lock);
 		void schedule_next_inner(std::unique_lock<std::mutex>& lock);
+		ErrorCode schedule_next_slow(const StepAccess& access) noexcept;
+		void report_elided_steps();
+		void run_operation_body(size_t operation_id, void (*func)(void*), void* arg) noexcept;
+	};
+
+	extern template class BasicScheduler<TestingStrategy>;
+	extern template class BasicScheduler<RandomStrategy>;
+	extern template class BasicScheduler<ProbabilisticRandomStrategy>;
+	extern template class BasicScheduler<PCTStrategy>;
+	extern template class BasicScheduler<DFSStrategy>;
+	extern template class BasicScheduler<SleepSetDFSStrategy>;
+	extern template class BasicScheduler<ReplayStrategy>;
+
+	// The default scheduler, which selects its strategy at runtime by name.
+	class Scheduler final : public BasicScheduler<TestingStrategy>
+	{
+	public:
+		Scheduler() noexcept;
+		Scheduler(size_t seed) noexcept;
+		Scheduler(std::string str) noexcept;
+		Scheduler(std::string str, long long unsigned llu) noexcept;
+
+		// Creates a scheduler that explores the client program with the specified strategy.
+		explicit Scheduler(std::unique_ptr<Strategy> strategy) noexcept;
 	};
 }
 
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_BOUNDED_DFS_STRATEGY_H
+#define COYOTE_BOUNDED_DFS_STRATEGY_H
+
+#include "../strategy.h"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace coyote
+{
+	// Explores the schedules of the program in depth-first order, like 'DFSStrategy', but only the ones
+	// whose cost is within a bound, by iterative deepening. It first explores the schedules of cost 0, and
+	// raises the bound by one each time it has explored every schedule within the bound, so that the bugs
+	// that need few preemptions or delays are found after a small fraction of the schedules. Once a bound
+	// no longer skips any schedule, every schedule has been explored, and the strategy starts over from 0.
+	class BoundedDFSStrategy : public Strategy
+	{
+	public:
+		// The cost that the bound limits.
+		enum class BoundKind
+		{
+			// Switching away from the current operation while it is still enabled costs one preemption.
+			Preemption,
+
+			// Scheduling the operation that is 'k' places after the current one in round-robin order of ids
+			// costs 'k' delays, so that the schedule of cost 0 is the round-robin one.
+			Delay
+		};
+
+	private:
+		// A scheduling index of the current iteration. Its choices are explored in order of increasing cost.
+		struct Frame
+		{
+			// The number of choices within the bound.
+			size_t count;
+
+			// The index of the current choice.
+			size_t index;
+
+			// The offset of the choices in 'operation_choices' if they are operations, else 'SIZE_MAX', since
+			// the value choices are the values below 'count'.
+			size_t offset;
+
+			// The cost of the schedule before this scheduling index.
+			size_t cost;
+		};
+
+		// The cost that the bound limits.
+		const BoundKind bound_kind;
+
+		// The maximum cost of the explored schedules.
+		size_t cost_bound;
+
+		// True if the current bound skipped a choice, so that raising it explores more schedules, else false.
+		bool is_bound_reached;
+
+		// The scheduling indices of the current iteration, which the next iteration replays up to the last
+		// index that has choices left to explore.
+		std::vector<Frame> frames;
+
+		// The choices of the operation choices of 'frames', stored contiguously in order.
+		std::vector<size_t> operation_choices;
+
+		// The costs of the choices in 'operation_choices'.
+		std::vector<size_t> operation_costs;
+
+		// The enabled operations of a new scheduling index that are within the bound, with their cost.
+		std::vector<std::pair<size_t, size_t>> candidates;
+
+		// Current scheduling index (next sch point)
+		size_t SchIndex;
+
+		// The operation that the current iteration scheduled last, starting with the main operation.
+		size_t current_operation_id;
+
+		// The cost of the current iteration so far.
+		size_t current_cost;
+
+		// Returns the next value choice out of the values below 'count'.
+		size_t next_value(size_t count);
+
+	public:
+		explicit BoundedDFSStrategy(BoundKind bound_kind) noexcept;
+
+		BoundedDFSStrategy(BoundedDFSStrategy&& strategy) = delete;
+		BoundedDFSStrategy(BoundedDFSStrategy const&) = delete;
+
+		BoundedDFSStrategy& operator=(BoundedDFSStrategy&& strategy) = delete;
+		BoundedDFSStrategy& operator=(BoundedDFSStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations);
+
+		// Returns the next boolean choice.
+		bool next_boolean();
+
+		// Returns the next integer choice, out of at most 64 values like 'DFSStrategy'.
+		int next_integer(int max_value);
+
+		// Prepares the next iteration, and raises the bound if the current one is exhausted.
+		void prepare_next_iteration();
+
+		// Returns the bound of the current iteration.
+		size_t bound() const;
+
+		// Description about the strategy
+		std::string get_description();
+
+		// Fair strategy or not
+		bool is_fair();
+
+		// seed
+		size_t seed();
+	};
+}
+
+#endif // COYOTE_BOUNDED_DFS_STRATEGY_H
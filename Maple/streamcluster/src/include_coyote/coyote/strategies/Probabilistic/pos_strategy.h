@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_POS_STRATEGY_H
+#define COYOTE_POS_STRATEGY_H
+
+#include "../random.h"
+#include "../strategy.h"
+#include "../../memory/arena.h"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace coyote
+{
+	// Partial order sampling: gives the pending step of each operation a random priority, and schedules
+	// the enabled operation whose step has the highest priority. Once a step is scheduled, only the pending
+	// steps that race with it, because they access the same resource or memory location and one of them
+	// writes it, get a new random priority, and the next step of the scheduled operation gets one too. The
+	// other steps keep their priority, so each partial order of the racing steps is sampled with a fairer
+	// probability than by a random walk. A step that did not declare its access with 'schedule_next' races
+	// with every step, so without declarations the strategy samples like a random walk.
+	class POSStrategy : public Strategy
+	{
+	private:
+		typedef std::unordered_map<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+			ArenaAllocator<std::pair<const size_t, size_t>>> SlotMap;
+
+		// The pending step of an operation.
+		struct PendingStep
+		{
+			// The priority of the step. A higher value is a higher priority.
+			uint64_t priority;
+
+			// The access of the step.
+			StepAccess access;
+		};
+
+		// The pseudo-random generator.
+		Random generator;
+
+		// The seed used by the current iteration.
+		size_t iteration_seed;
+
+		// Arena that holds the slot map. It is reset on each iteration.
+		Arena arena;
+
+		// Map from the ids of the operations of the current iteration to their slots in 'pending_steps', or
+		// null until the first operation of the iteration.
+		SlotMap* operation_slots;
+
+		// The pending step of each operation slot.
+		std::vector<PendingStep> pending_steps;
+
+		// Returns the pending step of the operation with the specified id, and assigns a random priority to
+		// the first step of operations that are new in this iteration.
+		PendingStep& pending_step(size_t operation_id);
+
+	public:
+		POSStrategy(size_t seed) noexcept;
+
+		POSStrategy(POSStrategy&& strategy) = delete;
+		POSStrategy(POSStrategy const&) = delete;
+
+		POSStrategy& operator=(POSStrategy&& strategy) = delete;
+		POSStrategy& operator=(POSStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations);
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return generator.next() & 1;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
+
+		// Records the access of the pending step of an operation.
+		void declare_access(size_t operation_id, const StepAccess& access);
+
+		// Accounts for scheduling points that the scheduler elided while the operation ran alone.
+		void skip_steps(size_t operation_id, size_t count);
+
+		// Returns the seed used in the current iteration.
+		size_t seed();
+
+		// Restarts the choices of the current iteration from the specified seed.
+		bool reseed(size_t seed);
+
+		// Prepares the next iteration.
+		void prepare_next_iteration();
+
+		// Description about the strategy
+		std::string get_description();
+
+		// Fair strategy or not
+		bool is_fair();
+	};
+}
+
+#endif // COYOTE_POS_STRATEGY_H
@@ -11,10 +11,14 @@
 
 //#define COYOTE_DEBUG_LOG 1
 #include "test.h"
+#include "coyote/runners/parallel_runner.h"
+#include "coyote/runners/test_campaign.h"
 #include <cassert>
 #include <climits>
 #include <errno.h>
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 
 // Require C++11 or above
 #include <unordered_map>
@@ -24,6 +28,9 @@ typedef unsigned long long llu;
 
 Scheduler* scheduler = NULL;
 
+// Handle for reporting iterations, if this process is a worker forked by FFI_run_parallel.
+coyote::ParallelWorker* parallel_worker = NULL;
+
 // Use this flag to kepp a track of all heap allocations and get rid of heap memory leaks.
 #define INTERCEPT_HEAP_ALLOCATORS
 
@@ -145,13 +152,73 @@ std::vector<void *>* lazy_cond_init_list = NULL;
 enum program_state{STATE_READ, STATE_WRITE, STATE_INIT};
 enum program_state curr_state = STATE_INIT;
 
-// Number of 'attempted' context switches in one program state
-llu num_cxt_switch = 0;
+/******************************************** CoyoteLock End ******************************************/
 
-// Maximum number of context switches that can happen *without* changing the program state
-#define MAX_NUM_CXT_SWITCH 2000000
+/*********************************************** Metrics ***********************************************/
 
-/******************************************** CoyoteLock End ******************************************/
+// Writes the metrics of the scheduler to the specified path, as JSON if the path ends with '.json', else as CSV.
+static void dump_scheduler_metrics(Scheduler* scheduler, const char* path){
+
+	const coyote::SchedulerMetrics* metrics = scheduler->get_metrics();
+	assert(metrics != NULL && "Metrics are disabled. Call FFI_enable_metrics first.");
+
+	std::ofstream stream(path);
+	const size_t length = strlen(path);
+	if(length >= 5 && strcmp(path + length - 5, ".json") == 0){
+		metrics->write_json(stream);
+	} else {
+		metrics->write_csv(stream);
+	}
+
+	assert(stream && "FFI_dump_metrics: failed to write the metrics");
+}
+
+// Returns the value of the metric with the specified name, or 0 if there is no such metric.
+static llu scheduler_metric(Scheduler* scheduler, const char* name, bool is_total){
+
+	const coyote::SchedulerMetrics* metrics = scheduler->get_metrics();
+	assert(metrics != NULL && "Metrics are disabled. Call FFI_enable_metrics first.");
+
+	for(int i = 0; i < (int)coyote::Metric::Count; i++){
+		coyote::Metric metric = (coyote::Metric)i;
+		if(coyote::metric_name(metric) == name){
+			return is_total ? metrics->total()[metric] : metrics->last_iteration()[metric];
+		}
+	}
+
+	return 0;
+}
+
+// Runs a test campaign on the scheduler and prints its throughput and the seeds of the buggy iterations.
+static int run_scheduler_campaign(Scheduler* scheduler, size_t max_iterations, size_t time_budget_ms,
+	bool stop_on_first_bug, bool (*iteration)(void), size_t* bug_seed){
+
+	coyote::TestCampaign campaign(*scheduler, max_iterations, std::chrono::milliseconds(time_budget_ms),
+		stop_on_first_bug);
+	while(campaign.next_iteration()){
+		campaign.complete_iteration(iteration());
+	}
+
+	printf("Completed %lu iterations in %.3f seconds (%.1f iterations/second)\n", campaign.completed_iterations(),
+		campaign.elapsed_seconds(), campaign.iterations_per_second());
+	if(!campaign.bug_found()){
+		return 0;
+	}
+
+	const coyote::CampaignBug& first_bug = campaign.found_bugs().front();
+	printf("Found the first bug after %.3f seconds in iteration %lu with seed: %lu\n",
+		campaign.time_to_first_bug_seconds(), first_bug.iteration, first_bug.seed);
+	for(size_t i = 1; i < campaign.found_bugs().size(); i++){
+		printf("Found a bug in iteration %lu with seed: %lu\n", campaign.found_bugs()[i].iteration,
+			campaign.found_bugs()[i].seed);
+	}
+
+	if(bug_seed != NULL){
+		*bug_seed = first_bug.seed;
+	}
+
+	return 1;
+}
 
 /* Since these functions will be called from a C code, we
 * need to specifiy this to our C++ compiler (g++) so that it accordingly
@@ -188,6 +255,36 @@ void FFI_create_scheduler_w_seed(size_t seed){
 	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
+// Create scheduler that replays the trace file written by FFI_record_trace
+void FFI_create_scheduler_replay(const char* path){
+
+	if(scheduler != NULL){
+		return;
+	}
+
+	std::unique_ptr<coyote::Strategy> strategy;
+	try{
+		strategy.reset(new coyote::ReplayStrategy(path));
+	}
+	catch(...){
+		assert(false && "FFI_create_scheduler_replay: could not read the trace file");
+	}
+
+	scheduler = new coyote::Scheduler(std::move(strategy));
+	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
+// Create scheduler with the POS strategy and the seed
+void FFI_create_scheduler_pos(size_t seed){
+
+	if(scheduler != NULL){
+		return;
+	}
+
+	scheduler = new coyote::Scheduler(std::unique_ptr<coyote::Strategy>(new coyote::POSStrategy(seed)));
+	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
 #ifdef USING_PCT_BRANCH
 
 // Create scheduler with the random strategy
@@ -277,8 +374,115 @@ void FFI_create_scheduler_dfs(){
 	scheduler = new coyote::Scheduler(st);
 	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
+
+// Create scheduler with the preemption-bounded dfs strategy
+void FFI_create_scheduler_preemption_bounded(){
+
+	if(scheduler != NULL){
+		return;
+	}
+
+	std::string st = "PreemptionBoundedDFSStrategy";
+	scheduler = new coyote::Scheduler(st);
+	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
+// Create scheduler with the delay-bounded dfs strategy
+void FFI_create_scheduler_delay_bounded(){
+
+	if(scheduler != NULL){
+		return;
+	}
+
+	std::string st = "DelayBoundedDFSStrategy";
+	scheduler = new coyote::Scheduler(st);
+	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
 #endif
 
+// Lets scheduling points where a single operation is enabled return without consulting the strategy.
+// Call it after creating the scheduler and before the first attach.
+void FFI_enable_scheduling_elision(){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->set_scheduling_elision(true);
+	assert(e == coyote::ErrorCode::Success && "FFI_enable_scheduling_elision: failed");
+}
+
+// Records the scheduling decisions of the latest iteration into the trace file at the specified path.
+void FFI_record_trace(const char* path){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->record_trace(path);
+	assert(e == coyote::ErrorCode::Success && "FFI_record_trace: failed");
+}
+
+// Fails the iteration once it takes more than the specified number of scheduling steps without progress.
+void FFI_set_livelock_bound(size_t max_steps){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->set_livelock_bound(max_steps);
+	assert(e == coyote::ErrorCode::Success && "FFI_set_livelock_bound: failed");
+}
+
+void FFI_signal_progress(){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	scheduler->signal_progress();
+}
+
+// Reports the hash of the current program state, so that strategies can prune schedules that reach known states.
+void FFI_report_state(size_t state_hash){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->report_state(state_hash);
+	assert(e == coyote::ErrorCode::Success && "FFI_report_state: failed");
+}
+
+// Reports that the last iteration found a bug, so that the portfolio strategy favors the strategy that found it.
+void FFI_report_bug(){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->report_bug();
+	assert(e == coyote::ErrorCode::Success && "FFI_report_bug: failed");
+}
+
+size_t FFI_distinct_state_count(){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return scheduler->distinct_state_count();
+}
+
+// Collects metrics about each iteration, such as scheduling decisions and context switches.
+void FFI_enable_metrics(){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->enable_metrics();
+	assert(e == coyote::ErrorCode::Success && "FFI_enable_metrics: failed");
+}
+
+llu FFI_metric(const char* name, bool is_total){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return scheduler_metric(scheduler, name, is_total);
+}
+
+void FFI_dump_metrics(const char* path){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	dump_scheduler_metrics(scheduler, path);
+}
+
 void FFI_delete_scheduler(){
 
 	if(lazy_mutex_init_list != NULL){
@@ -310,6 +514,10 @@ void FFI_attach_scheduler(){
 
 	ErrorCode e = scheduler->attach();
 	assert(e == coyote::ErrorCode::Success && "FFI_attach_scheduler: attach failed");
+
+	if(parallel_worker != NULL){
+		parallel_worker->start_iteration();
+	}
 }
 
 void FFI_detach_scheduler(){
@@ -338,9 +546,46 @@ void FFI_detach_scheduler(){
 	//clean_coyote_ops_hash_map();
 
 	ErrorCode e = scheduler->detach();
+	if(parallel_worker != NULL){
+		parallel_worker->complete_iteration(e != coyote::ErrorCode::Success);
+	}
+
 	assert(e == coyote::ErrorCode::Success && "FFI_detach_scheduler: detach failed");
 }
 
+int FFI_run_parallel(size_t num_workers, size_t num_iterations, size_t seed,
+	void (*worker_main)(size_t first_seed, size_t num_iterations), size_t* bug_seed){
+
+	assert(scheduler == NULL && "FFI_run_parallel: each worker must create its own scheduler");
+
+	coyote::ParallelRunner runner(num_workers, num_iterations, seed);
+	ErrorCode e = runner.run([worker_main](coyote::ParallelWorker& worker){
+		parallel_worker = &worker;
+		worker_main(worker.first_seed, worker.num_iterations);
+		parallel_worker = NULL;
+	});
+	assert(e == coyote::ErrorCode::Success && "FFI_run_parallel: failed to run the workers");
+
+	printf("Completed %lu iterations across %lu workers\n", runner.completed_iterations(), num_workers);
+	if(!runner.bug_found()){
+		return 0;
+	}
+
+	if(bug_seed != NULL){
+		*bug_seed = runner.bug_seed();
+	}
+
+	return 1;
+}
+
+int FFI_run_campaign(size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug, bool (*iteration)(void),
+	size_t* bug_seed){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return run_scheduler_campaign(scheduler, max_iterations, time_budget_ms, stop_on_first_bug, iteration, bug_seed);
+}
+
 void FFI_scheduler_assert(){
 
 	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
@@ -442,13 +687,20 @@ void FFI_schedule_next(){
 
 	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
 
-	num_cxt_switch++;
-	//assert(num_cxt_switch < MAX_NUM_CXT_SWITCH && "Potential violation of the liveliness property.");
-
 	ErrorCode e = scheduler->schedule_next();
+	assert(e != coyote::ErrorCode::LivelockDetected && "Potential violation of the liveliness property.");
 	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next: failed");
 }
 
+void FFI_schedule_next_access(size_t location, bool is_write){
+
+	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = scheduler->schedule_next(location, is_write);
+	assert(e != coyote::ErrorCode::LivelockDetected && "Potential violation of the liveliness property.");
+	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next_access: failed");
+}
+
 bool FFI_next_boolean(){
 
 	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
@@ -461,9 +713,8 @@ size_t FFI_next_integer(size_t max_value){
 
 	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
 
-	//assert(0 && "Fix this!!");
-	return scheduler->next_integer((long unsigned)max_value);
-	//return 0;
+	// Bounds above INT_MAX, such as the 2147483648 that streamcluster passes, are clamped by the scheduler.
+	return scheduler->next_integer(max_value);
 }
 
 size_t FFI_seed(){
@@ -496,7 +747,7 @@ void FFI_set_state_read(){
 	if(curr_state == STATE_READ) return;
 
 	// There is a state change!
-	num_cxt_switch = 0;
+	FFI_signal_progress();
 	curr_state = STATE_READ;
 }
 
@@ -505,7 +756,7 @@ void FFI_set_state_write(){
 	if(curr_state == STATE_WRITE) return;
 
 	// There is a state change!
-	num_cxt_switch = 0;
+	FFI_signal_progress();
 	curr_state = STATE_WRITE;
 }
 
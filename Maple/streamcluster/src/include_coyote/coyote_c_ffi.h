@@ -27,6 +27,14 @@
 	#define FFI_create_scheduler_w_seed(x)
 #endif
 
+// FFI for creating a scheduler with the POS strategy and the seed. It samples the orders of the steps that
+// race on the locations declared with FFI_schedule_next_access more evenly than a random walk.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_pos(size_t seed);
+#else
+	#define FFI_create_scheduler_pos(x)
+#endif
+
 // FFI for Coyote create_scheduler("RandomStrategy") API call
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_create_scheduler_rand();
@@ -62,6 +70,109 @@
 	#define FFI_create_scheduler_dfs()
 #endif
 
+// FFI for Coyote create_scheduler("PreemptionBoundedDFSStrategy") API call. It explores the schedules with
+// at most 0 preemptions, then at most 1, and so on.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_preemption_bounded();
+#else
+	#define FFI_create_scheduler_preemption_bounded()
+#endif
+
+// FFI for Coyote create_scheduler("DelayBoundedDFSStrategy") API call. It explores the schedules with at
+// most 0 delays of the round-robin schedule, then at most 1, and so on.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_delay_bounded();
+#else
+	#define FFI_create_scheduler_delay_bounded()
+#endif
+
+// FFI for creating a scheduler that replays the trace file written by FFI_record_trace
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_replay(const char* path);
+#else
+	#define FFI_create_scheduler_replay(x)
+#endif
+
+// Lets scheduling points where a single operation is enabled return without consulting the strategy.
+// Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_scheduling_elision();
+#else
+	#define FFI_enable_scheduling_elision()
+#endif
+
+// Records the scheduling decisions of the latest iteration into the trace file at the specified path.
+// Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_record_trace(const char* path);
+#else
+	#define FFI_record_trace(x)
+#endif
+
+// Fails the iteration once it takes more than the specified number of scheduling steps without calling
+// FFI_signal_progress, which FFI_set_state_read and FFI_set_state_write do on each state change. A bound
+// of 0 disables the check. Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_set_livelock_bound(size_t max_steps);
+#else
+	#define FFI_set_livelock_bound(x)
+#endif
+
+// Signals that the program under test made progress, which restarts the step budget of FFI_set_livelock_bound.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_signal_progress();
+#else
+	#define FFI_signal_progress()
+#endif
+
+// Reports the hash of the current state of the program under test. The scheduler keeps the hashes of all
+// iterations, and strategies like DFS prune the schedules that continue from a state that was already reached.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_report_state(size_t state_hash);
+#else
+	#define FFI_report_state(x)
+#endif
+
+// Reports that the last iteration found a bug. Call it after the iteration detached and before the next one
+// attaches. The portfolio strategy gives more iterations to the strategies that find bugs.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_report_bug();
+#else
+	#define FFI_report_bug()
+#endif
+
+// Returns the number of distinct states reported with FFI_report_state across all iterations.
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_distinct_state_count();
+#else
+	#define FFI_distinct_state_count() 0
+#endif
+
+// Collects metrics about each iteration: scheduling decisions, elided steps, context switches, time that
+// operations spent paused, resource waits and signals, and the time of attaching and detaching. Call it
+// after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_metrics();
+#else
+	#define FFI_enable_metrics()
+#endif
+
+// Returns the value of the metric with the specified name, such as "context_switches", summed over all
+// completed iterations if is_total is true, else of the last completed iteration.
+#ifndef DISABLE_COYOTE_FFI
+	unsigned long long FFI_metric(const char* name, bool is_total);
+#else
+	#define FFI_metric(x, y) 0
+#endif
+
+// Writes the metrics of each completed iteration to the specified path, as JSON if the path ends with
+// '.json', else as CSV.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_dump_metrics(const char* path);
+#else
+	#define FFI_dump_metrics(x)
+#endif
+
 // For deleting the scheduler instance
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_delete_scheduler();
@@ -83,6 +194,30 @@
 	#define FFI_detach_scheduler()
 #endif
 
+// Splits num_iterations testing iterations across num_workers forked processes with disjoint seed ranges,
+// and stops all of them as soon as one finds a bug or crashes. Each worker calls worker_main with the seed
+// of its first iteration and its number of iterations, and must create its own scheduler with that seed.
+// Returns 1 and stores the seed of the buggy iteration in bug_seed if a bug was found, else returns 0.
+#ifndef DISABLE_COYOTE_FFI
+	int FFI_run_parallel(size_t num_workers, size_t num_iterations, size_t seed,
+		void (*worker_main)(size_t first_seed, size_t num_iterations), size_t* bug_seed);
+#else
+	#define FFI_run_parallel(x, y, z, a, b) 0
+#endif
+
+// Runs testing iterations until max_iterations have completed or time_budget_ms milliseconds have passed,
+// whichever comes first. A budget of 0 leaves that dimension unbounded. Each call of iteration runs one
+// iteration, including attaching and detaching the scheduler, and returns false if it found a bug. An
+// iteration that leaves an error in the scheduler, such as a deadlock, also found a bug. Prints the number
+// of iterations per second and the seeds of the buggy iterations. Returns 1 and stores the seed of the
+// first buggy iteration in bug_seed if a bug was found, else returns 0.
+#ifndef DISABLE_COYOTE_FFI
+	int FFI_run_campaign(size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug,
+		bool (*iteration)(void), size_t* bug_seed);
+#else
+	#define FFI_run_campaign(x, y, z, a, b) 0
+#endif
+
 // Just asserts that scheduler didn't encountered any error.
 // Asserts that scheduler->error_code() == ErrorCode::Success
 #ifndef DISABLE_COYOTE_FFI
@@ -175,6 +310,15 @@
 	#define FFI_schedule_next()
 #endif
 
+// Same as FFI_schedule_next, and declares that the next step of the current operation only accesses the
+// resource or address location, and only reads it unless is_write is true. SleepSetDFSStrategy skips the
+// interleavings that only reorder steps that access different locations, or only read the same one.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_schedule_next_access(size_t location, bool is_write);
+#else
+	#define FFI_schedule_next_access(x, y)
+#endif
+
 // FFI for Coyote next_boolean(void) API call
 #ifndef DISABLE_COYOTE_FFI
 	bool FFI_next_boolean();
@@ -13,6 +13,10 @@
 
 #define INTERCEPT_HEAP_ALLOCATORS
 
+// Handle to the scheduler and the modelled pthread objects, program state and heap allocations of one test
+// harness. See the FFI_ctx_* functions below.
+typedef struct FFI_context FFI_context;
+
 // FFI for Coyote create_scheduler(void) API call
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_create_scheduler();
@@ -27,6 +31,14 @@
 	#define FFI_create_scheduler_w_seed(x)
 #endif
 
+// FFI for creating a scheduler with the POS strategy and the seed. It samples the orders of the steps that
+// race on the locations declared with FFI_schedule_next_access more evenly than a random walk.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_pos(size_t seed);
+#else
+	#define FFI_create_scheduler_pos(x)
+#endif
+
 // FFI for Coyote create_scheduler("RandomStrategy") API call
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_create_scheduler_rand();
@@ -48,6 +60,29 @@
 	#define FFI_create_scheduler_dfs()
 #endif
 
+// FFI for Coyote create_scheduler("PreemptionBoundedDFSStrategy") API call. It explores the schedules with
+// at most 0 preemptions, then at most 1, and so on.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_preemption_bounded();
+#else
+	#define FFI_create_scheduler_preemption_bounded()
+#endif
+
+// FFI for Coyote create_scheduler("DelayBoundedDFSStrategy") API call. It explores the schedules with at
+// most 0 delays of the round-robin schedule, then at most 1, and so on.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_delay_bounded();
+#else
+	#define FFI_create_scheduler_delay_bounded()
+#endif
+
+// FFI for creating a scheduler that replays the trace file written by FFI_record_trace
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_scheduler_replay(const char* path);
+#else
+	#define FFI_create_scheduler_replay(x)
+#endif
+
 // For deleting the scheduler instance
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_delete_scheduler();
@@ -69,6 +104,30 @@
 	#define FFI_detach_scheduler()
 #endif
 
+// Splits num_iterations testing iterations across num_workers forked processes with disjoint seed ranges,
+// and stops all of them as soon as one finds a bug or crashes. Each worker calls worker_main with the seed
+// of its first iteration and its number of iterations, and must create its own scheduler with that seed.
+// Returns 1 and stores the seed of the buggy iteration in bug_seed if a bug was found, else returns 0.
+#ifndef DISABLE_COYOTE_FFI
+	int FFI_run_parallel(size_t num_workers, size_t num_iterations, size_t seed,
+		void (*worker_main)(size_t first_seed, size_t num_iterations), size_t* bug_seed);
+#else
+	#define FFI_run_parallel(x, y, z, a, b) 0
+#endif
+
+// Runs testing iterations until max_iterations have completed or time_budget_ms milliseconds have passed,
+// whichever comes first. A budget of 0 leaves that dimension unbounded. Each call of iteration runs one
+// iteration, including attaching and detaching the scheduler, and returns false if it found a bug. An
+// iteration that leaves an error in the scheduler, such as a deadlock, also found a bug. Prints the number
+// of iterations per second and the seeds of the buggy iterations. Returns 1 and stores the seed of the
+// first buggy iteration in bug_seed if a bug was found, else returns 0.
+#ifndef DISABLE_COYOTE_FFI
+	int FFI_run_campaign(size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug,
+		bool (*iteration)(void), size_t* bug_seed);
+#else
+	#define FFI_run_campaign(x, y, z, a, b) 0
+#endif
+
 // Just asserts that scheduler didn't encountered any error.
 // Asserts that scheduler->error_code() == ErrorCode::Success
 #ifndef DISABLE_COYOTE_FFI
@@ -84,6 +143,120 @@
 	#define FFI_create_operation(x)
 #endif
 
+// Runs the controlled operations as fibers on the thread that attaches the scheduler, instead of
+// on their own threads. Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_fibers();
+#else
+	#define FFI_enable_fibers()
+#endif
+
+// Returns true if FFI_enable_fibers() was called.
+#ifndef DISABLE_COYOTE_FFI
+	bool FFI_fibers_enabled();
+#else
+	#define FFI_fibers_enabled() false
+#endif
+
+// Runs the next iteration up to its ready_step-th call to FFI_schedule_next, and then forks num_iterations
+// child processes from a snapshot of the process at that point, one at a time, so that each child only runs
+// the rest of the iteration. The children use consecutive seeds from first_seed, and exit when they detach.
+// The server stops forking after the first child that finds a bug.
+// The process must run a single thread, so call FFI_enable_fibers first. Call it after creating the
+// scheduler and before the attach of the iteration to fork.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_fork_server(size_t ready_step, size_t num_iterations, size_t first_seed);
+#else
+	#define FFI_enable_fork_server(x, y, z)
+#endif
+
+// Lets scheduling points where a single operation is enabled return without consulting the strategy.
+// Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_scheduling_elision();
+#else
+	#define FFI_enable_scheduling_elision()
+#endif
+
+// Records the scheduling decisions of the latest iteration into the trace file at the specified path.
+// Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_record_trace(const char* path);
+#else
+	#define FFI_record_trace(x)
+#endif
+
+// Fails the iteration once it takes more than the specified number of scheduling steps without calling
+// FFI_signal_progress, which FFI_set_state_read and FFI_set_state_write do on each state change. A bound
+// of 0 disables the check. Call it after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_set_livelock_bound(size_t max_steps);
+#else
+	#define FFI_set_livelock_bound(x)
+#endif
+
+// Signals that the program under test made progress, which restarts the step budget of FFI_set_livelock_bound.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_signal_progress();
+#else
+	#define FFI_signal_progress()
+#endif
+
+// Reports the hash of the current state of the program under test. The scheduler keeps the hashes of all
+// iterations, and strategies like DFS prune the schedules that continue from a state that was already reached.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_report_state(size_t state_hash);
+#else
+	#define FFI_report_state(x)
+#endif
+
+// Reports that the last iteration found a bug. Call it after the iteration detached and before the next one
+// attaches. The portfolio strategy gives more iterations to the strategies that find bugs.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_report_bug();
+#else
+	#define FFI_report_bug()
+#endif
+
+// Returns the number of distinct states reported with FFI_report_state across all iterations.
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_distinct_state_count();
+#else
+	#define FFI_distinct_state_count() 0
+#endif
+
+// Collects metrics about each iteration: scheduling decisions, elided steps, context switches, time that
+// operations spent paused, resource waits and signals, and the time of attaching and detaching. Call it
+// after creating the scheduler and before the first attach.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_enable_metrics();
+#else
+	#define FFI_enable_metrics()
+#endif
+
+// Returns the value of the metric with the specified name, such as "context_switches", summed over all
+// completed iterations if is_total is true, else of the last completed iteration.
+#ifndef DISABLE_COYOTE_FFI
+	unsigned long long FFI_metric(const char* name, bool is_total);
+#else
+	#define FFI_metric(x, y) 0
+#endif
+
+// Writes the metrics of each completed iteration to the specified path, as JSON if the path ends with
+// '.json', else as CSV.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_dump_metrics(const char* path);
+#else
+	#define FFI_dump_metrics(x)
+#endif
+
+// FFI for Coyote create_operation(size_t, void (*)(void*), void*) API call. Only valid once fibers are enabled.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_create_fiber_operation(size_t id, void (*func)(void*), void* arg);
+#else
+	#define FFI_create_fiber_operation(x, y, z)
+#endif
+
 // FFI for Coyote start_operation(size_t) API call
 #ifndef DISABLE_COYOTE_FFI
 	void FFI_start_operation(size_t);
@@ -161,6 +334,15 @@
 	#define FFI_schedule_next()
 #endif
 
+// Same as FFI_schedule_next, and declares that the next step of the current operation only accesses the
+// resource or address location, and only reads it unless is_write is true. SleepSetDFSStrategy skips the
+// interleavings that only reorder steps that access different locations, or only read the same one.
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_schedule_next_access(size_t location, bool is_write);
+#else
+	#define FFI_schedule_next_access(x, y)
+#endif
+
 // FFI for Coyote next_boolean(void) API call
 #ifndef DISABLE_COYOTE_FFI
 	bool FFI_next_boolean();
@@ -309,6 +491,322 @@
 	#define FFI_set_state_write()
 #endif
 
+/* Context handles. Each context holds a scheduler and all the per-test state of the FFI, so several harnesses
+*  can run concurrently in one process, each on its own thread. The FFI_* functions without a context, such as
+*  the pthread models and heap allocators called by the program under test, use the context bound to the
+*  calling thread, else a default context. FFI_ctx_attach binds the attaching thread, which also covers the
+*  operations that run as fibers on it. Threads of operations that do not run as fibers must call FFI_ctx_bind.
+*/
+
+// Creates a context with a scheduler that uses the random strategy
+#ifndef DISABLE_COYOTE_FFI
+	FFI_context* FFI_ctx_create();
+#else
+	#define FFI_ctx_create() NULL
+#endif
+
+// Creates a context with a scheduler that uses the random strategy with the seed
+#ifndef DISABLE_COYOTE_FFI
+	FFI_context* FFI_ctx_create_w_seed(size_t seed);
+#else
+	#define FFI_ctx_create_w_seed(x) NULL
+#endif
+
+// Deletes the context and its scheduler
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_delete(FFI_context* ctx);
+#else
+	#define FFI_ctx_delete(x)
+#endif
+
+// Returns the context used by the calling thread
+#ifndef DISABLE_COYOTE_FFI
+	FFI_context* FFI_ctx_current();
+#else
+	#define FFI_ctx_current() NULL
+#endif
+
+// Binds the calling thread to the context, or to the default context if it is NULL
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_bind(FFI_context* ctx);
+#else
+	#define FFI_ctx_bind(x)
+#endif
+
+// FFI for Coyote attach_scheduler(void) API call on the context. Binds the calling thread to the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_attach(FFI_context* ctx);
+#else
+	#define FFI_ctx_attach(x)
+#endif
+
+// FFI for Coyote detach_scheduler(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_detach(FFI_context* ctx);
+#else
+	#define FFI_ctx_detach(x)
+#endif
+
+// Asserts that the scheduler of the context didn't encounter any error
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_scheduler_assert(FFI_context* ctx);
+#else
+	#define FFI_ctx_scheduler_assert(x)
+#endif
+
+// Same as FFI_enable_fibers, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_enable_fibers(FFI_context* ctx);
+#else
+	#define FFI_ctx_enable_fibers(x)
+#endif
+
+// Same as FFI_fibers_enabled, on the context
+#ifndef DISABLE_COYOTE_FFI
+	bool FFI_ctx_fibers_enabled(FFI_context* ctx);
+#else
+	#define FFI_ctx_fibers_enabled(x) false
+#endif
+
+// Same as FFI_enable_fork_server, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_enable_fork_server(FFI_context* ctx, size_t ready_step, size_t num_iterations, size_t first_seed);
+#else
+	#define FFI_ctx_enable_fork_server(x, y, z, a)
+#endif
+
+// Same as FFI_enable_scheduling_elision, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_enable_scheduling_elision(FFI_context* ctx);
+#else
+	#define FFI_ctx_enable_scheduling_elision(x)
+#endif
+
+// Same as FFI_record_trace, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_record_trace(FFI_context* ctx, const char* path);
+#else
+	#define FFI_ctx_record_trace(x, y)
+#endif
+
+// Same as FFI_set_livelock_bound, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_set_livelock_bound(FFI_context* ctx, size_t max_steps);
+#else
+	#define FFI_ctx_set_livelock_bound(x, y)
+#endif
+
+// Same as FFI_signal_progress, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_signal_progress(FFI_context* ctx);
+#else
+	#define FFI_ctx_signal_progress(x)
+#endif
+
+// Same as FFI_report_state, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_report_state(FFI_context* ctx, size_t state_hash);
+#else
+	#define FFI_ctx_report_state(x, y)
+#endif
+
+// Same as FFI_report_bug, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_report_bug(FFI_context* ctx);
+#else
+	#define FFI_ctx_report_bug(x)
+#endif
+
+// Same as FFI_distinct_state_count, on the context
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_distinct_state_count(FFI_context* ctx);
+#else
+	#define FFI_ctx_distinct_state_count(x) 0
+#endif
+
+// Same as FFI_enable_metrics, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_enable_metrics(FFI_context* ctx);
+#else
+	#define FFI_ctx_enable_metrics(x)
+#endif
+
+// Same as FFI_metric, on the context
+#ifndef DISABLE_COYOTE_FFI
+	unsigned long long FFI_ctx_metric(FFI_context* ctx, const char* name, bool is_total);
+#else
+	#define FFI_ctx_metric(x, y, z) 0
+#endif
+
+// Same as FFI_dump_metrics, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_dump_metrics(FFI_context* ctx, const char* path);
+#else
+	#define FFI_ctx_dump_metrics(x, y)
+#endif
+
+// Same as FFI_run_campaign, on the context
+#ifndef DISABLE_COYOTE_FFI
+	int FFI_ctx_run_campaign(FFI_context* ctx, size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug,
+		bool (*iteration)(void), size_t* bug_seed);
+#else
+	#define FFI_ctx_run_campaign(x, y, z, a, b, c) 0
+#endif
+
+// FFI for Coyote create_operation(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_create_operation(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_create_operation(x, y)
+#endif
+
+// FFI for Coyote create_operation(size_t, void (*)(void*), void*) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_create_fiber_operation(FFI_context* ctx, size_t id, void (*func)(void*), void* arg);
+#else
+	#define FFI_ctx_create_fiber_operation(x, y, z, a)
+#endif
+
+// FFI for Coyote start_operation(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_start_operation(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_start_operation(x, y)
+#endif
+
+// FFI for Coyote join_operation(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_join_operation(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_join_operation(x, y)
+#endif
+
+// FFI for Coyote join_operations(size_t*, size_t, bool) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_join_operations(FFI_context* ctx, const size_t* operation_ids, size_t size, bool wait_all);
+#else
+	#define FFI_ctx_join_operations(x, y, z, a)
+#endif
+
+// FFI for Coyote complete_operation(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_complete_operation(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_complete_operation(x, y)
+#endif
+
+// FFI for Coyote create_resource(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_create_resource(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_create_resource(x, y)
+#endif
+
+// FFI for Coyote wait_resource(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_wait_resource(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_wait_resource(x, y)
+#endif
+
+// FFI for Coyote wait_resources(size_t*, size_t, bool) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_wait_resources(FFI_context* ctx, const size_t* resource_ids, size_t size, bool wait_all);
+#else
+	#define FFI_ctx_wait_resources(x, y, z, a)
+#endif
+
+// FFI for Coyote signal_resource(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_signal_resource(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_signal_resource(x, y)
+#endif
+
+// FFI for Coyote signal_resource(size_t, size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_signal_resource_to_op(FFI_context* ctx, size_t id, size_t op_id);
+#else
+	#define FFI_ctx_signal_resource_to_op(x, y, z)
+#endif
+
+// FFI for Coyote delete_resource(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_delete_resource(FFI_context* ctx, size_t id);
+#else
+	#define FFI_ctx_delete_resource(x, y)
+#endif
+
+// FFI for Coyote schedule_next(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_schedule_next(FFI_context* ctx);
+#else
+	#define FFI_ctx_schedule_next(x)
+#endif
+
+// Same as FFI_schedule_next_access, on the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_schedule_next_access(FFI_context* ctx, size_t location, bool is_write);
+#else
+	#define FFI_ctx_schedule_next_access(x, y, z)
+#endif
+
+// FFI for Coyote next_boolean(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	bool FFI_ctx_next_boolean(FFI_context* ctx);
+#else
+	#define FFI_ctx_next_boolean(x) (assert(0 && "Should not be called with DISABLE_COYOTE_FFI"); return 0;)
+#endif
+
+// FFI for Coyote next_integer(size_t) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_next_integer(FFI_context* ctx, size_t max_value);
+#else
+	#define FFI_ctx_next_integer(x, y) (assert(0 && "Should not be called with DISABLE_COYOTE_FFI"); return 0;)
+#endif
+
+// FFI for Coyote seed(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_seed(FFI_context* ctx);
+#else
+	#define FFI_ctx_seed(x) (assert(0 && "Should not be called with DISABLE_COYOTE_FFI"); return 0;)
+#endif
+
+// FFI for Coyote error_code(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_error_code(FFI_context* ctx);
+#else
+	#define FFI_ctx_error_code(x) (assert(0 && "Should not be called with DISABLE_COYOTE_FFI"); return 0;)
+#endif
+
+// FFI for Coyote get_operation_id(void) API call on the context
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_get_operation_id(FFI_context* ctx);
+#else
+	#define FFI_ctx_get_operation_id(x) (assert(0 && "Should not be called with DISABLE_COYOTE_FFI"); return 0;)
+#endif
+
+// Allocates the id of an operation that the program under test creates in the current iteration of the context.
+// Ids restart from 1 on each FFI_ctx_attach, so the same schedule creates the same operations in every iteration
+// and process, as the DFS strategies and the replay of a trace expect
+#ifndef DISABLE_COYOTE_FFI
+	size_t FFI_ctx_next_operation_id(FFI_context* ctx);
+#else
+	#define FFI_ctx_next_operation_id(x) 0
+#endif
+
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_set_state_read(FFI_context* ctx);
+#else
+	#define FFI_ctx_set_state_read(x)
+#endif
+
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_set_state_write(FFI_context* ctx);
+#else
+	#define FFI_ctx_set_state_write(x)
+#endif
+
 #ifdef INTERCEPT_HEAP_ALLOCATORS
 
 #ifndef DISABLE_COYOTE_FFI
@@ -341,6 +839,13 @@
 	#define FFI_free_all()
 #endif
 
+// Frees the heap allocations of the context
+#ifndef DISABLE_COYOTE_FFI
+	void FFI_ctx_free_all(FFI_context* ctx);
+#else
+	#define FFI_ctx_free_all(x)
+#endif
+
 #endif
 
 #endif // COYOTE_C_FFI
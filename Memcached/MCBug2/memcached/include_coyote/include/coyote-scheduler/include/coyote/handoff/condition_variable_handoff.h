@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CONDITION_VARIABLE_HANDOFF_H
+#define COYOTE_CONDITION_VARIABLE_HANDOFF_H
+
+#include "handoff_engine.h"
+
+namespace coyote
+{
+	// Parks each operation on its own condition variable under the scheduler mutex. A resumed
+	// thread has to reacquire the scheduler mutex before it can run, so every scheduling decision
+	// costs two futex round trips.
+	class ConditionVariableHandoff : public HandoffEngine
+	{
+	public:
+		ConditionVariableHandoff() noexcept;
+
+		ConditionVariableHandoff(ConditionVariableHandoff&& engine) = delete;
+		ConditionVariableHandoff(ConditionVariableHandoff const&) = delete;
+
+		ConditionVariableHandoff& operator=(ConditionVariableHandoff&& engine) = delete;
+		ConditionVariableHandoff& operator=(ConditionVariableHandoff const&) = delete;
+
+		void wait(Operation& op, std::unique_lock<std::mutex>& lock);
+		void notify(Operation& op);
+		void handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock);
+		std::string get_description();
+	};
+}
+
+#endif // COYOTE_CONDITION_VARIABLE_HANDOFF_H
@@ -0,0 +1,67 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_HANDOFF_ENGINE_H
+#define COYOTE_HANDOFF_ENGINE_H
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include "../error_code.h"
+#include "../operations/operation.h"
+
+namespace coyote
+{
+	// Mechanism that the scheduler uses to park and resume the threads of controlled operations.
+	// All methods are invoked while the scheduler mutex is held by the caller, and they must return
+	// with the mutex held again.
+	class HandoffEngine
+	{
+	public:
+		virtual ~HandoffEngine() {}
+
+		// Blocks the thread of the specified operation until it is notified. The caller re-checks the
+		// scheduling state after this returns, so spurious wakeups are allowed.
+		virtual void wait(Operation& op, std::unique_lock<std::mutex>& lock) = 0;
+
+		// Wakes the thread of the specified operation, which has been scheduled or canceled.
+		virtual void notify(Operation& op) = 0;
+
+		// Passes control from the currently executing operation to the next scheduled operation,
+		// and blocks the thread of the current operation until it is notified again.
+		virtual void handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock) = 0;
+
+		// Passes control from an operation that has just completed to the next scheduled operation.
+		// The completed operation is never resumed again.
+		virtual void release(Operation& /*completed*/, Operation& next, std::unique_lock<std::mutex>& /*lock*/)
+		{
+			notify(next);
+		}
+
+		// True if the engine can run the body of an operation through 'launch', else false.
+		virtual bool supports_launch()
+		{
+			return false;
+		}
+
+		// Runs the body of a newly created operation on behalf of the currently executing operation, and
+		// returns once the new operation pauses for the first time. The body inherits the held scheduler
+		// mutex. Only engines that run operations as fibers on the calling thread support this.
+		virtual void launch(Operation& /*current*/, Operation& /*op*/, std::function<void()> /*body*/,
+			std::unique_lock<std::mutex>& /*lock*/)
+		{
+			throw ErrorCode::NotSupported;
+		}
+
+		// Invoked when the scheduler detaches, after all remaining operations have been canceled and before
+		// their slots are reused by the next iteration. The engine may release the mutex while it waits.
+		virtual void reset(std::unique_lock<std::mutex>& /*lock*/)
+		{
+		}
+
+		// Description about the engine.
+		virtual std::string get_description() = 0;
+	};
+}
+
+#endif // COYOTE_HANDOFF_ENGINE_H
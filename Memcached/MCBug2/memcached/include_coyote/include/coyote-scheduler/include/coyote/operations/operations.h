@@ -7,6 +7,8 @@
 #include <vector>
 #include <list>
 #include <algorithm>
+#include <unordered_map>
+#include "../memory/arena.h"
 
 namespace coyote
 {
@@ -17,6 +19,21 @@ namespace coyote
 		size_t enabled_operations_size;
 		size_t disabled_operations_size;
 
+		typedef std::unordered_map<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+			ArenaAllocator<std::pair<const size_t, size_t>>> PositionMap;
+
+		// Arena that holds the position map. It is reset when this set is cleared.
+		Arena arena;
+
+		// Map from operation ids to their position in 'operation_ids', or null until the first insert.
+		PositionMap* positions;
+
+		// The enabled operation ids sorted in ascending order, rebuilt lazily after the enabled set changes.
+		std::vector<size_t> sorted_enabled_operation_ids;
+
+		// True if 'sorted_enabled_operation_ids' reflects the current enabled set, else false.
+		bool is_sorted_view_valid;
+
 	public:
 		Operations() noexcept;
 
@@ -35,6 +52,10 @@ namespace coyote
 
 		size_t size(bool is_enabled = true);
 
+		// Returns the enabled operation ids sorted in ascending order. The view does not allocate once
+		// its capacity has grown, and is only valid until the next change to this set.
+		const std::vector<size_t>& enabled_operation_ids();
+
 		// Return a vector of enabled operations
 		std::vector<size_t> get_enabled_operation_ids();
 
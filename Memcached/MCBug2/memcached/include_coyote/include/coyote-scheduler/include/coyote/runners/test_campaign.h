@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TEST_CAMPAIGN_H
+#define COYOTE_TEST_CAMPAIGN_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "../error_code.h"
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// An iteration of a test campaign that found a bug.
+	struct CampaignBug
+	{
+		// The index of the iteration in the campaign, starting from '0'.
+		size_t iteration;
+
+		// The seed that reproduces the iteration, if the strategy is seeded.
+		size_t seed;
+
+		// The error code that the scheduler reported, which is 'ErrorCode::Success' if the test itself
+		// reported the bug.
+		ErrorCode error_code;
+
+		// The wall-clock time from the start of the campaign until the iteration completed.
+		std::chrono::nanoseconds time;
+	};
+
+	// Runs testing iterations on a scheduler until a budget of iterations or of wall-clock time is spent,
+	// and reports the throughput of the campaign and the seeds of the iterations that found bugs. A budget
+	// of '0' leaves that dimension unbounded. Iterations can either be driven by 'run', or by the caller
+	// with 'next_iteration' and 'complete_iteration', when attaching and detaching need extra work.
+	class TestCampaign
+	{
+	private:
+		// The scheduler that runs the iterations.
+		Scheduler& scheduler;
+
+		// The maximum number of iterations, or '0' if the campaign is not bounded by iterations.
+		const size_t max_iterations;
+
+		// The wall-clock budget, or '0' if the campaign is not bounded by time.
+		const std::chrono::milliseconds time_budget;
+
+		// True if the campaign stops after the first iteration that finds a bug, else false.
+		const bool stop_on_first_bug;
+
+		// The time at which the first iteration started.
+		std::chrono::steady_clock::time_point start_time;
+
+		// The wall-clock time from the start of the campaign until the last iteration completed.
+		std::chrono::nanoseconds elapsed_time;
+
+		// The number of completed iterations.
+		size_t completed_iteration_count;
+
+		// The iterations that found bugs, in the order in which they completed.
+		std::vector<CampaignBug> bugs;
+
+	public:
+		TestCampaign(Scheduler& scheduler, size_t max_iterations, std::chrono::milliseconds time_budget,
+			bool stop_on_first_bug) noexcept;
+
+		TestCampaign(TestCampaign&& campaign) = delete;
+		TestCampaign(TestCampaign const&) = delete;
+
+		TestCampaign& operator=(TestCampaign&& campaign) = delete;
+		TestCampaign& operator=(TestCampaign const&) = delete;
+
+		// Runs iterations until the budget is spent. Each iteration attaches to the scheduler, runs the
+		// specified test, and detaches. The test returns false if it found a bug. An iteration also finds
+		// a bug if the scheduler reports an error, such as a deadlock. Returns an error only if the campaign
+		// could not run, and not if it found bugs.
+		ErrorCode run(std::function<bool()> test) noexcept;
+
+		// Returns true if the budget allows another iteration, else false. The campaign starts its clock on
+		// the first call.
+		bool next_iteration() noexcept;
+
+		// Reports that the current iteration has completed and detached from the scheduler, and whether the
+		// test passed. The campaign reads the seed and error code of the iteration from the scheduler, and
+		// reports the bugs back to it with 'report_bug'.
+		void complete_iteration(bool passed);
+
+		// Returns the number of completed iterations.
+		size_t completed_iterations() const noexcept;
+
+		// Returns the wall-clock time of the campaign in seconds.
+		double elapsed_seconds() const noexcept;
+
+		// Returns the number of completed iterations per second of wall-clock time.
+		double iterations_per_second() const noexcept;
+
+		// Returns true if an iteration found a bug, else false.
+		bool bug_found() const noexcept;
+
+		// Returns the iterations that found bugs.
+		const std::vector<CampaignBug>& found_bugs() const noexcept;
+
+		// Returns the wall-clock time in seconds until the first bug was found, or a negative value if no
+		// bug was found.
+		double time_to_first_bug_seconds() const noexcept;
+	};
+}
+
+#endif // COYOTE_TEST_CAMPAIGN_H
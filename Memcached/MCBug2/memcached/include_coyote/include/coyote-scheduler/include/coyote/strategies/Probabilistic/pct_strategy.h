@@ -6,15 +6,24 @@
 
 #include "../random.h"
 #include "../strategy.h"
-#include <list>
-#include <set>
+#include "../../memory/arena.h"
 #include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace coyote
 {
+	// Probabilistic concurrency testing: schedules the enabled operation with the highest priority, gives
+	// each new operation a random priority, and lowers the priority of the scheduled operation below all
+	// others at a few random steps of the iteration. The strategy keeps its state in flat arrays that keep
+	// their capacity across iterations, so steps take constant time and iterations do not allocate, even
+	// on schedules that take millions of steps.
 	class PCTStrategy : public Strategy
 	{
 	private:
+		typedef std::unordered_map<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>,
+			ArenaAllocator<std::pair<const size_t, size_t>>> SlotMap;
 
 		// Max number of priority switch points.
 		int max_priority_switch_points;
@@ -28,20 +37,35 @@ namespace coyote
 		// The pseudo-random generator.
 		Random random_generator;
 
-		// List of prioritized operations.
-		std::list<size_t>* prioritized_operations;
+		// Arena that holds the slot map. It is reset on each iteration.
+		Arena arena;
 
-		// Set of priority change points.
-		std::set<int>* priority_change_points;
+		// Map from the ids of the operations of the current iteration to their slots in 'priorities', or
+		// null until the first operation of the iteration.
+		SlotMap* operation_slots;
 
-		// Retrun the prioritized operation
-		size_t get_prioritized_operation(std::vector<size_t> enabled_oprs);
+		// The priority of each operation slot. A higher value is a higher priority.
+		std::vector<uint64_t> priorities;
 
-		// Return the highest priority enabled operation
-		size_t get_highest_priority_enabled_operation(std::vector<size_t> enabled_oprs);
+		// The priority that the next lowered operation gets, which is below all other priorities.
+		uint64_t next_lowered_priority;
 
-		// Updates the priority change point to some other point (forward)
-		void move_priority_change_point_forward();
+		// The steps at which the priority of the scheduled operation is lowered, in ascending order.
+		std::vector<int> priority_change_points;
+
+		// The index of the first priority change point that was not reached yet.
+		size_t next_change_point_index;
+
+		// Returns the priority of the operation with the specified id, and assigns a random priority to
+		// operations that are new in this iteration.
+		uint64_t& priority(size_t operation_id);
+
+		// Returns the highest priority enabled operation.
+		size_t get_highest_priority_enabled_operation(const std::vector<size_t>& enabled_oprs);
+
+		// Moves the next priority change point to the first step after the specified step that is not
+		// a change point.
+		void move_priority_change_point_forward(int step);
 
 	public:
 		PCTStrategy(int maxPrioritySwitchPoints = 2) noexcept;
@@ -50,10 +74,21 @@ namespace coyote
 		size_t next_operation(Operations& operations);
 
 		// Returns the next boolean choice.
-		bool next_boolean();
+		bool next_boolean()
+		{
+			this->scheduled_steps++;
+			return random_generator.next() & 1;
+		}
 
 		// Returns the next integer choice.
-		int next_integer(int max_value);
+		int next_integer(int max_value)
+		{
+			this->scheduled_steps++;
+			return random_generator.next() % max_value;
+		}
+
+		// Accounts for elided steps, which move the priority change points that they cover forward.
+		void skip_steps(size_t operation_id, size_t count);
 
 		// Prepares the next iteration.
 		void prepare_next_iteration();
@@ -68,4 +103,4 @@ namespace coyote
 	};
 }
 
-#endif // COYOTE_DFS_STRATEGY_H
+#endif // COYOTE_PCT_STRATEGY_H
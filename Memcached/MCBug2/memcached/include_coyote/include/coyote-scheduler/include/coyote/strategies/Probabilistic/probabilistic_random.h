@@ -42,14 +42,26 @@ namespace coyote
 		size_t next_operation(Operations& operations);
 
 		// Returns the next boolean choice.
-		bool next_boolean();
+		bool next_boolean()
+		{
+			return (generator.next() & 1) == 0;
+		}
 
 		// Returns the next integer choice.
-		int next_integer(int max_value);
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
 
 		// Returns the seed used in the current iteration.
 		size_t seed();
 
+		// Restarts the choices of the current iteration from the specified seed.
+		bool reseed(size_t seed);
+
+		// Accounts for elided steps, which schedule the same operation and advance the step counter.
+		void skip_steps(size_t operation_id, size_t count);
+
 		// Prepares the next iteration.
 		void prepare_next_iteration();
 
@@ -128,6 +128,31 @@ namespace coyote
 			}
 		}
 
+		// Accounts for elided steps, which advance through the prefix like scheduled steps.
+		void skip_steps(size_t operation_id, size_t count)
+		{
+			if(stepsCounter < prefixPathLength){
+				long long unsigned prefixSteps = prefixPathLength - stepsCounter;
+				if(prefixSteps > count){
+					prefixSteps = count;
+				}
+
+				stepsCounter += prefixSteps;
+				count -= prefixSteps;
+				PrefixStrategy->skip_steps(operation_id, prefixSteps);
+			}
+
+			if(count > 0){
+				SuffixStrategy->skip_steps(operation_id, count);
+			}
+		}
+
+		// Sets the number of steps that the prefix strategy schedules, starting from the next iteration.
+		void set_prefix_length(long long unsigned prefixLen)
+		{
+			prefixPathLength = prefixLen;
+		}
+
 		// Prepares the next iteration.
 		void prepare_next_iteration()
 		{
@@ -28,8 +28,20 @@ namespace coyote
 
 		void seed(const size_t seed);
 
-		// Returns the next random number.
-		size_t next();
+		// Returns the next random number. This is inline, as it sits on the path of every nondeterministic
+		// choice of the client program.
+		inline size_t next()
+		{
+			const size_t x = state_x;
+			size_t y = state_y;
+			const size_t result = state_x + y;
+
+			y ^= x;
+			state_x = rotl(x, 24) ^ y ^ (y << 16);
+			state_y = rotl(y, 37);
+
+			return result;
+		}
 
 	private:
 		static inline size_t rotl(const size_t x, const size_t k)
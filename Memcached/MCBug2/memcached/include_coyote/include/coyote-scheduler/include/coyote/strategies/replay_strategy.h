@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_REPLAY_STRATEGY_H
+#define COYOTE_REPLAY_STRATEGY_H
+
+#include <string>
+#include <vector>
+#include "strategy.h"
+#include "../trace/trace_recorder.h"
+
+namespace coyote
+{
+	// Replays the schedule of a trace file written by 'TraceRecorder', so that an iteration found by any
+	// strategy, including the strategies without a seed, can be reproduced. Each iteration replays the
+	// trace from its start. If the program asks for a decision that does not match the trace, then the
+	// next scheduling point fails with 'ErrorCode::ReplayDiverged'.
+	class ReplayStrategy : public Strategy
+	{
+	private:
+		// A recorded scheduling decision.
+		struct Decision
+		{
+			TraceDecision kind;
+			size_t value;
+		};
+
+		// The decisions of the replayed iteration, in order.
+		std::vector<Decision> decisions;
+
+		// The index of the next decision to replay.
+		size_t cursor;
+
+		// True if the program asked for a decision that does not match the trace, else false.
+		bool is_diverged;
+
+		// Returns the next recorded decision of the specified kind, or false if there is none.
+		bool next_decision(TraceDecision kind, size_t& value) noexcept
+		{
+			if (is_diverged || cursor == decisions.size() || decisions[cursor].kind != kind)
+			{
+				is_diverged = true;
+				return false;
+			}
+
+			value = decisions[cursor++].value;
+			return true;
+		}
+
+	public:
+		// Loads the trace file at the specified path, or throws if it cannot be read.
+		ReplayStrategy(const std::string& path);
+
+		ReplayStrategy(ReplayStrategy&& strategy) = delete;
+		ReplayStrategy(ReplayStrategy const&) = delete;
+
+		ReplayStrategy& operator=(ReplayStrategy&& strategy) = delete;
+		ReplayStrategy& operator=(ReplayStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations);
+
+		// Returns the next boolean choice. It returns false after the execution diverged.
+		bool next_boolean()
+		{
+			size_t value = 0;
+			next_decision(TraceDecision::Boolean, value);
+			return value != 0;
+		}
+
+		// Returns the next integer choice. It returns '0' after the execution diverged.
+		int next_integer(int max_value)
+		{
+			size_t value = 0;
+			if (next_decision(TraceDecision::Integer, value) && value >= static_cast<size_t>(max_value))
+			{
+				is_diverged = true;
+				value = 0;
+			}
+
+			return static_cast<int>(value);
+		}
+
+		// Returns the number of decisions in the trace.
+		size_t size() const noexcept;
+
+		// Returns true if the current iteration diverged from the trace, else false.
+		bool diverged() const noexcept;
+
+		// Prepares the next iteration.
+		void prepare_next_iteration();
+
+		// Description about the strategy
+		std::string get_description();
+
+		// Fair strategy or not
+		bool is_fair();
+
+		// Returns '0', as the replayed schedule does not depend on a seed.
+		size_t seed();
+	};
+}
+
+#endif // COYOTE_REPLAY_STRATEGY_H
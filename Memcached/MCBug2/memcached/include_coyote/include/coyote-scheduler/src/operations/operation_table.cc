@@ -0,0 +1,252 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstdint>
+#include "error_code.h"
+#include "operations/operation_table.h"
+
+namespace coyote
+{
+	// Removes the first occurrence of the specified value from the vector, and returns true if it was found.
+	static bool erase_value(std::vector<size_t>& values, size_t value) noexcept
+	{
+		auto it = std::find(values.begin(), values.end(), value);
+		if (it == values.end())
+		{
+			return false;
+		}
+
+		*it = values.back();
+		values.pop_back();
+		return true;
+	}
+
+	// Appends the specified value to the vector, unless it is already there.
+	static void insert_value(std::vector<size_t>& values, size_t value)
+	{
+		if (std::find(values.begin(), values.end(), value) == values.end())
+		{
+			values.push_back(value);
+		}
+	}
+
+	OperationTable::OperationTable() noexcept :
+		slot_count(0)
+	{
+	}
+
+	size_t OperationTable::insert(size_t operation_id)
+	{
+		if ((slot_count + 1) * 2 > buckets.size())
+		{
+			grow_buckets();
+		}
+
+		size_t bucket = find_bucket(operation_id);
+		if (buckets[bucket] != 0)
+		{
+			throw ErrorCode::DuplicateOperation;
+		}
+
+		const size_t index = slot_count;
+		if (index == records.size())
+		{
+			ids.push_back(operation_id);
+			statuses.push_back(OperationStatus::None);
+			scheduled_flags.push_back(0);
+			records.push_back(std::make_unique<Operation>(operation_id));
+		}
+		else
+		{
+			ids[index] = operation_id;
+			statuses[index] = OperationStatus::None;
+			scheduled_flags[index] = 0;
+			records[index]->reset(operation_id);
+		}
+
+		buckets[bucket] = index + 1;
+		slot_count += 1;
+		return index;
+	}
+
+	size_t OperationTable::find(size_t operation_id) const noexcept
+	{
+		if (buckets.empty())
+		{
+			return npos;
+		}
+
+		const size_t bucket = buckets[find_bucket(operation_id)];
+		return bucket == 0 ? npos : bucket - 1;
+	}
+
+	size_t OperationTable::index_of(size_t operation_id) const
+	{
+		const size_t index = find(operation_id);
+		if (index == npos)
+		{
+			throw ErrorCode::NotExistingOperation;
+		}
+
+		return index;
+	}
+
+	size_t OperationTable::size() const noexcept
+	{
+		return slot_count;
+	}
+
+	size_t OperationTable::id(size_t index) const noexcept
+	{
+		return ids[index];
+	}
+
+	OperationStatus& OperationTable::status(size_t index) noexcept
+	{
+		return statuses[index];
+	}
+
+	bool OperationTable::is_scheduled(size_t index) const noexcept
+	{
+		return scheduled_flags[index] != 0;
+	}
+
+	void OperationTable::set_scheduled(size_t index, bool is_scheduled) noexcept
+	{
+		scheduled_flags[index] = is_scheduled ? 1 : 0;
+	}
+
+	Operation& OperationTable::operator[](size_t index) noexcept
+	{
+		return *records[index];
+	}
+
+	void OperationTable::join_operation(size_t index, size_t join_index)
+	{
+		statuses[index] = OperationStatus::JoinAllOperations;
+		insert_value(records[index]->pending_join_operation_indices, join_index);
+	}
+
+	void OperationTable::join_operations(size_t index, const std::vector<size_t>& join_indices, bool wait_all)
+	{
+		if (wait_all)
+		{
+			statuses[index] = OperationStatus::JoinAllOperations;
+		}
+		else
+		{
+			statuses[index] = OperationStatus::JoinAnyOperations;
+		}
+
+		for (auto& join_index : join_indices)
+		{
+			insert_value(records[index]->pending_join_operation_indices, join_index);
+		}
+	}
+
+	void OperationTable::wait_resource_signal(size_t index, size_t resource_id)
+	{
+		statuses[index] = OperationStatus::WaitAllResources;
+		insert_value(records[index]->pending_signal_resource_ids, resource_id);
+	}
+
+	void OperationTable::wait_resource_signals(size_t index, const size_t* resource_ids, size_t size, bool wait_all)
+	{
+		if (wait_all)
+		{
+			statuses[index] = OperationStatus::WaitAllResources;
+		}
+		else
+		{
+			statuses[index] = OperationStatus::WaitAnyResource;
+		}
+
+		for (size_t i = 0; i < size; i++)
+		{
+			insert_value(records[index]->pending_signal_resource_ids, *(resource_ids + i));
+		}
+	}
+
+	bool OperationTable::on_join_operation(size_t index, size_t join_index)
+	{
+		std::vector<size_t>& pending_join_operation_indices = records[index]->pending_join_operation_indices;
+		erase_value(pending_join_operation_indices, join_index);
+		if (statuses[index] == OperationStatus::JoinAllOperations && pending_join_operation_indices.empty())
+		{
+			// If the operation is waiting for all operations to complete, and there
+			// are no more pending operations, then enable the operation.
+			statuses[index] = OperationStatus::Enabled;
+			return true;
+		}
+		else if (statuses[index] == OperationStatus::JoinAnyOperations)
+		{
+			// If the operation is waiting for at least one operation, then enable the operation,
+			// and clear the set of pending operations.
+			statuses[index] = OperationStatus::Enabled;
+			pending_join_operation_indices.clear();
+			return true;
+		}
+
+		return false;
+	}
+
+	bool OperationTable::on_resource_signal(size_t index, size_t resource_id)
+	{
+		std::vector<size_t>& pending_signal_resource_ids = records[index]->pending_signal_resource_ids;
+		if (!erase_value(pending_signal_resource_ids, resource_id))
+		{
+			// The operation is not waiting for this resource anymore, e.g. because it was
+			// already enabled by another resource it was waiting on.
+			return false;
+		}
+
+		if (statuses[index] == OperationStatus::WaitAllResources && pending_signal_resource_ids.empty())
+		{
+			// If the operation is waiting for a signal from all resources, and there
+			// are no more pending resources, then enable the operation.
+			statuses[index] = OperationStatus::Enabled;
+			return true;
+		}
+		else if (statuses[index] == OperationStatus::WaitAnyResource)
+		{
+			// If the operation is waiting for at least one signal, then enable the operation,
+			// and clear the set of pending resources.
+			statuses[index] = OperationStatus::Enabled;
+			pending_signal_resource_ids.clear();
+			return true;
+		}
+
+		return false;
+	}
+
+	void OperationTable::clear() noexcept
+	{
+		std::fill(buckets.begin(), buckets.end(), 0);
+		slot_count = 0;
+	}
+
+	size_t OperationTable::find_bucket(size_t operation_id) const noexcept
+	{
+		// Multiplying by the golden ratio and folding the upper half spreads ids that only differ in their
+		// upper bits, such as thread handles.
+		const uint64_t hash = static_cast<uint64_t>(operation_id) * 0x9E3779B97F4A7C15ull;
+		const size_t mask = buckets.size() - 1;
+		size_t bucket = static_cast<size_t>(hash ^ (hash >> 32)) & mask;
+		while (buckets[bucket] != 0 && ids[buckets[bucket] - 1] != operation_id)
+		{
+			bucket = (bucket + 1) & mask;
+		}
+
+		return bucket;
+	}
+
+	void OperationTable::grow_buckets()
+	{
+		buckets.assign(buckets.empty() ? 16 : buckets.size() * 2, 0);
+		for (size_t index = 0; index < slot_count; index++)
+		{
+			buckets[find_bucket(ids[index])] = index + 1;
+		}
+	}
+}
@@ -0,0 +1,521 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "runners/parallel_dfs_runner.h"
+
+#if !defined(MSG_NOSIGNAL)
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace coyote
+{
+	// Kinds of messages that the runner sends to a worker. Each message is a kind, followed by a count and
+	// that many values.
+	static constexpr uint64_t EXPLORE_SUBTREE = 0;
+	static constexpr uint64_t STEAL_SUBTREES = 1;
+	static constexpr uint64_t STOP_WORKER = 2;
+
+	// Kinds of messages that a worker sends to the runner.
+	static constexpr uint64_t ITERATION_STARTED = 3;
+	static constexpr uint64_t ITERATION_PASSED = 4;
+	static constexpr uint64_t ITERATION_FAILED = 5;
+	static constexpr uint64_t SPLIT_SUBTREE = 6;
+	static constexpr uint64_t STEAL_DONE = 7;
+	static constexpr uint64_t WORKER_IDLE = 8;
+
+	// Reads exactly the specified number of bytes, and returns false if the socket was closed first.
+	static bool read_fully(int fd, void* buffer, size_t size) noexcept
+	{
+		char* data = static_cast<char*>(buffer);
+		while (size > 0)
+		{
+			ssize_t count = read(fd, data, size);
+			if (count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (count <= 0)
+			{
+				return false;
+			}
+
+			data += count;
+			size -= count;
+		}
+
+		return true;
+	}
+
+	// Writes a message, and returns false if the other end closed the socket. Writing to a closed socket
+	// fails instead of raising 'SIGPIPE'.
+	static bool write_message(int fd, uint64_t kind, const std::vector<size_t>& values) noexcept
+	{
+		std::vector<uint64_t> buffer;
+		buffer.reserve(values.size() + 2);
+		buffer.push_back(kind);
+		buffer.push_back(values.size());
+		buffer.insert(buffer.end(), values.begin(), values.end());
+
+		const char* data = reinterpret_cast<const char*>(buffer.data());
+		size_t size = buffer.size() * sizeof(uint64_t);
+		while (size > 0)
+		{
+			ssize_t count = send(fd, data, size, MSG_NOSIGNAL);
+			if (count < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if (count <= 0)
+			{
+				return false;
+			}
+
+			data += count;
+			size -= count;
+		}
+
+		return true;
+	}
+
+	// Reads a message, and returns false if the other end closed the socket.
+	static bool read_message(int fd, uint64_t& kind, std::vector<size_t>& values) noexcept
+	{
+		uint64_t header[2];
+		if (!read_fully(fd, header, sizeof(header)))
+		{
+			return false;
+		}
+
+		kind = header[0];
+		std::vector<uint64_t> buffer(header[1]);
+		if (!buffer.empty() && !read_fully(fd, buffer.data(), buffer.size() * sizeof(uint64_t)))
+		{
+			return false;
+		}
+
+		values.assign(buffer.begin(), buffer.end());
+		return true;
+	}
+
+	// Explores the subtrees that the runner assigns to this worker process, until the runner stops it.
+	// Between iterations, the worker serves the requests of the runner to split off unexplored subtrees.
+	// Returns the exit status of the worker.
+	static int run_worker(int fd, std::function<bool(BasicScheduler<DFSStrategy>&)>& test) noexcept
+	{
+		uint64_t kind;
+		std::vector<size_t> values;
+		while (read_message(fd, kind, values))
+		{
+			if (kind == STOP_WORKER)
+			{
+				return 0;
+			}
+			else if (kind == STEAL_SUBTREES)
+			{
+				// The request arrived after the last subtree was explored, so there is nothing to split.
+				write_message(fd, STEAL_DONE, {});
+				continue;
+			}
+
+			auto strategy = std::make_unique<DFSStrategy>(values);
+			DFSStrategy* dfs = strategy.get();
+			BasicScheduler<DFSStrategy> scheduler(std::move(strategy));
+			do
+			{
+				if (scheduler.attach() != ErrorCode::Success)
+				{
+					return 1;
+				}
+
+				write_message(fd, ITERATION_STARTED, {});
+
+				bool passed = false;
+				try
+				{
+					passed = test(scheduler);
+				}
+				catch (...)
+				{
+					// An exception that escapes the test is reported as a bug of the iteration.
+				}
+
+				scheduler.detach();
+				if (passed && scheduler.error_code() == ErrorCode::Success)
+				{
+					write_message(fd, ITERATION_PASSED, {});
+				}
+				else
+				{
+					write_message(fd, ITERATION_FAILED, dfs->current_schedule());
+				}
+
+				// Serve at most one request per iteration, so that the iterations progress even if the runner
+				// keeps asking for subtrees that this worker cannot split. Splitting can exhaust the subtree.
+				pollfd request = { fd, POLLIN, 0 };
+				if (poll(&request, 1, 0) > 0)
+				{
+					if (!read_message(fd, kind, values) || kind == STOP_WORKER)
+					{
+						return 0;
+					}
+
+					for (const auto& prefix : dfs->split_subtrees())
+					{
+						write_message(fd, SPLIT_SUBTREE, prefix);
+					}
+
+					write_message(fd, STEAL_DONE, {});
+				}
+			} while (!dfs->is_exhausted());
+
+			write_message(fd, WORKER_IDLE, {});
+		}
+
+		return 0;
+	}
+
+	ParallelDFSRunner::ParallelDFSRunner(size_t num_workers, bool stop_on_first_bug) noexcept :
+		num_workers(num_workers),
+		stop_on_first_bug(stop_on_first_bug),
+		completed_iteration_count(0),
+		failed_iteration_count(0),
+		stolen_subtree_count(0),
+		first_bug_schedule()
+	{
+	}
+
+	ErrorCode ParallelDFSRunner::run(std::function<bool(BasicScheduler<DFSStrategy>&)> test) noexcept
+	{
+		struct WorkerProcess
+		{
+			// The process id, or '-1' if the process was reaped.
+			pid_t pid;
+
+			// The socket to the worker, or '-1' if it was closed.
+			int fd;
+
+			// True if the worker explores a subtree, else false.
+			bool is_busy;
+
+			// True if the worker was asked to split its subtree and has not answered yet.
+			bool is_stealing;
+
+			// True if the worker started an iteration that has not completed yet.
+			bool has_pending_iteration;
+		};
+
+		std::vector<WorkerProcess> workers;
+		std::deque<std::vector<size_t>> subtrees;
+		bool is_stopping = false;
+		bool is_worker_lost = false;
+
+		auto stop_workers = [&workers, &is_stopping](bool is_forced)
+		{
+			is_stopping = true;
+			for (auto& worker : workers)
+			{
+				if (is_forced && worker.pid > 0)
+				{
+					kill(worker.pid, SIGTERM);
+				}
+				else if (worker.fd >= 0)
+				{
+					write_message(worker.fd, STOP_WORKER, {});
+				}
+			}
+		};
+
+		auto report_bug = [this, &stop_workers, &is_stopping](const std::vector<size_t>& schedule)
+		{
+			if (failed_iteration_count == 0)
+			{
+				first_bug_schedule = schedule;
+			}
+
+			failed_iteration_count += 1;
+			if (stop_on_first_bug && !is_stopping)
+			{
+				stop_workers(true);
+			}
+		};
+
+		auto reap = [&report_bug, &is_stopping, &is_worker_lost](WorkerProcess& worker)
+		{
+			int status = 0;
+			while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR)
+			{
+			}
+
+			worker.pid = -1;
+			bool exited_normally = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+			if (!exited_normally && !is_stopping)
+			{
+				if (worker.has_pending_iteration)
+				{
+					// The worker crashed in the middle of an iteration, which is how most assertions in
+					// the programs under test manifest.
+					report_bug({});
+				}
+				else
+				{
+					is_worker_lost = true;
+				}
+			}
+
+			worker.is_busy = false;
+			worker.is_stealing = false;
+		};
+
+		// Kills the workers after a failure, and closes their sockets and reaps them, so that no file
+		// descriptors or zombie processes are left behind.
+		auto release_workers = [&workers, &stop_workers, &reap]()
+		{
+			stop_workers(true);
+			for (auto& worker : workers)
+			{
+				if (worker.fd >= 0)
+				{
+					close(worker.fd);
+					worker.fd = -1;
+				}
+
+				if (worker.pid > 0)
+				{
+					reap(worker);
+				}
+			}
+		};
+
+		try
+		{
+			if (num_workers == 0)
+			{
+				throw ErrorCode::Failure;
+			}
+
+			completed_iteration_count = 0;
+			failed_iteration_count = 0;
+			stolen_subtree_count = 0;
+			first_bug_schedule.clear();
+
+			// The first worker starts from the root of the tree.
+			subtrees.push_back({});
+
+			// Flush buffered output, so that the workers do not inherit and print it again.
+			fflush(nullptr);
+
+			for (size_t i = 0; i < num_workers; i++)
+			{
+				int fds[2];
+				if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				pid_t pid = fork();
+				if (pid < 0)
+				{
+					close(fds[0]);
+					close(fds[1]);
+					throw ErrorCode::Failure;
+				}
+				else if (pid == 0)
+				{
+					close(fds[0]);
+					for (auto& worker : workers)
+					{
+						close(worker.fd);
+					}
+
+					int exit_status = run_worker(fds[1], test);
+					fflush(nullptr);
+					_exit(exit_status);
+				}
+
+				close(fds[1]);
+				workers.push_back({ pid, fds[0], false, false, false });
+			}
+
+			std::vector<pollfd> poll_fds;
+			std::vector<WorkerProcess*> polled_workers;
+			uint64_t kind;
+			std::vector<size_t> values;
+			while (true)
+			{
+				if (!is_stopping)
+				{
+					// Assign the queued subtrees to idle workers.
+					size_t idle_worker_count = 0;
+					size_t stealing_worker_count = 0;
+					for (auto& worker : workers)
+					{
+						if (worker.fd >= 0 && !worker.is_busy && !subtrees.empty() &&
+							write_message(worker.fd, EXPLORE_SUBTREE, subtrees.front()))
+						{
+							worker.is_busy = true;
+							subtrees.pop_front();
+						}
+
+						idle_worker_count += worker.fd >= 0 && !worker.is_busy ? 1 : 0;
+						stealing_worker_count += worker.is_stealing ? 1 : 0;
+					}
+
+					// Ask enough busy workers to split their subtrees for the idle workers.
+					for (auto& worker : workers)
+					{
+						if (stealing_worker_count >= idle_worker_count)
+						{
+							break;
+						}
+						else if (worker.fd >= 0 && worker.is_busy && !worker.is_stealing)
+						{
+							worker.is_stealing = write_message(worker.fd, STEAL_SUBTREES, {});
+							stealing_worker_count += 1;
+						}
+					}
+
+					// The workers send the subtrees they split before they report that they are idle, so
+					// the tree is explored once all workers are idle and no subtree is queued.
+					bool is_any_worker_busy = false;
+					for (auto& worker : workers)
+					{
+						is_any_worker_busy = is_any_worker_busy || worker.is_busy;
+					}
+
+					if (!is_any_worker_busy && subtrees.empty())
+					{
+						stop_workers(false);
+					}
+				}
+
+				poll_fds.clear();
+				polled_workers.clear();
+				for (auto& worker : workers)
+				{
+					if (worker.fd >= 0)
+					{
+						poll_fds.push_back({ worker.fd, POLLIN, 0 });
+						polled_workers.push_back(&worker);
+					}
+				}
+
+				if (poll_fds.empty())
+				{
+					break;
+				}
+
+				if (poll(poll_fds.data(), poll_fds.size(), -1) < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+
+					throw ErrorCode::Failure;
+				}
+
+				for (size_t i = 0; i < poll_fds.size(); i++)
+				{
+					if (poll_fds[i].revents == 0)
+					{
+						continue;
+					}
+
+					WorkerProcess& worker = *polled_workers[i];
+					if (!read_message(worker.fd, kind, values))
+					{
+						// The worker has exited.
+						close(worker.fd);
+						worker.fd = -1;
+						reap(worker);
+						continue;
+					}
+
+					if (kind == ITERATION_STARTED)
+					{
+						worker.has_pending_iteration = true;
+					}
+					else if (kind == ITERATION_PASSED)
+					{
+						worker.has_pending_iteration = false;
+						completed_iteration_count += 1;
+					}
+					else if (kind == ITERATION_FAILED)
+					{
+						worker.has_pending_iteration = false;
+						report_bug(values);
+					}
+					else if (kind == SPLIT_SUBTREE)
+					{
+						subtrees.push_back(values);
+						stolen_subtree_count += 1;
+					}
+					else if (kind == STEAL_DONE)
+					{
+						worker.is_stealing = false;
+					}
+					else if (kind == WORKER_IDLE)
+					{
+						worker.is_busy = false;
+					}
+				}
+			}
+
+			if (is_worker_lost)
+			{
+				// A worker failed outside of an iteration, so some subtrees were not explored.
+				throw ErrorCode::Failure;
+			}
+		}
+		catch (ErrorCode error_code)
+		{
+			release_workers();
+			return error_code;
+		}
+		catch (...)
+		{
+			release_workers();
+			return ErrorCode::Failure;
+		}
+
+		return ErrorCode::Success;
+	}
+
+	bool ParallelDFSRunner::bug_found() const noexcept
+	{
+		return failed_iteration_count > 0;
+	}
+
+	const std::vector<size_t>& ParallelDFSRunner::bug_schedule() const noexcept
+	{
+		return first_bug_schedule;
+	}
+
+	size_t ParallelDFSRunner::completed_iterations() const noexcept
+	{
+		return completed_iteration_count;
+	}
+
+	size_t ParallelDFSRunner::failed_iterations() const noexcept
+	{
+		return failed_iteration_count;
+	}
+
+	size_t ParallelDFSRunner::stolen_subtrees() const noexcept
+	{
+		return stolen_subtree_count;
+	}
+}
+
+#endif // !_WIN32
@@ -2,48 +2,103 @@
 // Licensed under the MIT License.
 
 #include "strategies/Exhaustive/dfs_strategy.h"
+#include <algorithm>
 #include <iostream>
 
 constexpr auto FALSE_CHOICE = 0;
 constexpr auto TRUE_CHOICE = 1;
+constexpr auto DEFAULT_MAX_INTEGER_CHOICES = 64;
+
+// The number of scheduling indices, and of enabled operations over all of them, that are preallocated, so
+// that typical iterations do not grow the frame arrays.
+constexpr auto INITIAL_FRAME_CAPACITY = 1024;
+constexpr auto INITIAL_OPERATION_CHOICE_CAPACITY = 4096;
 
 namespace coyote
 {
 
-	DFSStrategy::DFSStrategy() noexcept
+	DFSStrategy::DFSStrategy() noexcept :
+		DFSStrategy((size_t)DEFAULT_MAX_INTEGER_CHOICES)
+	{
+	}
+
+	DFSStrategy::DFSStrategy(size_t max_integer_choices) noexcept :
+		max_integer_choices(max_integer_choices)
 	{
 		this->SchIndex = 0;
-		this->ScheduleStack = new std::map<int, std::stack<size_t>*>();
+		this->ReplayLength = 0;
+		this->PruneIndex = -1;
+		this->frames.reserve(INITIAL_FRAME_CAPACITY);
+		this->operation_choices.reserve(INITIAL_OPERATION_CHOICE_CAPACITY);
 	}
 
-	size_t DFSStrategy::next_choice(std::vector<size_t> choices)
+	// The choices of the prefix have no alternatives, so backtracking ends once it reaches them.
+	DFSStrategy::DFSStrategy(const std::vector<size_t>& prefix) noexcept :
+		DFSStrategy()
 	{
-		std::stack<size_t>* scs;
+		for (size_t choice : prefix)
+		{
+			this->frames.push_back({ 0, choice, false });
+		}
+
+		this->ReplayLength = (int)prefix.size();
+	}
 
-		if (this->SchIndex < this->ScheduleStack->size())
+	// A replayed scheduling index returns the current choice of its frame, so only a new index reads the
+	// enabled operations.
+	size_t DFSStrategy::next_choice(const std::vector<size_t>& choices)
+	{
+		if (this->SchIndex >= (int)this->frames.size())
 		{
-			scs = this->ScheduleStack->find(this->SchIndex)->second;
+			this->frames.push_back({ choices.size() - 1, this->operation_choices.size(), true });
+			this->operation_choices.insert(this->operation_choices.end(), choices.begin(), choices.end());
 		}
-		else
+
+		return current_choice(this->frames[this->SchIndex++]);
+	}
+
+	size_t DFSStrategy::next_choice(size_t count)
+	{
+		if (this->SchIndex >= (int)this->frames.size())
 		{
-			scs = new std::stack<size_t>();
-			for (std::vector<size_t>::iterator rit = choices.begin(); rit != choices.end(); ++rit)
-			{
-				scs->push(size_t(*rit));
-			}
+			this->frames.push_back({ count - 1, 0, false });
+		}
 
-			this->ScheduleStack->insert(std::pair<int, std::stack<size_t>*>(this->SchIndex, scs));
+		return current_choice(this->frames[this->SchIndex++]);
+	}
+
+	size_t DFSStrategy::current_choice(const Frame& frame) const
+	{
+		if (frame.is_operation_choice)
+		{
+			return this->operation_choices[frame.offset + frame.index];
 		}
 
-		size_t nextOperationChoice = scs->top();
+		return frame.offset + frame.index;
+	}
+
+	// The operation choices of the frames are stored in the same order as the frames, so the ones of the
+	// dropped frames are at the end.
+	void DFSStrategy::truncate(size_t index)
+	{
+		for (size_t i = index; i < this->frames.size(); i++)
+		{
+			if (this->frames[i].is_operation_choice)
+			{
+				this->operation_choices.resize(this->frames[i].offset);
+				break;
+			}
+		}
 
-		this->SchIndex++;
-		return nextOperationChoice;
+		if (index < this->frames.size())
+		{
+			this->frames.resize(index);
+		}
 	}
 
 	size_t DFSStrategy::next_operation(Operations& operations)
 	{
-		return next_choice(operations.get_enabled_operation_ids());
+		return next_choice(operations.enabled_operation_ids());
 	}
 
 	size_t DFSStrategy::seed()
@@ -53,10 +108,7 @@ namespace coyote
 
 	bool DFSStrategy::next_boolean()
 	{
-		std::vector<size_t> choices;
-		choices.push_back(FALSE_CHOICE); // False option
-		choices.push_back(TRUE_CHOICE); // True option
-		size_t choice = next_choice(choices);
+		size_t choice = next_choice((size_t)2);
 		if (choice == FALSE_CHOICE)
 		{
 			return false;
@@ -71,41 +123,121 @@ namespace coyote
 		}
 	}
 
+	// The values are enumerated lazily from the frame, so a large 'max_value' costs no memory, but only its
+	// lowest 'max_integer_choices' values are explored.
 	int DFSStrategy::next_integer(int max_value)
 	{
-		std::vector<size_t> choices;
-		for (int i = 0; i < max_value; i++)
+		if (max_value <= 0 || this->max_integer_choices == 0)
 		{
-			choices.push_back((size_t)i);
+			return 0;
 		}
 
-		size_t choice = next_choice(choices);
+		size_t choice = next_choice(std::min((size_t)max_value, this->max_integer_choices));
 		return (int)choice;
 	}
 
-	// prepare_next_iteration() traverses the 'ScheduleStack' in reverse.
-	// For a given program point 'i', we pop the last processed operation (or) boolean (or) integer from ScheduleStack[i].
-	// We break the loop if ScheduleStack[i] is non - empty after the pop,
-	// since it implies we have not explored other paths in this level ('i') fully.
+	// The replayed prefix revisits the states of the previous iteration on the same path, so only a known
+	// state that is reached after the first new choice is pruned. Its subtree was explored from the iteration
+	// that first reached it, or is being explored if the state repeats within one path.
+	void DFSStrategy::visit_known_state()
+	{
+		if (this->SchIndex >= this->ReplayLength && this->PruneIndex < 0)
+		{
+			this->PruneIndex = this->SchIndex;
+		}
+	}
+
+	// prepare_next_iteration() first drops the frames that follow a pruned scheduling index, since they
+	// only lead to known states, and then traverses the frames in reverse. For a given program point 'i',
+	// it moves to the previous choice of frames[i] if it has one, and otherwise drops the frame, since every
+	// path from this level ('i') is explored.
 	void DFSStrategy::prepare_next_iteration()
 	{
 		this->SchIndex = 0;
 
-		int ScheduleStackSize = (int)this->ScheduleStack->size();
-		for (int i = (ScheduleStackSize - 1); i >= 0; i--)
+		if (this->PruneIndex >= 0)
+		{
+			truncate((size_t)this->PruneIndex);
+			this->PruneIndex = -1;
+		}
+
+		while (!this->frames.empty())
 		{
-			std::map<int, std::stack<size_t>*>::iterator it = this->ScheduleStack->find(i);
-			std::stack<size_t>* s_scs = it->second;
-			s_scs->pop();
-			if (s_scs->size() == 0)
+			Frame& frame = this->frames.back();
+			if (frame.index > 0)
 			{
-				this->ScheduleStack->erase(it);
+				frame.index--;
+				break;
 			}
-			else
+
+			truncate(this->frames.size() - 1);
+		}
+
+		this->ReplayLength = (int)this->frames.size();
+	}
+
+	// The next iteration backtracks to the deepest scheduling index with a choice left, ignoring the indices
+	// that follow a pruned one, so the tree is exhausted if there is no such index.
+	bool DFSStrategy::is_exhausted() const
+	{
+		for (size_t i = 0; i < this->frames.size(); i++)
+		{
+			if (this->PruneIndex >= 0 && i >= (size_t)this->PruneIndex)
+			{
+				break;
+			}
+			else if (this->frames[i].index > 0)
 			{
-				return;
+				return false;
 			}
 		}
+
+		return true;
+	}
+
+	std::vector<size_t> DFSStrategy::current_schedule() const
+	{
+		std::vector<size_t> schedule;
+		for (const Frame& frame : this->frames)
+		{
+			schedule.push_back(current_choice(frame));
+		}
+
+		return schedule;
+	}
+
+	// The choices below the current one of a frame are explored after the subtree of the current one, so
+	// handing them off only changes which explorer runs their subtrees. The shallowest frame has the largest
+	// subtrees. The frame keeps only its current choice, by moving its offset to it.
+	std::vector<std::vector<size_t>> DFSStrategy::split_subtrees()
+	{
+		std::vector<std::vector<size_t>> prefixes;
+		std::vector<size_t> prefix;
+		for (size_t i = 0; i < this->frames.size(); i++)
+		{
+			if (this->PruneIndex >= 0 && i >= (size_t)this->PruneIndex)
+			{
+				break;
+			}
+
+			Frame& frame = this->frames[i];
+			if (frame.index > 0)
+			{
+				for (size_t index = frame.index; index > 0; index--)
+				{
+					prefixes.push_back(prefix);
+					prefixes.back().push_back(current_choice({ index - 1, frame.offset, frame.is_operation_choice }));
+				}
+
+				frame.offset += frame.index;
+				frame.index = 0;
+				break;
+			}
+
+			prefix.push_back(current_choice(frame));
+		}
+
+		return prefixes;
 	}
 
 	bool DFSStrategy::is_fair()
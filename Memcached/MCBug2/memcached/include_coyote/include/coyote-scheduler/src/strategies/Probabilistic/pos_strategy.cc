@@ -0,0 +1,109 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "strategies/Probabilistic/pos_strategy.h"
+
+namespace coyote
+{
+	POSStrategy::POSStrategy(size_t seed) noexcept :
+		generator(seed),
+		iteration_seed(seed),
+		operation_slots(nullptr)
+	{
+	}
+
+	size_t POSStrategy::next_operation(Operations& operations)
+	{
+		const std::vector<size_t>& ops = operations.enabled_operation_ids();
+		size_t next_id = ops.front();
+		uint64_t highest_priority = pending_step(next_id).priority;
+		for (size_t i = 1; i < ops.size(); i++)
+		{
+			const uint64_t step_priority = pending_step(ops[i]).priority;
+			if (step_priority > highest_priority)
+			{
+				next_id = ops[i];
+				highest_priority = step_priority;
+			}
+		}
+
+		// The scheduled step is taken, so the steps that race with it get a new priority, including the
+		// steps of disabled operations.
+		const size_t next_slot = this->operation_slots->find(next_id)->second;
+		const StepAccess access = this->pending_steps[next_slot].access;
+		for (size_t slot = 0; slot < this->pending_steps.size(); slot++)
+		{
+			if (slot != next_slot && !access.is_independent(this->pending_steps[slot].access))
+			{
+				this->pending_steps[slot].priority = this->generator.next();
+			}
+		}
+
+		// The next step of the scheduled operation is new, and accesses anything until it declares its access.
+		this->pending_steps[next_slot] = { this->generator.next(), StepAccess{ false, 0, false } };
+		return next_id;
+	}
+
+	void POSStrategy::declare_access(size_t operation_id, const StepAccess& access)
+	{
+		pending_step(operation_id).access = access;
+	}
+
+	// The elided steps were taken without declaring their accesses, so they race with every pending step of
+	// the disabled operations, which get a new priority, as does the next step of the operation that took them.
+	void POSStrategy::skip_steps(size_t /*operation_id*/, size_t /*count*/)
+	{
+		for (PendingStep& step : this->pending_steps)
+		{
+			step.priority = this->generator.next();
+		}
+	}
+
+	size_t POSStrategy::seed()
+	{
+		return this->iteration_seed;
+	}
+
+	bool POSStrategy::reseed(size_t seed)
+	{
+		this->iteration_seed = seed;
+		this->generator.seed(this->iteration_seed);
+		return true;
+	}
+
+	void POSStrategy::prepare_next_iteration()
+	{
+		this->iteration_seed += 1;
+		this->generator.seed(this->iteration_seed);
+		this->operation_slots = nullptr;
+		this->arena.reset();
+		this->pending_steps.clear();
+	}
+
+	bool POSStrategy::is_fair()
+	{
+		return false;
+	}
+
+	std::string POSStrategy::get_description()
+	{
+		return "POS Strategy.";
+	}
+
+	POSStrategy::PendingStep& POSStrategy::pending_step(size_t operation_id)
+	{
+		if (this->operation_slots == nullptr)
+		{
+			this->operation_slots = this->arena.create<SlotMap>(SlotMap::allocator_type(this->arena));
+		}
+
+		auto it = this->operation_slots->find(operation_id);
+		if (it == this->operation_slots->end())
+		{
+			it = this->operation_slots->emplace(operation_id, this->pending_steps.size()).first;
+			this->pending_steps.push_back({ this->generator.next(), StepAccess{ false, 0, false } });
+		}
+
+		return this->pending_steps[it->second];
+	}
+}
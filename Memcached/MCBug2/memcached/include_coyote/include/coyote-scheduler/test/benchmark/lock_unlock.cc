@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <vector>
+#include "test.h"
+#include "coyote/handoff/fiber_handoff.h"
+
+using namespace coyote;
+
+// Total number of lock/unlock pairs that each configuration performs, split across its operations.
+constexpr size_t TOTAL_PAIRS = 400000;
+
+// Number of mocked locks, which each get their own resource id.
+constexpr size_t NUM_LOCKS = 64;
+
+Scheduler* scheduler;
+
+size_t pairs_per_operation;
+size_t locks_per_operation;
+bool is_locked[NUM_LOCKS];
+
+// Mirrors how the C FFI models 'pthread_mutex_lock'.
+void mock_lock(size_t lock_id)
+{
+	scheduler->schedule_next();
+	while (is_locked[lock_id])
+	{
+		scheduler->wait_resource(lock_id);
+	}
+
+	is_locked[lock_id] = true;
+}
+
+// Mirrors how the C FFI models 'pthread_mutex_unlock'.
+void mock_unlock(size_t lock_id)
+{
+	scheduler->schedule_next();
+	is_locked[lock_id] = false;
+	scheduler->signal_resource(lock_id);
+}
+
+void run_pairs(size_t id)
+{
+	for (size_t i = 0; i < pairs_per_operation; i++)
+	{
+		size_t lock_id = (id * 7 + i) % locks_per_operation;
+		mock_lock(lock_id);
+		mock_unlock(lock_id);
+	}
+}
+
+void fiber_work(void* arg)
+{
+	run_pairs(*static_cast<size_t*>(arg));
+}
+
+void run(size_t num_operations, size_t num_locks)
+{
+	scheduler = new Scheduler((size_t)42);
+	if (num_operations > 1)
+	{
+		assert(scheduler->set_handoff_engine(std::make_unique<FiberHandoff>()), ErrorCode::Success);
+	}
+
+	pairs_per_operation = TOTAL_PAIRS / num_operations;
+	locks_per_operation = num_locks;
+
+	auto start_time = std::chrono::steady_clock::now();
+	scheduler->attach();
+	for (size_t i = 0; i < NUM_LOCKS; i++)
+	{
+		is_locked[i] = false;
+		scheduler->create_resource(i);
+	}
+
+	if (num_operations == 1)
+	{
+		run_pairs(0);
+	}
+	else
+	{
+		std::vector<size_t> ids(num_operations + 1);
+		for (size_t i = 1; i <= num_operations; i++)
+		{
+			ids[i] = i;
+			scheduler->create_operation(i, fiber_work, &ids[i]);
+		}
+
+		for (size_t i = 1; i <= num_operations; i++)
+		{
+			scheduler->join_operation(i);
+		}
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+
+	auto end_time = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+	std::cout << "[benchmark] " << num_operations << " operations, " << num_locks << " locks: " <<
+		(size_t)(pairs_per_operation * num_operations / seconds) << " lock/unlock pairs/sec." << std::endl;
+	delete scheduler;
+}
+
+// Measures how many mocked mutex lock/unlock pairs per second the scheduler sustains. A single operation
+// measures the uncontended path, and multiple fiber operations measure the path where operations block on
+// and signal the resources of contended locks.
+int main()
+{
+	std::cout << "[benchmark] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		run(1, NUM_LOCKS);
+		for (size_t num_operations = 2; num_operations <= 16; num_operations *= 2)
+		{
+			run(num_operations, 4);
+			run(num_operations, NUM_LOCKS);
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[benchmark] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[benchmark] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
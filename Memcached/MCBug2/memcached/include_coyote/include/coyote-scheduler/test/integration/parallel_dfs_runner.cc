@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <unistd.h>
+#include "test.h"
+#include "coyote/runners/parallel_dfs_runner.h"
+
+using namespace coyote;
+
+constexpr auto NUM_WORK_THREADS = 5;
+constexpr auto NUM_WORKERS = 4;
+
+BasicScheduler<DFSStrategy>* scheduler;
+
+// The order in which the operations ran in the current iteration.
+std::string curr_trace;
+
+int shared_var;
+
+bool is_racy;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	curr_trace += std::to_string(id);
+	if (is_racy && id <= 2)
+	{
+		int value = shared_var;
+		scheduler->schedule_next();
+		shared_var = value + 1;
+	}
+
+	scheduler->complete_operation(id);
+}
+
+// Runs the operations, and returns false if the racy operations lost an increment.
+bool run_iteration(BasicScheduler<DFSStrategy>& iteration_scheduler)
+{
+	scheduler = &iteration_scheduler;
+	curr_trace.clear();
+	shared_var = 0;
+
+	std::thread threads[NUM_WORK_THREADS];
+	for (size_t id = 1; id <= NUM_WORK_THREADS; id++)
+	{
+		scheduler->create_operation(id);
+		threads[id - 1] = std::thread(work, id);
+	}
+
+	scheduler->schedule_next();
+	for (size_t id = 1; id <= NUM_WORK_THREADS; id++)
+	{
+		scheduler->join_operation(id);
+		threads[id - 1].join();
+	}
+
+	return !is_racy || shared_var == 2;
+}
+
+// Explores the schedules in this process, and returns the traces of the iterations in 'traces'.
+size_t explore_sequentially(std::multiset<std::string>& traces, size_t& bug_count)
+{
+	auto strategy = std::make_unique<DFSStrategy>();
+	DFSStrategy* dfs = strategy.get();
+	BasicScheduler<DFSStrategy> sequential_scheduler(std::move(strategy));
+
+	size_t iterations = 0;
+	bug_count = 0;
+	do
+	{
+		sequential_scheduler.attach();
+		bug_count += run_iteration(sequential_scheduler) ? 0 : 1;
+		sequential_scheduler.detach();
+		assert(sequential_scheduler.error_code(), ErrorCode::Success);
+		traces.insert(curr_trace);
+		iterations++;
+	} while (!dfs->is_exhausted());
+
+	return iterations;
+}
+
+void test_coverage()
+{
+	is_racy = false;
+	std::multiset<std::string> sequential_traces;
+	size_t bug_count = 0;
+	const size_t iterations = explore_sequentially(sequential_traces, bug_count);
+	assert(std::set<std::string>(sequential_traces.begin(), sequential_traces.end()).size() == 120,
+		"DFS did not cover every order of the operations.");
+
+	// The workers append the trace of each iteration to a shared file, in lines that are written atomically.
+	char path[] = "/tmp/coyote_parallel_dfs_XXXXXX";
+	int fd = mkstemp(path);
+	assert(fd >= 0, "could not create the trace file.");
+	close(fd);
+	fd = open(path, O_WRONLY | O_APPEND);
+
+	ParallelDFSRunner runner(NUM_WORKERS, false);
+	assert(runner.run([fd](BasicScheduler<DFSStrategy>& worker_scheduler) {
+		const bool passed = run_iteration(worker_scheduler);
+		const std::string line = curr_trace + "\n";
+		return write(fd, line.data(), line.size()) == (ssize_t)line.size() && passed;
+	}), ErrorCode::Success);
+	close(fd);
+
+	std::multiset<std::string> parallel_traces;
+	std::ifstream file(path);
+	for (std::string line; std::getline(file, line);)
+	{
+		parallel_traces.insert(line);
+	}
+
+	remove(path);
+
+	std::cout << "[test] explored " << runner.completed_iterations() << " schedules with " << NUM_WORKERS <<
+		" workers, which stole " << runner.stolen_subtrees() << " subtrees." << std::endl;
+	assert(!runner.bug_found(), "found a bug in a correct run.");
+	assert(runner.completed_iterations() == iterations, "the workers did not explore every schedule once.");
+	assert(parallel_traces == sequential_traces, "the workers did not explore the schedules of sequential DFS.");
+	assert(runner.stolen_subtrees() > 0, "the idle workers did not steal any subtree.");
+}
+
+void test_bug_schedule()
+{
+	is_racy = true;
+	std::multiset<std::string> sequential_traces;
+	size_t bug_count = 0;
+	const size_t iterations = explore_sequentially(sequential_traces, bug_count);
+	assert(bug_count > 0, "DFS did not find the race.");
+
+	ParallelDFSRunner runner(NUM_WORKERS, false);
+	assert(runner.run(run_iteration), ErrorCode::Success);
+	assert(runner.failed_iterations() == bug_count, "the workers did not find every racy schedule.");
+	assert(runner.completed_iterations() + runner.failed_iterations() == iterations,
+		"the workers did not explore every schedule once.");
+
+	// The schedule of the bug reproduces the race.
+	BasicScheduler<DFSStrategy> replay_scheduler(std::make_unique<DFSStrategy>(runner.bug_schedule()));
+	replay_scheduler.attach();
+	const bool passed = run_iteration(replay_scheduler);
+	replay_scheduler.detach();
+	assert(!passed, "the schedule of the bug did not reproduce the race.");
+
+	ParallelDFSRunner stopping_runner(NUM_WORKERS, true);
+	assert(stopping_runner.run(run_iteration), ErrorCode::Success);
+	assert(stopping_runner.bug_found(), "the workers did not find the race.");
+	assert(stopping_runner.completed_iterations() + stopping_runner.failed_iterations() < iterations,
+		"the workers did not stop at the first bug.");
+
+	assert(ParallelDFSRunner(0, false).run(run_iteration), ErrorCode::Failure);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_coverage();
+		test_bug_schedule();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
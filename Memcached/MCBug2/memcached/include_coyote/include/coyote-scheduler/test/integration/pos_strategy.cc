@@ -0,0 +1,133 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 10;
+constexpr auto NUM_ITERATIONS = 1000;
+constexpr auto FIRST_SEED = 1000;
+
+Scheduler* scheduler;
+
+// The counter that only the first operation increments.
+int counter;
+
+// The flag that the first operation sets after its increments, and that the second operation reads.
+bool is_done;
+
+// True if the second operation read the flag after the first operation set it, else false.
+bool is_done_observed;
+
+void work_1()
+{
+	scheduler->start_operation(WORK_THREAD_1_ID);
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		scheduler->schedule_next((size_t)&counter, true);
+		counter++;
+	}
+
+	scheduler->schedule_next((size_t)&is_done, true);
+	is_done = true;
+	scheduler->complete_operation(WORK_THREAD_1_ID);
+}
+
+void work_2()
+{
+	scheduler->start_operation(WORK_THREAD_2_ID);
+	scheduler->schedule_next((size_t)&is_done, false);
+	is_done_observed = is_done;
+	scheduler->complete_operation(WORK_THREAD_2_ID);
+}
+
+void run_iteration()
+{
+	counter = 0;
+	is_done = false;
+	is_done_observed = false;
+
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work_1);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work_2);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+// Returns the number of iterations in which the read of the flag is ordered after its write.
+size_t count_late_reads()
+{
+	size_t count = 0;
+	for (int i = 0; i < NUM_ITERATIONS; i++)
+	{
+		run_iteration();
+		count += is_done_observed ? 1 : 0;
+	}
+
+	delete scheduler;
+	return count;
+}
+
+// The read of the flag only races with its write, so POS orders it after the write with a probability of
+// about 1 / (NUM_STEPS + 1), while a random walk has to schedule the first operation at each of its steps.
+void test_late_read()
+{
+	scheduler = new Scheduler((size_t)FIRST_SEED);
+	const size_t random_count = count_late_reads();
+
+	scheduler = new Scheduler(std::make_unique<POSStrategy>((size_t)FIRST_SEED));
+	const size_t pos_count = count_late_reads();
+
+	std::cout << "[test] read the flag after its write in " << random_count << " random and " << pos_count <<
+		" POS iterations." << std::endl;
+	assert(pos_count > NUM_ITERATIONS / (4 * (NUM_STEPS + 1)), "POS rarely ordered the read after the write.");
+	assert(pos_count > 10 * random_count, "POS did not order the read after the write more often than random.");
+}
+
+void test_replay_seed()
+{
+	scheduler = new Scheduler(std::make_unique<POSStrategy>((size_t)FIRST_SEED));
+	run_iteration();
+	const bool first_observed = is_done_observed;
+	const size_t first_seed = scheduler->seed();
+	delete scheduler;
+
+	scheduler = new Scheduler(std::make_unique<POSStrategy>(first_seed));
+	run_iteration();
+	assert(is_done_observed == first_observed, "the seed did not reproduce the iteration.");
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_late_read();
+		test_replay_seed();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
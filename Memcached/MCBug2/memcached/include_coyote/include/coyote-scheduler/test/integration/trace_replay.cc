@@ -0,0 +1,279 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto WORK_THREAD_3_ID = 3;
+
+// Number of steps that each operation takes.
+constexpr auto NUM_STEPS = 3;
+
+// Number of scheduling points that the main operation passes before creating any operation.
+constexpr auto NUM_SOLO_STEPS = 10;
+
+// Path of the trace file that the test records and replays.
+const std::string TRACE_PATH = "trace_replay.cyt";
+
+// Path of the file that passes the recorded iteration between processes.
+const std::string RESULT_PATH = "trace_replay.out";
+
+Scheduler* scheduler;
+
+// The decisions observed by the current iteration.
+std::string curr_trace;
+
+// Number of operations created in the current iteration, reset at attach like the memcached harness.
+size_t operation_count;
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	for (int i = 0; i < NUM_STEPS; i++)
+	{
+		curr_trace += std::to_string(operation_id);
+		curr_trace += scheduler->next_boolean() ? "T" : "F";
+		curr_trace += std::to_string(scheduler->next_integer(3));
+		scheduler->schedule_next();
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+std::string run_iteration()
+{
+	curr_trace = "";
+	scheduler->attach();
+
+	for (int i = 0; i < NUM_SOLO_STEPS; i++)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->create_operation(WORK_THREAD_3_ID);
+	std::thread t3(work, WORK_THREAD_3_ID);
+
+	scheduler->schedule_next();
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	scheduler->join_operation(WORK_THREAD_3_ID);
+	t1.join();
+	t2.join();
+	t3.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return curr_trace;
+}
+
+// Replays the trace file, and checks that it reproduces the recorded iteration.
+void replay(const std::string& recorded_trace, bool is_elision_enabled)
+{
+	Scheduler* recording_scheduler = scheduler;
+	scheduler = new Scheduler(std::make_unique<ReplayStrategy>(TRACE_PATH));
+	assert(scheduler->set_scheduling_elision(is_elision_enabled), ErrorCode::Success);
+
+	// Each iteration replays the trace from its start.
+	for (int i = 0; i < 2; i++)
+	{
+		assert(run_iteration() == recorded_trace, "replayed iteration differs from the recorded one.");
+	}
+
+	delete scheduler;
+	scheduler = recording_scheduler;
+}
+
+void test(Scheduler* new_scheduler)
+{
+	scheduler = new_scheduler;
+	assert(scheduler->record_trace(TRACE_PATH), ErrorCode::Success);
+
+	for (int i = 0; i < 10; i++)
+	{
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+		// The trace is readable while the recording scheduler is still alive.
+		std::string recorded_trace = run_iteration();
+		replay(recorded_trace, false);
+		replay(recorded_trace, true);
+	}
+
+	scheduler->attach();
+	assert(scheduler->record_trace(TRACE_PATH), ErrorCode::ClientAttached);
+	delete scheduler;
+}
+
+// Checks that replaying the trace against a different program reports the divergence.
+void test_divergence()
+{
+	scheduler = new Scheduler((size_t)42);
+	assert(scheduler->record_trace(TRACE_PATH), ErrorCode::Success);
+	scheduler->attach();
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+	scheduler->next_boolean();
+	scheduler->schedule_next();
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	t1.join();
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	delete scheduler;
+
+	// The program asks for an integer where the trace holds a boolean.
+	scheduler = new Scheduler(std::make_unique<ReplayStrategy>(TRACE_PATH));
+	scheduler->attach();
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t2(work, WORK_THREAD_1_ID);
+	scheduler->next_integer(2);
+	assert(scheduler->schedule_next(), ErrorCode::ReplayDiverged);
+	scheduler->detach();
+	t2.join();
+	delete scheduler;
+}
+
+// Runs an iteration whose operation ids come from a counter that restarts at attach.
+std::string run_counted_iteration()
+{
+	curr_trace = "";
+	scheduler->attach();
+	operation_count = 0;
+
+	std::vector<std::thread> threads;
+	for (int i = 0; i < 3; i++)
+	{
+		size_t operation_id = ++operation_count;
+		scheduler->create_operation(operation_id);
+		threads.emplace_back(work, operation_id);
+	}
+
+	scheduler->schedule_next();
+
+	for (size_t operation_id = 1; operation_id <= operation_count; operation_id++)
+	{
+		scheduler->join_operation(operation_id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return curr_trace;
+}
+
+// Runs the body in a child process, and returns whether it exited without failing.
+template<typename Body>
+bool run_in_child(Body body)
+{
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		int status = 0;
+		try
+		{
+			body();
+		}
+		catch (std::string error)
+		{
+			std::cout << "[test] child failed: " << error << std::endl;
+			status = 1;
+		}
+
+		_exit(status);
+	}
+
+	int status = 0;
+	return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// Records the last of several iterations in one process, and replays it in another.
+void test_replay_in_new_process()
+{
+	bool is_recorded = run_in_child([]() {
+		scheduler = new Scheduler((size_t)42);
+		assert(scheduler->record_trace(TRACE_PATH), ErrorCode::Success);
+
+		std::string recorded_trace;
+		for (int i = 0; i < 5; i++)
+		{
+			recorded_trace = run_counted_iteration();
+		}
+
+		delete scheduler;
+		std::ofstream(RESULT_PATH) << recorded_trace;
+	});
+
+	assert(is_recorded, "recording process failed.");
+
+	bool is_replayed = run_in_child([]() {
+		std::string recorded_trace;
+		std::ifstream(RESULT_PATH) >> recorded_trace;
+		assert(!recorded_trace.empty(), "recording process did not write the iteration.");
+
+		scheduler = new Scheduler(std::make_unique<ReplayStrategy>(TRACE_PATH));
+		assert(run_counted_iteration() == recorded_trace, "replayed iteration differs from the recorded one.");
+		delete scheduler;
+	});
+
+	std::remove(RESULT_PATH.c_str());
+	assert(is_replayed, "replaying process failed.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test(new Scheduler((size_t)42));
+		test(new Scheduler("ProbabilisticRandomStrategy"));
+		test(new Scheduler("PCTStrategy"));
+		test(new Scheduler("DFSStrategy"));
+		test(new Scheduler("FairPCTStrategy", 10));
+		test_divergence();
+		test_replay_in_new_process();
+
+		bool is_missing_trace_rejected = false;
+		try
+		{
+			ReplayStrategy strategy("missing_trace.cyt");
+		}
+		catch (ErrorCode error_code)
+		{
+			is_missing_trace_rejected = error_code == ErrorCode::Failure;
+		}
+
+		assert(is_missing_trace_rejected, "missing trace file was not rejected.");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		std::remove(TRACE_PATH.c_str());
+		return 1;
+	}
+
+	std::remove(TRACE_PATH.c_str());
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <set>
+#include "test.h"
+#include "coyote/operations/operations.h"
+
+using namespace coyote;
+
+constexpr auto NUM_OPERATIONS = 3;
+constexpr auto NUM_CHANGE_POINTS = 2;
+constexpr auto NUM_STEPS = 1000000;
+constexpr auto NUM_ITERATIONS = 20;
+
+// Schedules the operations for the specified number of steps while they stay enabled, and returns the
+// number of times that the scheduled operation changed.
+size_t run_iteration(PCTStrategy& strategy, Operations& ops, std::set<size_t>& first_operations)
+{
+	size_t switch_count = 0;
+	size_t previous_id = strategy.next_operation(ops);
+	first_operations.insert(previous_id);
+	for (int step = 1; step < NUM_STEPS; step++)
+	{
+		const size_t operation_id = strategy.next_operation(ops);
+		switch_count += operation_id != previous_id ? 1 : 0;
+		previous_id = operation_id;
+	}
+
+	strategy.prepare_next_iteration();
+	return switch_count;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		Operations ops;
+		for (size_t id = 1; id <= NUM_OPERATIONS; id++)
+		{
+			ops.insert(id);
+		}
+
+		PCTStrategy strategy(NUM_CHANGE_POINTS);
+		std::set<size_t> first_operations;
+
+		// The first iteration has no change points, so the highest priority operation runs throughout.
+		assert(run_iteration(strategy, ops, first_operations) == 0, "switched operations without a change point.");
+
+		// Otherwise, the scheduled operation only changes at a change point.
+		size_t switch_count = 0;
+		for (int i = 1; i < NUM_ITERATIONS; i++)
+		{
+			const size_t iteration_switch_count = run_iteration(strategy, ops, first_operations);
+			assert(iteration_switch_count <= NUM_CHANGE_POINTS, "switched operations more often than the change points.");
+			switch_count += iteration_switch_count;
+		}
+
+		assert(switch_count > 0, "did not reach a change point.");
+		assert(first_operations.size() == NUM_OPERATIONS, "did not give every operation the highest priority.");
+
+		// An operation that is the only enabled one on a change point moves the change point forward.
+		ops.disable(2);
+		ops.disable(3);
+		for (int step = 0; step < NUM_STEPS / 2; step++)
+		{
+			assert(strategy.next_operation(ops) == 1, "scheduled a disabled operation.");
+		}
+
+		ops.enable(2);
+		ops.enable(3);
+		size_t previous_id = strategy.next_operation(ops);
+		size_t late_switch_count = 0;
+		for (int step = NUM_STEPS / 2 + 1; step < NUM_STEPS; step++)
+		{
+			const size_t operation_id = strategy.next_operation(ops);
+			late_switch_count += operation_id != previous_id ? 1 : 0;
+			previous_id = operation_id;
+		}
+
+		assert(late_switch_count > 0, "lost the change points of the steps with a single enabled operation.");
+		assert(late_switch_count <= NUM_CHANGE_POINTS, "switched operations more often than the change points.");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_BATON_HANDOFF_H
+#define COYOTE_BATON_HANDOFF_H
+
+#include <condition_variable>
+#include "handoff_engine.h"
+
+namespace coyote
+{
+	// Passes a baton directly from the current operation to the next one. The scheduler mutex is
+	// released before the next thread is woken, so the woken thread never contends with the thread
+	// that woke it, and only the thread that was scheduled is ever woken. Batons belong to the slots of
+	// the operation table, so on detach the engine waits for the threads of the canceled operations to
+	// leave their batons before the next iteration can reuse them.
+	class BatonHandoff : public HandoffEngine
+	{
+	private:
+		// Number of threads that released the scheduler mutex to wait on a baton, and have not yet
+		// reacquired it.
+		size_t parked_thread_count;
+
+		// Notified when the last parked thread reacquires the scheduler mutex.
+		std::condition_variable unparked_cv;
+
+	public:
+		BatonHandoff() noexcept;
+
+		BatonHandoff(BatonHandoff&& engine) = delete;
+		BatonHandoff(BatonHandoff const&) = delete;
+
+		BatonHandoff& operator=(BatonHandoff&& engine) = delete;
+		BatonHandoff& operator=(BatonHandoff const&) = delete;
+
+		void wait(Operation& op, std::unique_lock<std::mutex>& lock);
+		void notify(Operation& op);
+		void handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& lock);
+		void reset(std::unique_lock<std::mutex>& lock);
+		std::string get_description();
+
+	private:
+		// Invoked by a parked thread once it has reacquired the scheduler mutex.
+		void unpark();
+	};
+}
+
+#endif // COYOTE_BATON_HANDOFF_H
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PARALLEL_DFS_RUNNER_H
+#define COYOTE_PARALLEL_DFS_RUNNER_H
+
+#if !defined(_WIN32)
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "../error_code.h"
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// Explores every schedule of a test with 'DFSStrategy' across forked worker processes, which share the
+	// tree of schedules by work stealing. Each worker explores the subtree of a schedule prefix that the
+	// runner assigns to it. Whenever a worker is idle and no subtree is queued, the runner asks a busy worker
+	// to split off the unexplored choices of its shallowest scheduling index, and queues their subtrees.
+	// Together, the workers explore the same schedules as a single 'DFSStrategy'. The runner must be used
+	// from a process that has not yet started any other threads.
+	class ParallelDFSRunner
+	{
+	private:
+		// The number of worker processes.
+		const size_t num_workers;
+
+		// True if the runner stops all workers after the first iteration that finds a bug, else false.
+		const bool stop_on_first_bug;
+
+		// The number of iterations that completed without finding a bug.
+		size_t completed_iteration_count;
+
+		// The number of iterations that found a bug.
+		size_t failed_iteration_count;
+
+		// The number of subtrees that idle workers stole from busy ones.
+		size_t stolen_subtree_count;
+
+		// The choices of the first iteration that found a bug, or empty if its worker crashed before
+		// reporting them.
+		std::vector<size_t> first_bug_schedule;
+
+	public:
+		ParallelDFSRunner(size_t num_workers, bool stop_on_first_bug) noexcept;
+
+		ParallelDFSRunner(ParallelDFSRunner&& runner) = delete;
+		ParallelDFSRunner(ParallelDFSRunner const&) = delete;
+
+		ParallelDFSRunner& operator=(ParallelDFSRunner&& runner) = delete;
+		ParallelDFSRunner& operator=(ParallelDFSRunner const&) = delete;
+
+		// Forks the worker processes, and explores the schedules of the specified test until every subtree
+		// is explored, and waits until all workers exit. Each iteration attaches to the scheduler of its
+		// worker, runs the test, and detaches. The test returns false if it found a bug, and an iteration
+		// also finds a bug if the scheduler reports an error or the worker crashes. The subtree of a worker
+		// that crashes is not explored further.
+		ErrorCode run(std::function<bool(BasicScheduler<DFSStrategy>&)> test) noexcept;
+
+		// Returns true if an iteration found a bug, else false.
+		bool bug_found() const noexcept;
+
+		// Returns the choices of the first iteration that found a bug, which the first iteration of
+		// 'DFSStrategy(prefix)' replays.
+		const std::vector<size_t>& bug_schedule() const noexcept;
+
+		// Returns the number of iterations that completed without finding a bug.
+		size_t completed_iterations() const noexcept;
+
+		// Returns the number of iterations that found a bug.
+		size_t failed_iterations() const noexcept;
+
+		// Returns the number of subtrees that idle workers stole from busy ones.
+		size_t stolen_subtrees() const noexcept;
+	};
+}
+
+#endif // !_WIN32
+
+#endif // COYOTE_PARALLEL_DFS_RUNNER_H
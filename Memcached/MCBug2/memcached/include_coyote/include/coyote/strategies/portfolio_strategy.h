@@ -10,104 +10,135 @@
 #include "Probabilistic/random_strategy.h"
 #include "Probabilistic/pct_strategy.h"
 #include "Probabilistic/probabilistic_random.h"
-
-//#define DEBUG_PORTFOLIO_STRATEGY
-
-#ifdef DEBUG_PORTFOLIO_STRATEGY
-#include <iostream>
-#endif
+#include <memory>
+#include <vector>
 
 namespace coyote
 {
+	// Runs each iteration with one of a portfolio of strategies, and allocates the iterations to the strategies
+	// by their yield, as a multi-armed bandit. An iteration is rewarded with 1 if it finds a bug, and else with
+	// the fraction of the program states that it reported that were new. The strategy of each iteration is the
+	// one with the highest UCB1 score, which is its mean reward plus a bonus that shrinks as it runs more
+	// iterations, so the productive strategies get most iterations while the others are still retried. Each
+	// strategy runs once first, and without any reward the strategies take turns in round-robin order.
 	class PortfolioStrategy : public Strategy
 	{
 	private:
-		Strategy* random;
-		Strategy* probabilistic_random;
-		Strategy* fair_pct;
+		// A strategy of the portfolio, with the rewards of its iterations.
+		struct Arm
+		{
+			std::unique_ptr<Strategy> strategy;
+
+			// The number of iterations that the strategy ran.
+			size_t iterations;
+
+			// The sum of the rewards of its iterations.
+			double total_reward;
+		};
+
+		// The strategies of the portfolio.
+		std::vector<Arm> arms;
+
+		// The index of the strategy of the current iteration.
+		size_t current_arm;
+
+		// The fair PCT strategy of the default portfolio, whose prefix length follows the schedule length, or
+		// null if the strategies were specified.
+		ComboStrategy* fair_pct;
 
-		// Which strategy to use in this iteration
-		Strategy* current_strategy;
-		// This should be between 0 and 2 (inclusive)
-		short unsigned int iteration_counter;
+		// The number of scheduling steps of the current iteration.
+		size_t scheduled_steps;
+
+		// The mean number of scheduling steps of the iterations that took any.
+		double mean_schedule_length;
+
+		// The number of iterations that took any scheduling step.
+		size_t scheduled_iterations;
+
+		// The number of new and known program states that the current iteration reported.
+		size_t new_state_count;
+		size_t known_state_count;
+
+		// True if the current iteration found a bug, else false.
+		bool is_bug_found;
+
+		// Returns the reward of the current iteration, between 0 and 1.
+		double iteration_reward() const;
+
+		// Returns the index of the strategy with the highest UCB1 score.
+		size_t select_arm() const;
 
 	public:
+		// Uses random, fair PCT and probabilistic random strategies. The fair PCT strategy runs PCT for as many
+		// steps as the mean schedule length observed so far, and then a random strategy.
+		PortfolioStrategy();
 
-		PortfolioStrategy()
-		{
+		// Uses the specified strategies, and takes ownership of them.
+		explicit PortfolioStrategy(std::vector<std::unique_ptr<Strategy>> strategies);
 
-#ifdef DEBUG_PORTFOLIO_STRATEGY
-			std::cout<<"Portfolio initialized"<<std::endl;
-#endif
-			random = new RandomStrategy(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-			probabilistic_random = new ProbabilisticRandomStrategy(std::chrono::high_resolution_clock::now().time_since_epoch().count());
-			fair_pct = new ComboStrategy("PCTStrategy", "RandomStrategy", 1000);
+		PortfolioStrategy(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy(PortfolioStrategy const&) = delete;
 
-			current_strategy = random;
-			iteration_counter = 0;
-		}
+		PortfolioStrategy& operator=(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy& operator=(PortfolioStrategy const&) = delete;
 
 		// Returns the next operation.
-		size_t next_operation(Operations& operations)
-		{
-			return current_strategy->next_operation(operations);
-		}
+		size_t next_operation(Operations& operations);
 
 		// Returns the next boolean choice.
 		bool next_boolean()
 		{
-			return current_strategy->next_boolean();
+			return arms[current_arm].strategy->next_boolean();
 		}
 
 		// Returns the next integer choice.
 		int next_integer(int max_value)
 		{
-			return current_strategy->next_integer(max_value);
+			return arms[current_arm].strategy->next_integer(max_value);
+		}
+
+		// Accounts for elided scheduling steps.
+		void skip_steps(size_t operation_id, size_t count);
+
+		// Declares the access of the next step of an operation.
+		void declare_access(size_t operation_id, const StepAccess& access)
+		{
+			arms[current_arm].strategy->declare_access(operation_id, access);
 		}
 
-		// Prepares the next iteration.
-		void prepare_next_iteration()
+		// Notifies that the current iteration reached a known program state.
+		void visit_known_state();
+
+		// Notifies that the current iteration reached a new program state.
+		void visit_new_state();
+
+		// Notifies that the last iteration found a bug.
+		void report_bug();
+
+		// Restarts the choices of the current iteration from the specified seed.
+		bool reseed(size_t seed)
 		{
-			iteration_counter = (iteration_counter + 1) % 3;
-
-			fair_pct->prepare_next_iteration();
-			random->prepare_next_iteration();
-			probabilistic_random->prepare_next_iteration();
-
-#ifdef DEBUG_PORTFOLIO_STRATEGY
-			std::cout<<"Portfolio: iteration_counter: "<<iteration_counter<<std::endl;
-#endif
-			switch(iteration_counter)
-			{
-				case 0:
-					current_strategy = random;
-					break;
-				case 1:
-					current_strategy = fair_pct;
-					break;
-				case 2:
-					current_strategy = probabilistic_random;
-					break;
-				default:
-					throw "Unknown testing strategy";
-			}
+			return arms[current_arm].strategy->reseed(seed);
 		}
 
+		// Rewards the strategy of the last iteration, and prepares the strategy with the highest score.
+		void prepare_next_iteration();
+
+		// Returns the number of iterations that the strategy with the specified index ran.
+		size_t arm_iterations(size_t index) const;
+
 		bool is_fair()
 		{
-			return current_strategy->is_fair();
+			return arms[current_arm].strategy->is_fair();
 		}
 
 		size_t seed()
 		{
-			return current_strategy->seed();
+			return arms[current_arm].strategy->seed();
 		}
 
 		// Description about the strategy
-		std::string get_description()
-		{
-			return "Using Portfolio strategy with Random, fair-pct and probabilistic_random in a round-robin manner\n";
-		}
+		std::string get_description();
 	};
 }
 
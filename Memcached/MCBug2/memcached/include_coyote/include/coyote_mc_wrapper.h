@@ -16,6 +16,7 @@
 
 // Override pthread_create and join to add coyote specific instrumentation
 void *coyote_new_thread_wrapper(void*);
+void coyote_new_fiber_wrapper(void*);
 
 // Useless declarations for useless '-Werror=missing-prototypes'
 int FFI_pthread_join(pthread_t tid, void* arg);
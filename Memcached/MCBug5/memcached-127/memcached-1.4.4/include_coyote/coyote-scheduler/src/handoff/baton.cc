@@ -0,0 +1,116 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "handoff/baton.h"
+
+#if defined(__linux__)
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace coyote
+{
+#if defined(__linux__)
+	// Number of times the owner polls the futex word before going to sleep. A handoff to a thread
+	// that is running on another core usually completes within this window, which avoids the syscall.
+	constexpr int BATON_SPIN_COUNT = 128;
+
+	static void futex_wait(std::atomic<uint32_t>* address, uint32_t expected) noexcept
+	{
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+	}
+
+	static void futex_wake(std::atomic<uint32_t>* address) noexcept
+	{
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(address), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+	}
+
+	Baton::Baton() noexcept :
+		state(EMPTY)
+	{
+	}
+
+	void Baton::post() noexcept
+	{
+		if (state.exchange(POSTED, std::memory_order_release) == SLEEPING)
+		{
+			futex_wake(&state);
+		}
+	}
+
+	void Baton::wait() noexcept
+	{
+		for (int i = 0; i < BATON_SPIN_COUNT; i++)
+		{
+			uint32_t expected = POSTED;
+			if (state.compare_exchange_weak(expected, EMPTY, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				return;
+			}
+		}
+
+		uint32_t current = state.load(std::memory_order_acquire);
+		while (true)
+		{
+			if (current == POSTED)
+			{
+				if (state.compare_exchange_weak(current, EMPTY, std::memory_order_acquire, std::memory_order_acquire))
+				{
+					return;
+				}
+
+				continue;
+			}
+
+			// Announce that the owner is going to sleep, unless a post raced with us.
+			if (current == EMPTY && !state.compare_exchange_weak(current, SLEEPING, std::memory_order_acquire,
+				std::memory_order_acquire))
+			{
+				continue;
+			}
+
+			futex_wait(&state, SLEEPING);
+			current = state.load(std::memory_order_acquire);
+		}
+	}
+
+	void Baton::reset() noexcept
+	{
+		state.store(EMPTY, std::memory_order_relaxed);
+	}
+#else
+	Baton::Baton() noexcept :
+		is_posted(false)
+	{
+	}
+
+	void Baton::post() noexcept
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			is_posted = true;
+		}
+
+		cv.notify_one();
+	}
+
+	void Baton::wait() noexcept
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (!is_posted)
+		{
+			cv.wait(lock);
+		}
+
+		is_posted = false;
+	}
+
+	void Baton::reset() noexcept
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		is_posted = false;
+	}
+#endif
+}
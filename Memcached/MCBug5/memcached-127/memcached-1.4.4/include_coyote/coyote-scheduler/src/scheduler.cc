@@ -1,61 +1,52 @@
 ﻿// Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <vector>
 #include "scheduler.h"
+#include "handoff/condition_variable_handoff.h"
 #include "operations/operation_status.h"
 
 namespace coyote
 {
-	Scheduler::Scheduler() noexcept :
-		Scheduler(std::chrono::high_resolution_clock::now().time_since_epoch().count())
-	{
-	}
-
-	Scheduler::Scheduler(size_t seed) noexcept :
-		strategy(std::make_unique<TestingStrategy>(seed)),
-		scheduling_strategy("RandomStrategy"),
-		random_seed(seed),
-		mutex(std::make_unique<std::mutex>()),
-		pending_operations_cv(),
-		scheduled_operation_id(0),
-		pending_start_operation_count(0),
-		is_attached(false),
-		iteration_count(0),
-		last_error_code(ErrorCode::Success)
-	{
-	}
-
-	Scheduler::Scheduler(std::string str) noexcept :
-		strategy(std::make_unique<TestingStrategy>(str)),
-		scheduling_strategy(str),
-		mutex(std::make_unique<std::mutex>()),
-		pending_operations_cv(),
-		scheduled_operation_id(0),
-		pending_start_operation_count(0),
-		is_attached(false),
-		iteration_count(0),
-		last_error_code(ErrorCode::Success)
+	template <typename StrategyT>
+	BasicScheduler<StrategyT>::BasicScheduler(std::unique_ptr<StrategyT> strategy) noexcept :
+		BasicScheduler(std::move(strategy), std::string())
 	{
 	}
 
-	Scheduler::Scheduler(std::string str, long long unsigned len) noexcept :
-		strategy(std::make_unique<TestingStrategy>(str, len)),
-		scheduling_strategy(str),
+	template <typename StrategyT>
+	BasicScheduler<StrategyT>::BasicScheduler(std::unique_ptr<StrategyT> strategy, std::string strategy_name) noexcept :
+		strategy(std::move(strategy)),
+		scheduling_strategy(strategy_name),
+		resource_table(arena),
 		mutex(std::make_unique<std::mutex>()),
+		handoff_engine(std::make_unique<ConditionVariableHandoff>()),
 		pending_operations_cv(),
 		scheduled_operation_id(0),
+		scheduled_operation_index(0),
 		pending_start_operation_count(0),
 		is_attached(false),
 		iteration_count(0),
-		last_error_code(ErrorCode::Success)
+		last_error_code(ErrorCode::Success),
+		is_elision_enabled(false),
+		is_scheduling_elidable(false),
+		elided_step_count(0),
+		trace_recorder(nullptr),
+		livelock_bound(std::numeric_limits<size_t>::max()),
+		scheduler_metrics(nullptr),
+		progress_step_count(0),
+		known_states(),
+		next_access{ false, 0, false }
 	{
 	}
 
-	ErrorCode Scheduler::attach() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::attach() noexcept
 	{
+		const uint64_t start_time = scheduler_metrics != nullptr ? SchedulerMetrics::now() : 0;
 		try
 		{
 			std::unique_lock<std::mutex> lock(*mutex);
@@ -71,15 +62,32 @@ namespace coyote
 			is_attached = true;
 			iteration_count += 1;
 			last_error_code = ErrorCode::Success;
+			progress_step_count = 0;
+			is_scheduling_elidable.store(false, std::memory_order_release);
 
 			if (iteration_count > 1)
 			{
 				// Prepare the strategy for the next iteration.
-				strategy->prepare_next_iteration();
+				strategy->StrategyT::prepare_next_iteration();
+			}
+
+			if (trace_recorder != nullptr)
+			{
+				trace_recorder->begin_iteration(iteration_count);
+			}
+
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->begin_iteration();
 			}
 
 			create_operation_inner(main_operation_id);
 			start_operation_inner(main_operation_id, lock);
+
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->iteration()[Metric::AttachNanoseconds] = SchedulerMetrics::now() - start_time;
+			}
 		}
 		catch (ErrorCode error_code)
 		{
@@ -93,8 +101,10 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::detach() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::detach() noexcept
 	{
+		const uint64_t start_time = scheduler_metrics != nullptr ? SchedulerMetrics::now() : 0;
 		try
 		{
 			std::unique_lock<std::mutex> lock(*mutex);
@@ -108,31 +118,46 @@ namespace coyote
 			}
 
 			is_attached = false;
+			is_scheduling_elidable.store(false, std::memory_order_release);
+			report_elided_steps();
+			if (trace_recorder != nullptr)
+			{
+				trace_recorder->flush();
+			}
 
-			Operation* main_op = operation_map.at(main_operation_id).get();
-			main_op->status = OperationStatus::Completed;
-			operations.disable(main_op->id);
+			const size_t main_index = operation_table.index_of(main_operation_id);
+			operation_table.status(main_index) = OperationStatus::Completed;
+			operations.disable(main_operation_id);
 
-			for (auto& kvp : operation_map)
+			for (size_t index = 0; index < operation_table.size(); index++)
 			{
-				Operation* next_op = kvp.second.get();
-				if (next_op->status != OperationStatus::Completed)
+				if (operation_table.status(index) != OperationStatus::Completed)
 				{
 #ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::detach] canceling operation " << next_op->id << std::endl;
+					std::cout << "[coyote::detach] canceling operation " << operation_table.id(index) << std::endl;
 #endif // COYOTE_DEBUG_LOG
 					// If the operation has not already completed, then cancel it.
-					next_op->is_scheduled = true;
-					next_op->status = OperationStatus::Completed;
-					operations.disable(next_op->id);
-					next_op->cv.notify_all();
+					operation_table.set_scheduled(index, true);
+					operation_table.status(index) = OperationStatus::Completed;
+					operations.disable(operation_table.id(index));
+					handoff_engine->notify(operation_table[index]);
 				}
 			}
 
-			operation_map.clear();
+			handoff_engine->reset(lock);
+			operation_table.clear();
 			operations.clear();
-			resource_map.clear();
+
+			// Release all resources of this iteration at once.
+			resource_table.clear();
+			arena.reset();
 			pending_start_operation_count = 0;
+
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->iteration()[Metric::DetachNanoseconds] = SchedulerMetrics::now() - start_time;
+				scheduler_metrics->end_iteration();
+			}
 		}
 		catch (ErrorCode error_code)
 		{
@@ -146,7 +171,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::create_operation(size_t operation_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::create_operation(size_t operation_id) noexcept
 	{
 		try
 		{
@@ -178,7 +204,49 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::start_operation(size_t operation_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::create_operation(size_t operation_id, void (*func)(void*), void* arg) noexcept
+	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::create_operation] creating and launching operation " << operation_id << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+			if (!is_attached)
+			{
+				throw ErrorCode::ClientNotAttached;
+			}
+			else if (operation_id == main_operation_id)
+			{
+				throw ErrorCode::MainOperationExplicitlyCreated;
+			}
+			else if (!handoff_engine->supports_launch())
+			{
+				throw ErrorCode::NotSupported;
+			}
+
+			const size_t index = create_operation_inner(operation_id);
+			handoff_engine->launch(operation_table[scheduled_operation_index], operation_table[index],
+				[this, operation_id, func, arg]() {
+					run_operation_body(operation_id, func, arg);
+				}, lock);
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::start_operation(size_t operation_id) noexcept
 	{
 		try
 		{
@@ -210,7 +278,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::join_operation(size_t operation_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::join_operation(size_t operation_id) noexcept
 	{
 		try
 		{
@@ -224,8 +293,8 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			auto it = operation_map.find(operation_id);
-			if (it == operation_map.end())
+			const size_t join_index = operation_table.find(operation_id);
+			if (join_index == OperationTable::npos)
 			{
 #ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::join_operation] not existing operation " << operation_id << std::endl;
@@ -233,14 +302,17 @@ namespace coyote
 				throw ErrorCode::NotExistingOperation;
 			}
 
-			Operation* join_op = it->second.get();
-			if (join_op->status != OperationStatus::Completed)
+			if (operation_table.status(join_index) != OperationStatus::Completed)
 			{
-				join_op->blocked_operation_ids.insert(scheduled_operation_id);
+				std::vector<size_t>& blocked_operation_indices = operation_table[join_index].blocked_operation_indices;
+				if (std::find(blocked_operation_indices.begin(), blocked_operation_indices.end(),
+					scheduled_operation_index) == blocked_operation_indices.end())
+				{
+					blocked_operation_indices.push_back(scheduled_operation_index);
+				}
 
-				Operation* scheduled_op = operation_map.at(scheduled_operation_id).get();
-				scheduled_op->join_operation(operation_id);
-				operations.disable(scheduled_op->id);
+				operation_table.join_operation(scheduled_operation_index, join_index);
+				operations.disable(scheduled_operation_id);
 
 				// Waiting for the resource to be released, so schedule the next enabled operation.
 				schedule_next_inner(lock);
@@ -264,7 +336,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::join_operations(const size_t* operation_ids, size_t size, bool wait_all) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::join_operations(const size_t* operation_ids, size_t size, bool wait_all) noexcept
 	{
 		try
 		{
@@ -287,12 +360,12 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			std::vector<size_t> join_operations;
+			join_operation_indices.clear();
 			for (int i = 0; i < size; i++)
 			{
 				size_t operation_id = *(operation_ids + i);
-				auto it = operation_map.find(operation_id);
-				if (it == operation_map.end())
+				const size_t join_index = operation_table.find(operation_id);
+				if (join_index == OperationTable::npos)
 				{
 #ifdef COYOTE_DEBUG_LOG
 					std::cout << "[coyote::join_operations] not existing operation " << operation_id << std::endl;
@@ -300,11 +373,16 @@ namespace coyote
 					throw ErrorCode::NotExistingOperation;
 				}
 
-				Operation* join_op = it->second.get();
-				if (join_op->status != OperationStatus::Completed)
+				if (operation_table.status(join_index) != OperationStatus::Completed)
 				{
-					join_op->blocked_operation_ids.insert(scheduled_operation_id);
-					join_operations.push_back(operation_id);
+					std::vector<size_t>& blocked_operation_indices = operation_table[join_index].blocked_operation_indices;
+					if (std::find(blocked_operation_indices.begin(), blocked_operation_indices.end(),
+						scheduled_operation_index) == blocked_operation_indices.end())
+					{
+						blocked_operation_indices.push_back(scheduled_operation_index);
+					}
+
+					join_operation_indices.push_back(join_index);
 				}
 #ifdef COYOTE_DEBUG_LOG
 				else
@@ -314,11 +392,10 @@ namespace coyote
 #endif // COYOTE_DEBUG_LOG
 			}
 
-			if (!join_operations.empty())
+			if (!join_operation_indices.empty())
 			{
-				Operation* scheduled_op = operation_map.at(scheduled_operation_id).get();
-				scheduled_op->join_operations(join_operations, wait_all);
-				operations.disable(scheduled_op->id);
+				operation_table.join_operations(scheduled_operation_index, join_operation_indices, wait_all);
+				operations.disable(scheduled_operation_id);
 
 				// Waiting for the resources to be released, so schedule the next enabled operation.
 				schedule_next_inner(lock);
@@ -336,7 +413,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::complete_operation(size_t operation_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::complete_operation(size_t operation_id) noexcept
 	{
 		try
 		{
@@ -354,8 +432,8 @@ namespace coyote
 				throw ErrorCode::MainOperationExplicitlyCompleted;
 			}
 
-			auto it = operation_map.find(operation_id);
-			if (it == operation_map.end())
+			const size_t index = operation_table.find(operation_id);
+			if (index == OperationTable::npos)
 			{
 #ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::complete_operation] not existing operation " << operation_id << std::endl;
@@ -363,26 +441,25 @@ namespace coyote
 				throw ErrorCode::NotExistingOperation;
 			}
 
-			Operation* op = it->second.get();
-			if (op->status == OperationStatus::Completed)
+			OperationStatus& status = operation_table.status(index);
+			if (status == OperationStatus::Completed)
 			{
 				throw ErrorCode::OperationAlreadyCompleted;
 			}
-			else if (op->status == OperationStatus::None)
+			else if (status == OperationStatus::None)
 			{
 				throw ErrorCode::OperationNotStarted;
 			}
 
-			op->status = OperationStatus::Completed;
-			operations.disable(op->id);
+			status = OperationStatus::Completed;
+			operations.disable(operation_id);
 
 			// Notify any operations that are waiting to join this operation.
-			for (const auto& blocked_id : op->blocked_operation_ids)
+			for (const auto& blocked_index : operation_table[index].blocked_operation_indices)
 			{
-				Operation* blocked_op = operation_map.at(blocked_id).get();
-				if (blocked_op->on_join_operation(operation_id))
+				if (operation_table.on_join_operation(blocked_index, index))
 				{
-					operations.enable(blocked_op->id);
+					operations.enable(operation_table.id(blocked_index));
 				}
 			}
 
@@ -401,7 +478,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::create_resource(size_t resource_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::create_resource(size_t resource_id) noexcept
 	{
 		try
 		{
@@ -415,14 +493,7 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			auto it = resource_map.find(resource_id);
-			if (it != resource_map.end())
-			{
-				throw ErrorCode::DuplicateResource;
-			}
-
-			resource_map.insert(std::pair<size_t, std::shared_ptr<std::unordered_set<size_t>>>(
-				resource_id, std::make_shared<std::unordered_set<size_t>>()));
+			resource_table.insert(resource_id);
 		}
 		catch (ErrorCode error_code)
 		{
@@ -436,7 +507,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::wait_resource(size_t resource_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::wait_resource(size_t resource_id) noexcept
 	{
 		try
 		{
@@ -450,18 +522,14 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			Operation* scheduled_op = operation_map.at(scheduled_operation_id).get();
-			scheduled_op->wait_resource_signal(resource_id);
-			operations.disable(scheduled_op->id);
-
-			auto it = resource_map.find(resource_id);
-			if (it == resource_map.end())
+			operation_table.wait_resource_signal(scheduled_operation_index, resource_id);
+			operations.disable(scheduled_operation_id);
+			if (scheduler_metrics != nullptr)
 			{
-				throw ErrorCode::NotExistingResource;
+				scheduler_metrics->iteration()[Metric::ResourceWaits] += 1;
 			}
 
-			std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-			blocked_operation_ids->insert(scheduled_operation_id);
+			resource_table.add_waiter(resource_id, scheduled_operation_index);
 
 			// Waiting for the resource to be released, so schedule the next enabled operation.
 			schedule_next_inner(lock);
@@ -478,7 +546,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::wait_resources(const size_t* resource_ids, size_t size, bool wait_all) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::wait_resources(const size_t* resource_ids, size_t size, bool wait_all) noexcept
 	{
 		try
 		{
@@ -501,21 +570,16 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			Operation* scheduled_op = operation_map.at(scheduled_operation_id).get();
-			scheduled_op->wait_resource_signals(resource_ids, size, wait_all);
-			operations.disable(scheduled_op->id);
+			operation_table.wait_resource_signals(scheduled_operation_index, resource_ids, size, wait_all);
+			operations.disable(scheduled_operation_id);
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->iteration()[Metric::ResourceWaits] += 1;
+			}
 
 			for (int i = 0; i < size; i++)
 			{
-				size_t resource_id = *(resource_ids + i);
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
-				{
-					throw ErrorCode::NotExistingResource;
-				}
-
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				blocked_operation_ids->insert(scheduled_operation_id);
+				resource_table.add_waiter(*(resource_ids + i), scheduled_operation_index);
 			}
 
 			// Waiting for the resources to be released, so schedule the next enabled operation.
@@ -533,7 +597,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::signal_resource(size_t resource_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::signal_resource(size_t resource_id) noexcept
 	{
 		try
 		{
@@ -547,21 +612,23 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			auto it = resource_map.find(resource_id);
-			if (it == resource_map.end())
+			ResourceWaiters& blocked_operation_indices = resource_table.at(resource_id);
+			if (scheduler_metrics != nullptr)
 			{
-				throw ErrorCode::NotExistingResource;
+				scheduler_metrics->iteration()[Metric::ResourceSignals] += 1;
 			}
 
-			std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-			for (const auto& blocked_id : *blocked_operation_ids)
+			for (const auto& blocked_index : blocked_operation_indices)
 			{
-				Operation* blocked_op = operation_map.at(blocked_id).get();
-				if (blocked_op->on_resource_signal(resource_id))
+				if (operation_table.on_resource_signal(blocked_index, resource_id))
 				{
-					operations.enable(blocked_op->id);
+					operations.enable(operation_table.id(blocked_index));
+					is_scheduling_elidable.store(false, std::memory_order_release);
 				}
 			}
+
+			// Every waiter has now consumed this signal, so none of them is still waiting on the resource.
+			blocked_operation_indices.clear();
 		}
 		catch (ErrorCode error_code)
 		{
@@ -575,7 +642,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::signal_resource(size_t resource_id, size_t operation_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::signal_resource(size_t resource_id, size_t operation_id) noexcept
 	{
 		try
 		{
@@ -590,23 +658,20 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			auto it = resource_map.find(resource_id);
-			if (it == resource_map.end())
+			ResourceWaiters& blocked_operation_indices = resource_table.at(resource_id);
+			if (scheduler_metrics != nullptr)
 			{
-				throw ErrorCode::NotExistingResource;
+				scheduler_metrics->iteration()[Metric::ResourceSignals] += 1;
 			}
 
-			std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-			auto op_it = blocked_operation_ids->find(operation_id);
-			if (op_it != blocked_operation_ids->end())
+			const size_t blocked_index = operation_table.find(operation_id);
+			if (blocked_index != OperationTable::npos && blocked_operation_indices.erase(blocked_index))
 			{
-				Operation* blocked_op = operation_map.at(operation_id).get();
-				if (blocked_op->on_resource_signal(resource_id))
+				if (operation_table.on_resource_signal(blocked_index, resource_id))
 				{
-					operations.enable(blocked_op->id);
+					operations.enable(operation_id);
+					is_scheduling_elidable.store(false, std::memory_order_release);
 				}
-
-				blocked_operation_ids->erase(op_it);
 			}
 		}
 		catch (ErrorCode error_code)
@@ -621,7 +686,8 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::delete_resource(size_t resource_id) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::delete_resource(size_t resource_id) noexcept
 	{
 		try
 		{
@@ -635,13 +701,69 @@ namespace coyote
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			auto it = resource_map.find(resource_id);
-			if (it == resource_map.end())
+			resource_table.erase(resource_id);
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::schedule_next() noexcept
+	{
+		if (is_scheduling_elidable.load(std::memory_order_acquire) &&
+			progress_step_count + elided_step_count < livelock_bound)
+		{
+			// The current operation is the only enabled operation, so the strategy can only pick it.
+			elided_step_count += 1;
+			return last_error_code;
+		}
+
+		return schedule_next_slow(StepAccess{ false, 0, false });
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::schedule_next(size_t location, bool is_write) noexcept
+	{
+		if (is_scheduling_elidable.load(std::memory_order_acquire) &&
+			progress_step_count + elided_step_count < livelock_bound)
+		{
+			// The current operation runs its next step alone, so its access does not matter.
+			elided_step_count += 1;
+			return last_error_code;
+		}
+
+		return schedule_next_slow(StepAccess{ true, location, is_write });
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::schedule_next_slow(const StepAccess& access) noexcept
+	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+
+			if (!is_attached)
 			{
-				throw ErrorCode::NotExistingResource;
+				throw ErrorCode::ClientNotAttached;
+			}
+			else if (progress_step_count + elided_step_count >= livelock_bound)
+			{
+#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::schedule_next] livelock detected" << std::endl;
+#endif // COYOTE_DEBUG_LOG
+				throw ErrorCode::LivelockDetected;
 			}
 
-			resource_map.erase(resource_id);
+			next_access = access;
+			schedule_next_inner(lock);
 		}
 		catch (ErrorCode error_code)
 		{
@@ -655,18 +777,29 @@ namespace coyote
 		return last_error_code;
 	}
 
-	ErrorCode Scheduler::schedule_next() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::report_state(size_t state_hash) noexcept
 	{
 		try
 		{
 			std::unique_lock<std::mutex> lock(*mutex);
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::report_state] reporting state " << state_hash << std::endl;
+#endif // COYOTE_DEBUG_LOG
 
 			if (!is_attached)
 			{
 				throw ErrorCode::ClientNotAttached;
 			}
 
-			schedule_next_inner(lock);
+			if (!known_states.insert(state_hash).second)
+			{
+				strategy->StrategyT::visit_known_state();
+			}
+			else
+			{
+				strategy->StrategyT::visit_new_state();
+			}
 		}
 		catch (ErrorCode error_code)
 		{
@@ -680,64 +813,223 @@ namespace coyote
 		return last_error_code;
 	}
 
-	bool Scheduler::next_boolean() noexcept
+	// The error code of the iteration is left as is, since a detached client program reads it afterwards.
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::report_bug() noexcept
 	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
 #ifdef COYOTE_DEBUG_LOG
-		std::cout << "[coyote::next_boolean] " << std::endl;
+			std::cout << "[coyote::report_bug] reporting a bug" << std::endl;
 #endif // COYOTE_DEBUG_LOG
-		return strategy->next_boolean();
+
+			strategy->StrategyT::report_bug();
+		}
+		catch (...)
+		{
+			return ErrorCode::Failure;
+		}
+
+		return ErrorCode::Success;
+	}
+
+	template <typename StrategyT>
+	size_t BasicScheduler<StrategyT>::seed() noexcept
+	{
+		return strategy->StrategyT::seed();
 	}
 
-	int Scheduler::next_integer(int max_value) noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::reseed(size_t seed) noexcept
 	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
 #ifdef COYOTE_DEBUG_LOG
-		std::cout << "[coyote::next_integer] " << std::endl;
+			std::cout << "[coyote::reseed] reseeding the strategy with " << seed << std::endl;
 #endif // COYOTE_DEBUG_LOG
-		return strategy->next_integer(max_value);
+
+			if (!strategy->StrategyT::reseed(seed))
+			{
+				throw ErrorCode::NotSupported;
+			}
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::error_code() noexcept
+	{
+		return last_error_code;
+	}
+
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::set_handoff_engine(std::unique_ptr<HandoffEngine> engine) noexcept
+	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (is_attached)
+			{
+				throw ErrorCode::ClientAttached;
+			}
+			else if (engine == nullptr)
+			{
+				throw ErrorCode::Failure;
+			}
+
+			handoff_engine = std::move(engine);
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
 	}
 
-	size_t Scheduler::seed() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::set_scheduling_elision(bool is_enabled) noexcept
 	{
-		return strategy->seed();
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (is_attached)
+			{
+				throw ErrorCode::ClientAttached;
+			}
+
+			is_elision_enabled = is_enabled;
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
 	}
 
-	ErrorCode Scheduler::error_code() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::record_trace(const std::string& path) noexcept
 	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (is_attached)
+			{
+				throw ErrorCode::ClientAttached;
+			}
+
+			trace_recorder = std::make_unique<TraceRecorder>(path);
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
 		return last_error_code;
 	}
 
-	size_t Scheduler::get_operation_id() noexcept
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::set_livelock_bound(size_t max_steps) noexcept
 	{
-		return scheduled_operation_id;
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (is_attached)
+			{
+				throw ErrorCode::ClientAttached;
+			}
+
+			livelock_bound = max_steps == 0 ? std::numeric_limits<size_t>::max() : max_steps;
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
 	}
 
-	void Scheduler::create_operation_inner(size_t operation_id)
+	template <typename StrategyT>
+	ErrorCode BasicScheduler<StrategyT>::enable_metrics() noexcept
 	{
-		auto it = operation_map.find(operation_id);
-		if (it != operation_map.end())
+		try
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			if (is_attached)
+			{
+				throw ErrorCode::ClientAttached;
+			}
+
+			if (scheduler_metrics == nullptr)
+			{
+				scheduler_metrics = std::make_unique<SchedulerMetrics>();
+			}
+		}
+		catch (ErrorCode error_code)
 		{
-			throw ErrorCode::DuplicateOperation;
+			last_error_code = error_code;
 		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		return last_error_code;
+	}
 
-		auto result = operation_map.insert(std::pair<size_t, std::unique_ptr<Operation>>(
-			operation_id, std::make_unique<Operation>(operation_id)));
-		if (operation_map.size() == 1)
+	template <typename StrategyT>
+	size_t BasicScheduler<StrategyT>::create_operation_inner(size_t operation_id)
+	{
+		const size_t index = operation_table.insert(operation_id);
+		if (operation_table.size() == 1)
 		{
 			// This is the first operation, so schedule it.
 			scheduled_operation_id = operation_id;
-			result.first->second->is_scheduled = true;
+			scheduled_operation_index = index;
+			operation_table.set_scheduled(index, true);
 		}
 
 		// Increment the count of created operations that have not yet started.
 		pending_start_operation_count += 1;
+		is_scheduling_elidable.store(false, std::memory_order_release);
+		return index;
 	}
 
-	void Scheduler::start_operation_inner(size_t operation_id, std::unique_lock<std::mutex>& lock)
+	template <typename StrategyT>
+	void BasicScheduler<StrategyT>::start_operation_inner(size_t operation_id, std::unique_lock<std::mutex>& lock)
 	{
 		// TODO: Check pending counter was incremented.
 
-		auto it = operation_map.find(operation_id);
-		if (it == operation_map.end())
+		const size_t index = operation_table.find(operation_id);
+		if (index == OperationTable::npos)
 		{
 #ifdef COYOTE_DEBUG_LOG
 			std::cout << "[coyote::start_operation] not existing operation " << operation_id << std::endl;
@@ -745,12 +1037,12 @@ namespace coyote
 			throw ErrorCode::NotExistingOperation;
 		}
 
-		Operation* op = it->second.get();
-		if (op->status == OperationStatus::Completed)
+		OperationStatus& status = operation_table.status(index);
+		if (status == OperationStatus::Completed)
 		{
 			throw ErrorCode::OperationAlreadyCompleted;
 		}
-		else if (op->status != OperationStatus::None)
+		else if (status != OperationStatus::None)
 		{
 			throw ErrorCode::OperationAlreadyStarted;
 		}
@@ -766,34 +1058,50 @@ namespace coyote
 			pending_operations_cv.notify_all();
 		}
 
-		if (op->status != OperationStatus::Completed)
+		if (status != OperationStatus::Completed)
 		{
-			op->status = OperationStatus::Enabled;
-			operations.insert(op->id);
-			op->cv.notify_all();
-			while (!op->is_scheduled)
+			status = OperationStatus::Enabled;
+			operations.insert(operation_id);
+
+			// Slots are reused by later iterations, so the iteration is checked after every wakeup.
+			const size_t iteration = iteration_count;
+			while (!operation_table.is_scheduled(index))
 			{
 #ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::start_operation] pausing operation " << operation_id << std::endl;
 #endif // COYOTE_DEBUG_LOG
-				op->cv.wait(lock);
+				const uint64_t wait_start_time = scheduler_metrics != nullptr ? SchedulerMetrics::now() : 0;
+				handoff_engine->wait(operation_table[index], lock);
 #ifdef COYOTE_DEBUG_LOG
 				std::cout << "[coyote::start_operation] resuming operation " << operation_id << std::endl;
 #endif // COYOTE_DEBUG_LOG
-				if (!is_attached)
+				if (!is_attached || iteration != iteration_count)
 				{
 					throw ErrorCode::ClientNotAttached;
 				}
+				else if (scheduler_metrics != nullptr)
+				{
+					scheduler_metrics->record_blocked(wait_start_time);
+				}
 			}
 		}
 	}
 
-	void Scheduler::schedule_next_inner(std::unique_lock<std::mutex>& lock)
+	template <typename StrategyT>
+	void BasicScheduler<StrategyT>::schedule_next_inner(std::unique_lock<std::mutex>& lock)
 	{
 #ifdef COYOTE_DEBUG_LOG
 		std::cout << "[coyote::schedule_next] current operation " << scheduled_operation_id << std::endl;
 #endif // COYOTE_DEBUG_LOG
 
+		is_scheduling_elidable.store(false, std::memory_order_release);
+		report_elided_steps();
+		progress_step_count += 1;
+
+		// The next step of the paused operation accesses anything, unless 'schedule_next' declared its access.
+		strategy->StrategyT::declare_access(scheduled_operation_id, next_access);
+		next_access.is_declared = false;
+
 		// Wait for any recently created operations to start.
 		while (pending_start_operation_count > 0)
 		{
@@ -801,7 +1109,12 @@ namespace coyote
 			std::cout << "[coyote::schedule_next] waiting " << pending_start_operation_count <<
 				" pending operations" << std::endl;
 #endif // COYOTE_DEBUG_LOG
+			const uint64_t wait_start_time = scheduler_metrics != nullptr ? SchedulerMetrics::now() : 0;
 			pending_operations_cv.wait(lock);
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->record_blocked(wait_start_time);
+			}
 		}
 
 		// Check if the schedule has finished or if there is a deadlock.
@@ -822,44 +1135,161 @@ namespace coyote
 		}
 
 		// Ask the strategy for the next operation to schedule.
-		size_t next_id = strategy->next_operation(operations);
-		Operation* next_op = operation_map.at(next_id).get();
+		size_t next_id = strategy->StrategyT::next_operation(operations);
+		const size_t next_index = operation_table.index_of(next_id);
+		if (trace_recorder != nullptr && operations.size() > 1)
+		{
+			// Forced decisions are not recorded, so that the trace does not depend on scheduling elision.
+			trace_recorder->record(TraceDecision::Operation, next_id);
+		}
 
-		const size_t previous_id = scheduled_operation_id;
+		if (scheduler_metrics != nullptr)
+		{
+			scheduler_metrics->record_decision(operations.size(), next_index != scheduled_operation_index);
+		}
+
+		const size_t previous_index = scheduled_operation_index;
 		scheduled_operation_id = next_id;
+		scheduled_operation_index = next_index;
+		if (is_elision_enabled && operations.size() == 1)
+		{
+			// The next operation runs alone until it enables another operation or blocks.
+			is_scheduling_elidable.store(true, std::memory_order_release);
+		}
 
 #ifdef COYOTE_DEBUG_LOG
 		std::cout << "[coyote::schedule_next] next operation " << next_id << std::endl;
 #endif // COYOTE_DEBUG_LOG
 
-		if (previous_id != next_id)
+		if (previous_index != next_index)
 		{
-			// Resume the next operation.
-			next_op->is_scheduled = true;
-			next_op->cv.notify_all();
+			operation_table.set_scheduled(next_index, true);
 
-			// Pause the previous operation.
-			Operation* previous_op = operation_map.at(previous_id).get();
-			if (previous_op->status != OperationStatus::Completed)
+			Operation& previous_op = operation_table[previous_index];
+			Operation& next_op = operation_table[next_index];
+			if (operation_table.status(previous_index) == OperationStatus::Completed)
 			{
-				previous_op->is_scheduled = false;
+				// Resume the next operation, nothing is left to pause.
+				handoff_engine->release(previous_op, next_op, lock);
+				return;
+			}
 
-				while (!previous_op->is_scheduled)
-				{
+			// Resume the next operation and pause the previous operation.
+			operation_table.set_scheduled(previous_index, false);
 #ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::schedule_next] pausing operation " << previous_id << std::endl;
+			std::cout << "[coyote::schedule_next] pausing operation " << operation_table.id(previous_index) << std::endl;
 #endif // COYOTE_DEBUG_LOG
-					// Wait until the operation gets scheduled again.
-					previous_op->cv.wait(lock);
+			// Slots are reused by later iterations, so the iteration is checked after every wakeup.
+			const size_t iteration = iteration_count;
+			const uint64_t wait_start_time = scheduler_metrics != nullptr ? SchedulerMetrics::now() : 0;
+			handoff_engine->handoff(previous_op, next_op, lock);
+			while (true)
+			{
 #ifdef COYOTE_DEBUG_LOG
-					std::cout << "[coyote::schedule_next] resuming operation " << previous_id << std::endl;
+				std::cout << "[coyote::schedule_next] resuming operation " << operation_table.id(previous_index) << std::endl;
 #endif // COYOTE_DEBUG_LOG
-					if (!is_attached)
+				if (!is_attached || iteration != iteration_count)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+				else if (operation_table.is_scheduled(previous_index))
+				{
+					if (scheduler_metrics != nullptr)
 					{
-						throw ErrorCode::ClientNotAttached;
+						scheduler_metrics->record_blocked(wait_start_time);
 					}
+
+					break;
 				}
+
+				// Wait until the operation gets scheduled again.
+				handoff_engine->wait(previous_op, lock);
+			}
+		}
+	}
+
+	template <typename StrategyT>
+	void BasicScheduler<StrategyT>::report_elided_steps()
+	{
+		if (elided_step_count > 0)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::schedule_next] elided " << elided_step_count << " steps of operation " <<
+				scheduled_operation_id << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			strategy->StrategyT::skip_steps(scheduled_operation_id, elided_step_count);
+			progress_step_count += elided_step_count;
+			if (scheduler_metrics != nullptr)
+			{
+				scheduler_metrics->iteration()[Metric::ElidedSteps] += elided_step_count;
 			}
+			elided_step_count = 0;
 		}
 	}
+
+	template <typename StrategyT>
+	void BasicScheduler<StrategyT>::run_operation_body(size_t operation_id, void (*func)(void*), void* arg) noexcept
+	{
+		bool is_started = false;
+		try
+		{
+			// The body runs on its own fiber, which inherits the scheduler mutex from its launcher.
+			std::unique_lock<std::mutex> lock(*mutex, std::adopt_lock);
+			start_operation_inner(operation_id, lock);
+			is_started = true;
+		}
+		catch (ErrorCode error_code)
+		{
+			last_error_code = error_code;
+		}
+		catch (...)
+		{
+			last_error_code = ErrorCode::Failure;
+		}
+
+		// The body only runs under the control of the scheduler, so it is skipped if the operation could
+		// not be started, such as when the scheduler detached while the operation was paused.
+		if (is_started)
+		{
+			func(arg);
+			complete_operation(operation_id);
+		}
+
+		// Completing the operation only returns if no other operation could be scheduled. In that case, or
+		// if the operation was not started, the mutex is handed back to the paused main operation.
+		mutex->lock();
+	}
+
+	Scheduler::Scheduler() noexcept :
+		Scheduler(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+	{
+	}
+
+	Scheduler::Scheduler(size_t seed) noexcept :
+		BasicScheduler(std::make_unique<TestingStrategy>(seed), "RandomStrategy")
+	{
+	}
+
+	Scheduler::Scheduler(std::string str) noexcept :
+		BasicScheduler(std::make_unique<TestingStrategy>(str), str)
+	{
+	}
+
+	Scheduler::Scheduler(std::string str, long long unsigned len) noexcept :
+		BasicScheduler(std::make_unique<TestingStrategy>(str, len), str)
+	{
+	}
+
+	Scheduler::Scheduler(std::unique_ptr<Strategy> strategy) noexcept :
+		BasicScheduler(std::make_unique<TestingStrategy>(std::move(strategy)), std::string())
+	{
+	}
+
+	template class BasicScheduler<TestingStrategy>;
+	template class BasicScheduler<RandomStrategy>;
+	template class BasicScheduler<ProbabilisticRandomStrategy>;
+	template class BasicScheduler<PCTStrategy>;
+	template class BasicScheduler<DFSStrategy>;
+	template class BasicScheduler<SleepSetDFSStrategy>;
+	template class BasicScheduler<ReplayStrategy>;
 }
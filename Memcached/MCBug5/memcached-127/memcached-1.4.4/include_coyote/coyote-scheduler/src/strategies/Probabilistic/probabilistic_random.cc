@@ -109,19 +109,28 @@ namespace coyote
 		}
 	}
 
-	bool ProbabilisticRandomStrategy::next_boolean()
+	void ProbabilisticRandomStrategy::skip_steps(size_t operation_id, size_t count)
 	{
-		return (generator.next() & 1) == 0;
+		current_operation_id = operation_id;
+		if(!isProbabilityFixed){
+			// Each step increments the counter, and changes the probability when it reaches the maximum.
+			const long long unsigned period = max_step_counter > 0 ? max_step_counter : 1;
+			const long long unsigned total_steps = step_counter + count;
+			probability = (probability + total_steps / period) % 11;
+			step_counter = total_steps % period;
+		}
 	}
 
-	int ProbabilisticRandomStrategy::next_integer(int max_value)
+	size_t ProbabilisticRandomStrategy::seed()
 	{
-		return generator.next() % max_value;
+		return iteration_seed;
 	}
 
-	size_t ProbabilisticRandomStrategy::seed()
+	bool ProbabilisticRandomStrategy::reseed(size_t seed)
 	{
-		return iteration_seed;
+		iteration_seed = seed;
+		generator.seed(iteration_seed);
+		return true;
 	}
 
 	void ProbabilisticRandomStrategy::prepare_next_iteration()
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <cstdlib>
+#include "error_code.h"
+#include "trace/trace_recorder.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace coyote
+{
+	// The initial capacity of a trace, which is grown by doubling.
+	constexpr size_t INITIAL_TRACE_CAPACITY = 64 * 1024;
+
+	TraceRecorder::TraceRecorder(const std::string& path) :
+		path(path),
+		file(-1),
+		data(nullptr),
+		capacity(0),
+		size(TraceFormat::HEADER_SIZE)
+	{
+#if !defined(_WIN32)
+		file = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (file < 0)
+		{
+			throw ErrorCode::Failure;
+		}
+#endif // !_WIN32
+
+		if (!grow())
+		{
+#if !defined(_WIN32)
+			close(file);
+#endif // !_WIN32
+			throw ErrorCode::Failure;
+		}
+
+		const uint32_t magic = TraceFormat::MAGIC;
+		const uint32_t version = TraceFormat::VERSION;
+		std::memcpy(data, &magic, sizeof(magic));
+		std::memcpy(data + sizeof(magic), &version, sizeof(version));
+		begin_iteration(0);
+	}
+
+	TraceRecorder::~TraceRecorder()
+	{
+		flush();
+#if !defined(_WIN32)
+		munmap(data, capacity);
+
+		// Drop the unused tail of the mapping, so that the file ends with the payload.
+		if (ftruncate(file, size) != 0)
+		{
+			std::perror("[coyote::TraceRecorder] failed to truncate the trace file");
+		}
+
+		close(file);
+#else
+		std::free(data);
+#endif // !_WIN32
+	}
+
+	void TraceRecorder::begin_iteration(size_t iteration)
+	{
+		const uint64_t iteration_number = iteration;
+		const uint64_t payload_size = 0;
+		std::memcpy(data + TraceFormat::ITERATION_OFFSET, &iteration_number, sizeof(iteration_number));
+		std::memcpy(data + TraceFormat::PAYLOAD_SIZE_OFFSET, &payload_size, sizeof(payload_size));
+		size = TraceFormat::HEADER_SIZE;
+	}
+
+	void TraceRecorder::flush()
+	{
+#if defined(_WIN32)
+		FILE* stream = std::fopen(path.c_str(), "wb");
+		if (stream == nullptr || std::fwrite(data, 1, size, stream) != size)
+		{
+			std::perror("[coyote::TraceRecorder] failed to write the trace file");
+		}
+
+		if (stream != nullptr)
+		{
+			std::fclose(stream);
+		}
+#endif // _WIN32
+	}
+
+	size_t TraceRecorder::payload_size() const noexcept
+	{
+		return size - TraceFormat::HEADER_SIZE;
+	}
+
+	bool TraceRecorder::grow() noexcept
+	{
+		const size_t new_capacity = capacity == 0 ? INITIAL_TRACE_CAPACITY : capacity * 2;
+#if !defined(_WIN32)
+		if (ftruncate(file, new_capacity) != 0)
+		{
+			return false;
+		}
+
+		void* mapping = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+		if (mapping == MAP_FAILED)
+		{
+			return false;
+		}
+
+		if (data != nullptr)
+		{
+			munmap(data, capacity);
+		}
+
+		data = static_cast<unsigned char*>(mapping);
+#else
+		void* buffer = std::realloc(data, new_capacity);
+		if (buffer == nullptr)
+		{
+			return false;
+		}
+
+		data = static_cast<unsigned char*>(buffer);
+#endif // !_WIN32
+		capacity = new_capacity;
+		return true;
+	}
+}
@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/handoff/fiber_handoff.h"
+
+using namespace coyote;
+
+constexpr auto WORK_FIBER_1_ID = 1;
+constexpr auto WORK_FIBER_2_ID = 2;
+constexpr auto NESTED_FIBER_ID = 3;
+constexpr auto LOCK_ID = 1;
+
+Scheduler* scheduler;
+
+int shared_var = 0;
+int lock_status = 0;
+int nested_runs = 0;
+
+// Assertions cannot throw across the boundary of a fiber, so failures are recorded here instead.
+std::string failure;
+
+void check(bool predicate, std::string error)
+{
+	if (!predicate && failure.empty())
+	{
+		failure = error;
+	}
+}
+
+void mock_acquire()
+{
+	scheduler->schedule_next();
+
+	do
+	{
+		if (lock_status == 0)
+		{
+			lock_status = 1;
+			break;
+		}
+		else
+		{
+			scheduler->wait_resource(LOCK_ID);
+		}
+	} while (true);
+}
+
+void mock_release()
+{
+	scheduler->schedule_next();
+	check(lock_status == 1, "lock status is not 1.");
+	lock_status = 0;
+	scheduler->signal_resource(LOCK_ID);
+}
+
+void nested_work(void* /*arg*/)
+{
+	scheduler->schedule_next();
+	nested_runs++;
+}
+
+void work(void* arg)
+{
+	int value = *static_cast<int*>(arg);
+	if (value == WORK_FIBER_1_ID)
+	{
+		// Fibers can launch other fibers.
+		check(scheduler->create_operation(NESTED_FIBER_ID, nested_work, nullptr) == ErrorCode::Success,
+			"failed to launch a nested fiber.");
+	}
+
+	mock_acquire();
+	shared_var = value;
+	scheduler->schedule_next();
+	check(shared_var == value, "shared variable was modified while holding the lock.");
+	mock_release();
+}
+
+void run_iteration()
+{
+	scheduler->attach();
+
+	int values[] = { WORK_FIBER_1_ID, WORK_FIBER_2_ID };
+	scheduler->create_resource(LOCK_ID);
+	scheduler->create_operation(WORK_FIBER_1_ID, work, &values[0]);
+	scheduler->create_operation(WORK_FIBER_2_ID, work, &values[1]);
+
+	scheduler->join_operation(WORK_FIBER_1_ID);
+	scheduler->join_operation(WORK_FIBER_2_ID);
+	scheduler->join_operation(NESTED_FIBER_ID);
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(failure.empty(), failure);
+}
+
+void blocked_work(void* /*arg*/)
+{
+	scheduler->wait_resource(LOCK_ID);
+}
+
+void run_deadlocked_iteration()
+{
+	scheduler->attach();
+
+	scheduler->create_resource(LOCK_ID);
+	scheduler->create_operation(WORK_FIBER_1_ID, blocked_work, nullptr);
+	assert(scheduler->join_operation(WORK_FIBER_1_ID), ErrorCode::DeadlockDetected);
+
+	scheduler->detach();
+
+	// The main operation blocks forever, so the fiber that completes last hands control back to it.
+	scheduler->attach();
+
+	scheduler->create_resource(LOCK_ID);
+	scheduler->create_operation(WORK_FIBER_1_ID, nested_work, nullptr);
+	assert(scheduler->wait_resource(LOCK_ID), ErrorCode::DeadlockDetected);
+
+	scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		assert(scheduler->set_handoff_engine(std::make_unique<FiberHandoff>()), ErrorCode::Success);
+		assert(scheduler->create_operation(WORK_FIBER_1_ID, work, nullptr), ErrorCode::ClientNotAttached);
+
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_iteration();
+
+			shared_var = 0;
+			lock_status = 0;
+		}
+
+		assert(nested_runs == 100, "nested fiber did not run in every iteration.");
+
+		run_deadlocked_iteration();
+
+		delete scheduler;
+
+		// Engines that run operations on their own threads cannot launch fibers.
+		scheduler = new Scheduler();
+		scheduler->attach();
+		assert(scheduler->create_operation(WORK_FIBER_1_ID, work, nullptr), ErrorCode::NotSupported);
+		scheduler->detach();
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
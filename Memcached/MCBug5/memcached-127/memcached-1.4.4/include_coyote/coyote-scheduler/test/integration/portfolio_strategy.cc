@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 5;
+constexpr auto NUM_ITERATIONS = 100;
+
+Scheduler* scheduler;
+
+// The id of the operation that took the first step of the iteration, or '0'.
+size_t first_operation_id;
+
+// Schedules the enabled operation with the lowest id, or the highest id if 'IsLast' is true.
+template <bool IsLast>
+class FixedStrategy : public Strategy
+{
+public:
+	size_t next_operation(Operations& operations)
+	{
+		const std::vector<size_t>& ops = operations.enabled_operation_ids();
+		return IsLast ? ops.back() : ops.front();
+	}
+
+	bool next_boolean()
+	{
+		return false;
+	}
+
+	int next_integer(int /*max_value*/)
+	{
+		return 0;
+	}
+
+	void prepare_next_iteration()
+	{
+	}
+
+	std::string get_description()
+	{
+		return "Fixed Strategy.";
+	}
+
+	bool is_fair()
+	{
+		return false;
+	}
+
+	size_t seed()
+	{
+		return 0;
+	}
+};
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	if (first_operation_id == 0)
+	{
+		first_operation_id = id;
+	}
+
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->complete_operation(id);
+}
+
+// Runs an iteration, and reports a bug if the second operation took the first step.
+void run_iteration()
+{
+	first_operation_id = 0;
+
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+
+	if (first_operation_id == WORK_THREAD_2_ID)
+	{
+		assert(scheduler->report_bug(), ErrorCode::Success);
+	}
+}
+
+// Only the strategy that schedules the second operation first finds the bug, so it gets most iterations.
+void test_allocation_by_yield()
+{
+	std::vector<std::unique_ptr<Strategy>> strategies;
+	strategies.push_back(std::make_unique<FixedStrategy<false>>());
+	strategies.push_back(std::make_unique<FixedStrategy<true>>());
+	auto strategy = std::make_unique<PortfolioStrategy>(std::move(strategies));
+	PortfolioStrategy* portfolio = strategy.get();
+	scheduler = new Scheduler(std::move(strategy));
+
+	for (int i = 0; i < NUM_ITERATIONS; i++)
+	{
+		run_iteration();
+	}
+
+	// The last iteration is rewarded once the next one is prepared.
+	run_iteration();
+	std::cout << "[test] ran " << portfolio->arm_iterations(0) << " iterations without the bug, and " <<
+		portfolio->arm_iterations(1) << " with the bug." << std::endl;
+	assert(portfolio->arm_iterations(0) + portfolio->arm_iterations(1) == NUM_ITERATIONS,
+		"the portfolio did not reward every iteration.");
+	assert(portfolio->arm_iterations(0) > 0, "the portfolio did not retry the strategy without the bug.");
+	assert(portfolio->arm_iterations(1) > NUM_ITERATIONS * 3 / 4, "the portfolio did not favor the strategy with the bug.");
+	delete scheduler;
+}
+
+// The fair PCT strategy of the default portfolio runs PCT for as many steps as the schedules take.
+void test_learned_prefix_length()
+{
+	auto strategy = std::make_unique<PortfolioStrategy>();
+	PortfolioStrategy* portfolio = strategy.get();
+	scheduler = new Scheduler(std::move(strategy));
+
+	for (int i = 0; i < 4; i++)
+	{
+		run_iteration();
+	}
+
+	const std::string description = portfolio->get_description();
+	const std::string prefix = "prefix path length is: ";
+	const size_t position = description.find(prefix);
+	assert(position != std::string::npos, "the portfolio has no fair PCT strategy.");
+
+	const size_t prefix_length = std::stoul(description.substr(position + prefix.size()));
+	assert(prefix_length >= 2 * NUM_STEPS && prefix_length < 4 * NUM_STEPS,
+		"the prefix length does not follow the schedule length.");
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_allocation_by_yield();
+		test_learned_prefix_length();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdint>
+#include <map>
+#include "test.h"
+#include "coyote/memory/arena.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		Arena arena(1024);
+		assert(arena.capacity() == 0, "unexpected capacity before allocating [0]");
+
+		void* first = arena.allocate(1, 1);
+		void* aligned = arena.allocate(8, 64);
+		assert(reinterpret_cast<uintptr_t>(aligned) % 64 == 0, "unexpected alignment [1]");
+		assert(arena.capacity() == 1024, "unexpected capacity after small allocations [1]");
+
+		// Allocations that do not fit the current block move to a new block.
+		arena.allocate(1000, 8);
+		assert(arena.capacity() == 2048, "unexpected capacity after filling a block [2]");
+
+		// Allocations that are larger than a block get a dedicated block.
+		void* large = arena.allocate(4096, 16);
+		assert(large != nullptr, "failed to allocate a large block [3]");
+		assert(arena.capacity() == 2048 + 4096 + 16, "unexpected capacity after a large allocation [3]");
+
+		// Resetting rewinds to the first block, and keeps all blocks for reuse.
+		arena.reset();
+		assert(arena.allocate(1, 1) == first, "memory was not reused after reset [4]");
+		arena.allocate(1000, 8);
+		arena.allocate(4096, 16);
+		assert(arena.capacity() == 2048 + 4096 + 16, "arena grew while reusing its blocks [4]");
+
+		for (int i = 0; i < 100; i++)
+		{
+			arena.reset();
+
+			std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>>* map =
+				arena.create<std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>>>(
+					ArenaAllocator<std::pair<const int, int>>(arena));
+			for (int j = 0; j < 50; j++)
+			{
+				(*map)[j] = i + j;
+			}
+
+			assert(map->size() == 50, "unexpected container size [5]");
+			assert(map->at(49) == i + 49, "unexpected container value [5]");
+		}
+
+		assert(arena.capacity() == 2048 + 4096 + 16, "arena grew while reusing its blocks [5]");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -34,24 +34,165 @@ int CT_main( int (*run_iteration)(int, char**), void (*reset_gloabs)(void), uint
 typedef struct pthread_create_params{
 	void *(*start_routine) (void *);
 	void* arg;
+	// Context of the thread that called pthread_create
+	FFI_context* ctx;
+	// Id of the controlled operation that runs the start routine
+	long unsigned operation_id;
 } pthread_c_params;
 
-// This function will be called in pthread_create
+// This function will be called by the pooled thread that runs a new operation
 void *coyote_new_thread_wrapper(void *p){
 
-	FFI_create_operation((long unsigned)pthread_self());
-	FFI_start_operation((long unsigned)pthread_self());
-
 	pthread_c_params* param = (pthread_c_params*)p;
 
+	// The new thread belongs to the same test harness as its creator
+	FFI_ctx_bind(param->ctx);
+
+	FFI_start_operation(param->operation_id);
+
 	FFI_schedule_next();
 	((param->start_routine))(param->arg);
 
-	FFI_complete_operation((long unsigned)pthread_self());
+	FFI_complete_operation(param->operation_id);
+
+	return NULL;
+}
+
+// This function will be called as the body of a fiber operation, if fibers are enabled
+void coyote_new_fiber_wrapper(void *p){
+
+	pthread_c_params* param = (pthread_c_params*)p;
+	((param->start_routine))(param->arg);
+
+	free(param);
+}
+
+/******************************************** Thread pool Start ******************************************/
+
+/* OS threads outlive the iterations. After an operation completes, its thread parks in
+*  this pool until pthread_create hands it the next operation, so the iterations do not
+*  pay for creating and tearing down the worker, maintainer, crawler and logger threads.
+*/
+typedef struct coyote_pooled_thread{
+	pthread_t thread;
+	// Signaled when the thread is handed a task
+	pthread_cond_t wakeup;
+	// Task that the thread runs, or NULL if it is parked
+	pthread_c_params* task;
+	// Context of the task, or NULL if the thread is parked
+	FFI_context* ctx;
+	// Operation id of the task in its context, or 0 if the thread is parked
+	long unsigned operation_id;
+	// Next thread in the list of all threads
+	struct coyote_pooled_thread* next;
+	// Next thread in the list of parked threads
+	struct coyote_pooled_thread* next_parked;
+} coyote_pooled_thread;
+
+// Protects all the fields of the pool and its threads
+static pthread_mutex_t thread_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+// Broadcasted whenever a thread finishes a task and parks
+static pthread_cond_t thread_pool_parked = PTHREAD_COND_INITIALIZER;
+// All the threads of the pool
+static coyote_pooled_thread* thread_pool_threads = NULL;
+// The threads that wait for a task
+static coyote_pooled_thread* thread_pool_parked_threads = NULL;
+
+// Body of the pooled threads, which run their tasks until the process exits
+static void *coyote_pooled_thread_main(void *p){
+
+	coyote_pooled_thread* self = (coyote_pooled_thread*)p;
+
+	pthread_mutex_lock(&thread_pool_lock);
+	while(true){
+
+		while(self->task == NULL){
+			pthread_cond_wait(&self->wakeup, &thread_pool_lock);
+		}
+
+		pthread_c_params* task = self->task;
+		pthread_mutex_unlock(&thread_pool_lock);
+
+		coyote_new_thread_wrapper((void*)task);
+		free(task);
+
+		pthread_mutex_lock(&thread_pool_lock);
+		self->task = NULL;
+		self->ctx = NULL;
+		self->operation_id = 0;
+		self->next_parked = thread_pool_parked_threads;
+		thread_pool_parked_threads = self;
+		pthread_cond_broadcast(&thread_pool_parked);
+	}
 
 	return NULL;
 }
 
+// Hands the task to a parked thread, or to a new thread if none is parked
+static int thread_pool_run(pthread_c_params* task){
+
+	pthread_mutex_lock(&thread_pool_lock);
+
+	coyote_pooled_thread* thread = thread_pool_parked_threads;
+	if(thread != NULL){
+		thread_pool_parked_threads = thread->next_parked;
+	} else {
+
+		thread = (coyote_pooled_thread*)malloc(sizeof(coyote_pooled_thread));
+		pthread_cond_init(&thread->wakeup, NULL);
+		thread->task = NULL;
+		thread->ctx = NULL;
+		thread->operation_id = 0;
+
+		// Pooled threads run with the default attributes, as memcached only asks for those
+		int ret = pthread_create(&thread->thread, NULL, coyote_pooled_thread_main, (void*)thread);
+		if(ret != 0){
+
+			pthread_mutex_unlock(&thread_pool_lock);
+			pthread_cond_destroy(&thread->wakeup);
+			free(thread);
+			return ret;
+		}
+
+		thread->next = thread_pool_threads;
+		thread_pool_threads = thread;
+	}
+
+	thread->task = task;
+	thread->ctx = task->ctx;
+	thread->operation_id = task->operation_id;
+	pthread_cond_signal(&thread->wakeup);
+
+	pthread_mutex_unlock(&thread_pool_lock);
+	return 0;
+}
+
+// Returns true if a pooled thread still runs the task of the specified operation of the context. Each
+// context allocates the same ids in every iteration, so the id alone does not identify the task
+static bool thread_pool_is_running(FFI_context* ctx, long unsigned operation_id){
+
+	for(coyote_pooled_thread* thread = thread_pool_threads; thread != NULL; thread = thread->next){
+		if(thread->ctx == ctx && thread->operation_id == operation_id){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Waits until the task of the specified operation of the context has returned and its thread has parked
+static void thread_pool_join(FFI_context* ctx, long unsigned operation_id){
+
+	pthread_mutex_lock(&thread_pool_lock);
+	while(thread_pool_is_running(ctx, operation_id)){
+		pthread_cond_wait(&thread_pool_parked, &thread_pool_lock);
+	}
+
+	pthread_mutex_unlock(&thread_pool_lock);
+}
+
+/******************************************** Thread pool End ******************************************/
+
 // Call our wrapper function instead of original parameters to pthread_create
 int FFI_pthread_create(void *tid, void *attr, void *(*start_routine) (void *), void* arguments){
 
@@ -63,8 +204,24 @@ int FFI_pthread_create(void *tid, void *attr, void *(*start_routine) (void *), v
 	pthread_c_params *p = (pthread_c_params *)malloc(sizeof(pthread_c_params));
 	p->start_routine = start_routine;
 	p->arg = arguments;
+	p->ctx = FFI_ctx_current();
+	// Pooled threads and fibers run many operations, so the operation gets its own id. The ids follow the
+	// order in which the iteration creates its operations, so they repeat in every iteration and process
+	p->operation_id = FFI_ctx_next_operation_id(p->ctx);
 
-	return pthread_create(tid, attr, coyote_new_thread_wrapper, (void*)p);
+	// The id of the operation stands in for the pthread id, which pooled threads share across operations
+	*(pthread_t*)tid = (pthread_t)p->operation_id;
+
+	if(FFI_fibers_enabled()){
+
+		// No OS thread is created, the new operation runs on the current thread until it yields
+		FFI_create_fiber_operation(p->operation_id, coyote_new_fiber_wrapper, (void*)p);
+		return 0;
+	}
+
+	// The operation is created before its thread starts, so it can be joined right away
+	FFI_create_operation(p->operation_id);
+	return thread_pool_run(p);
 }
 
 static bool stats_state_read = true;
@@ -104,7 +261,19 @@ void FFI_check_stats_data_race(bool isWrite){
 int FFI_pthread_join(pthread_t tid, void* arg){
 
 	FFI_join_operation((long unsigned) tid); // This is a machine & OS specific hack
-	return pthread_join(tid, arg);
+
+	if(arg != NULL){
+		*(void**)arg = NULL;
+	}
+
+	// Fiber operations have no OS thread to join
+	if(FFI_fibers_enabled()){
+		return 0;
+	}
+
+	// The pooled thread is not joined, as it parks for the next operation
+	thread_pool_join(FFI_ctx_current(), (long unsigned)tid);
+	return 0;
 }
 
 static int *stop_main = NULL;
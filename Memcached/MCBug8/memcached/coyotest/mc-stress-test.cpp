@@ -1431,43 +1431,123 @@ void store_to_file(int itr, int size){
 	file.close();
 }
 
-std::vector<uint64_t>* all_hv = NULL;
+// The scheduler keeps the set of reported states, so that strategies can prune schedules that reach known states
 void check_and_add(uint64_t hv, int itr){
 
-	if(all_hv == NULL){
-		all_hv = new std::vector<uint64_t>();
+	FFI_report_state(hv);
+	store_to_file(itr, FFI_distinct_state_count());
+}
+
+void print_and_clear_hvs(int total_iter){
+
+	printf("Total states %lu found in %d iterations\n", FFI_distinct_state_count(), total_iter);
+}
+
+// Allow printfs from main function
+#undef printf
+
+// Arguments of CT_main, kept for the worker processes of a parallel run
+static int (*ct_run_iteration)(int, char**) = NULL;
+static void (*ct_reset_all_globals)(void) = NULL;
+static uint64_t (*ct_get_program_state)(void) = NULL;
+static int ct_argc = 0;
+static char** ct_argv = NULL;
+
+// Wall-clock budget of the testing iterations in milliseconds, or 0 if they are only bounded by count
+static size_t ct_time_budget_ms = 0;
+
+// Number of testing iterations that this process has started
+static int ct_iteration_count = 0;
+
+// Runs one testing iteration, and returns true, as bugs in memcached crash the process
+static bool CT_run_iteration(){
+
+	const int j = ct_iteration_count++;
+
+	FILE *filePointer;
+	FFI_attach_scheduler();
+
+	printf("Starting iteration #%d seed: %lu \n", j, FFI_seed());
+
+	filePointer = fopen("coyote_output.txt", "a+");
+	fprintf(filePointer, "starting iteration: %d\n", j);
+	fclose(filePointer);
+
+	init_sockets();
+
+	ct_run_iteration(ct_argc, ct_argv);
+
+	// Take the hash of all the subsystems
+	uint64_t hash = ct_get_program_state();
+	check_and_add(hash, j);
+	printf("Hash of this iteration is %lu \n", hash);
+	printf("Number of OOMs found: %d \n", temp_counter);
+
+	ct_reset_all_globals(); // For resetting globals and libevent
+	FFI_free_all(); // For heap allocations
+
+	FFI_detach_scheduler();
+	FFI_scheduler_assert();
+
+	del_sockets(); // For resetting client connection sockets
+	return true;
+}
+
+// Runs the testing iterations using the scheduler created by the caller
+static void CT_run_iterations(int num_iter){
+
+	// Set COYOTE_FIBERS to run the threads of memcached as fibers on this thread
+	if(getenv("COYOTE_FIBERS") != NULL){
+		FFI_enable_fibers();
 	}
 
-	std::vector<uint64_t>::iterator it = std::find(all_hv->begin(), all_hv->end(), hv);
+	// Set COYOTE_FORK_AT_STEP to run the first iteration up to that many calls to FFI_schedule_next, such as
+	// past the startup of memcached, and to fork the other iterations from a snapshot of the process there.
+	// This runs the threads of memcached as fibers, as the children only inherit the thread that forks them.
+	if(getenv("COYOTE_FORK_AT_STEP") != NULL && num_iter > 1){
+		if(!FFI_fibers_enabled()){
+			FFI_enable_fibers();
+		}
+
+		FFI_enable_fork_server(strtoull(getenv("COYOTE_FORK_AT_STEP"), NULL, 10), num_iter - 1, FFI_seed() + 1);
+		num_iter = 1;
+	}
 
-	// If we havn't found this hv before, insert it!
-	if(it == all_hv->end()){
-		all_hv->push_back(hv);
+	// Set COYOTE_LIVELOCK_BOUND to fail iterations that take that many scheduling steps without a state change
+	if(getenv("COYOTE_LIVELOCK_BOUND") != NULL){
+		FFI_set_livelock_bound(strtoull(getenv("COYOTE_LIVELOCK_BOUND"), NULL, 10));
 	}
 
-	int total_size = all_hv->size();
-	store_to_file(itr, total_size);
-}
+	// Set COYOTE_METRICS to write the scheduler metrics of each iteration into that file, as JSON if it
+	// ends with '.json', else as CSV
+	const char* metrics_path = getenv("COYOTE_METRICS");
+	if(metrics_path != NULL){
+		FFI_enable_metrics();
+	}
 
-void print_and_clear_hvs(int total_iter){
+	// Lights, Camera, Action!
+	FFI_run_campaign(num_iter, ct_time_budget_ms, true, &CT_run_iteration, NULL);
 
-	assert(all_hv != NULL);
+	if(metrics_path != NULL){
+		FFI_dump_metrics(metrics_path);
+	}
 
-	printf("Total states %lu found in %d iterations\n", all_hv->size(), total_iter);
+	print_and_clear_hvs(ct_iteration_count);
+	FFI_delete_scheduler();
 
-	delete all_hv;
-	all_hv = NULL;
+	printf("We could find the OOM error %d number of times\n", temp_counter);
 }
 
-// Allow printfs from main function
-#undef printf
+// Entry point of each worker process forked by FFI_run_parallel
+static void CT_worker_main(size_t first_seed, size_t num_iterations){
+
+	FFI_create_scheduler_w_seed(first_seed);
+	CT_run_iterations(num_iterations);
+}
 
 // Test main method
 int CT_main( int (*run_iteration)(int, char**), void (*reset_all_globals)(void), uint64_t (get_program_state)(void), int argc, char** argv ){
 
-	//FFI_create_scheduler_w_seed(1603350760484341101);
-	FFI_create_scheduler();
-
 	int num_iter = 200;
 
 	char **new_argv = (char **)malloc(50 * sizeof(char *));
@@ -1475,44 +1555,50 @@ int CT_main( int (*run_iteration)(int, char**), void (*reset_all_globals)(void),
 		new_argv[i] = (char *)malloc(500 * sizeof(char));
 	}
 
-	int new_argc = set_options(argc, argv, new_argv);
+	ct_run_iteration = run_iteration;
+	ct_reset_all_globals = reset_all_globals;
+	ct_get_program_state = get_program_state;
+	ct_argc = set_options(argc, argv, new_argv);
+	ct_argv = new_argv;
 
-	FILE *filePointer;
-	// Lights, Camera, Action!
-	for(int j = 0; j < num_iter; j++){
-
-		FFI_attach_scheduler();
-
-		printf("Starting iteration #%d seed: %lu \n", j, FFI_seed());
+	// Set COYOTE_ITERATIONS to change the number of iterations, and COYOTE_TIME_BUDGET_MS to also stop
+	// the iterations once that many milliseconds have passed
+	if(getenv("COYOTE_ITERATIONS") != NULL){
+		num_iter = atoi(getenv("COYOTE_ITERATIONS"));
+	}
 
-		filePointer = fopen("coyote_output.txt", "a+");
-        	fprintf(filePointer, "starting iteration: %d\n", j);
-        	fclose(filePointer);
+	if(getenv("COYOTE_TIME_BUDGET_MS") != NULL){
+		ct_time_budget_ms = strtoull(getenv("COYOTE_TIME_BUDGET_MS"), NULL, 10);
+	}
 
-		init_sockets();
+	// Set COYOTE_WORKERS to split the iterations across that many worker processes
+	const char* workers = getenv("COYOTE_WORKERS");
+	if(workers != NULL && atoi(workers) > 1){
 
-		run_iteration(new_argc, new_argv);
+		size_t bug_seed = 0;
+		if(FFI_run_parallel(atoi(workers), num_iter, (size_t)time(NULL), &CT_worker_main, &bug_seed)){
+			printf("Found a bug in the iteration with seed: %lu\n", bug_seed);
+		}
+	} else if(getenv("COYOTE_REPLAY") != NULL){
 
-		// Take the hash of all the subsystems
-		uint64_t hash = get_program_state();
-		check_and_add(hash, j);
-		printf("Hash of this iteration is %lu \n", hash);
-		printf("Number of OOMs found: %d \n", temp_counter);
+		// Set COYOTE_REPLAY to a trace file recorded with COYOTE_TRACE to reproduce its iteration. The trace
+		// names threads by the ids that FFI_ctx_next_operation_id restarts at every attach, so a fresh process
+		// creates the same ids as the recorded iteration did
+		FFI_create_scheduler_replay(getenv("COYOTE_REPLAY"));
+		CT_run_iterations(1);
+	} else {
 
-		reset_all_globals(); // For resetting globals and libevent
-		FFI_free_all(); // For heap allocations
+		//FFI_create_scheduler_w_seed(1603350760484341101);
+		FFI_create_scheduler();
 
-		FFI_detach_scheduler();
-		FFI_scheduler_assert();
+		// Set COYOTE_TRACE to record the schedule of the latest iteration into that file
+		if(getenv("COYOTE_TRACE") != NULL){
+			FFI_record_trace(getenv("COYOTE_TRACE"));
+		}
 
-		del_sockets(); // For resetting client connection sockets
+		CT_run_iterations(num_iter);
 	}
 
-	FFI_delete_scheduler();
-	print_and_clear_hvs(num_iter);
-
-	printf("We could find the OOM error %d number of times\n", temp_counter);
-
 	for(int i = 0; i < 50; i++){
 		free(new_argv[i]);
 	}
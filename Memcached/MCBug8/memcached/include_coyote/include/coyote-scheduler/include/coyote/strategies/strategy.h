@@ -9,6 +9,27 @@
 
 namespace coyote
 {
+	// The resource or memory location that the next step of an operation accesses, as declared at the
+	// scheduling point that precedes the step. A step without a declared access can access anything.
+	struct StepAccess
+	{
+		// True if the step declared its access, else false.
+		bool is_declared;
+
+		// The id of the accessed resource, or the address of the accessed memory location.
+		size_t location;
+
+		// True if the step writes the location, else false if it only reads it.
+		bool is_write;
+
+		// Returns true if this step commutes with the specified step, because both declared their access
+		// and they access different locations, or only read the same one.
+		bool is_independent(const StepAccess& other) const noexcept
+		{
+			return is_declared && other.is_declared && (location != other.location || (!is_write && !other.is_write));
+		}
+	};
+
 	class Strategy
 	{
 
@@ -27,6 +48,30 @@ namespace coyote
 		// Prepares the next iteration.
 		virtual void prepare_next_iteration() = 0;
 
+		// Accounts for scheduling steps that the scheduler elided, because the operation with the specified
+		// id was the only enabled operation. Strategies that do not count steps can ignore them.
+		virtual void skip_steps(size_t /*operation_id*/, size_t /*count*/) {}
+
+		// Declares the access of the next step of the operation with the specified id, which paused at a
+		// scheduling point before the next choice. Strategies that do not reduce interleavings can ignore it.
+		virtual void declare_access(size_t /*operation_id*/, const StepAccess& /*access*/) {}
+
+		// Notifies that the current iteration reached a program state that was already reached before, so
+		// the choices that continue from it lead to known states. Strategies that do not prune can ignore it.
+		virtual void visit_known_state() {}
+
+		// Notifies that the current iteration reached a program state that was never reached before.
+		// Strategies that do not measure their coverage can ignore it.
+		virtual void visit_new_state() {}
+
+		// Notifies that the last iteration found a bug. This is called after the iteration, and before the
+		// next one is prepared. Strategies that do not measure their yield can ignore it.
+		virtual void report_bug() {}
+
+		// Restarts the choices of the current iteration from the specified seed, such as in a process forked
+		// from a snapshot of the iteration. Returns false if the strategy is not seeded.
+		virtual bool reseed(size_t /*seed*/) { return false; }
+
 		// Description about the strategy
 		virtual std::string get_description() = 0;
 
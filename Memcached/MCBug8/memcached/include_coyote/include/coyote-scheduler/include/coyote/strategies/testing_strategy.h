@@ -7,23 +7,40 @@
 #include "strategy.h"
 #include "combo_strategy.h"
 #include "portfolio_strategy.h"
+#include "Exhaustive/bounded_dfs_strategy.h"
 #include "Exhaustive/dfs_strategy.h"
+#include "Exhaustive/sleep_set_dfs_strategy.h"
 #include "Probabilistic/random_strategy.h"
 #include "Probabilistic/pct_strategy.h"
+#include "Probabilistic/pos_strategy.h"
 #include "Probabilistic/probabilistic_random.h"
+#include <memory>
 
 namespace coyote
 {
 	class TestingStrategy
 	{
 	private:
+		// The strategies whose nondeterministic choices are dispatched without a virtual call.
+		enum class StrategyKind
+		{
+			Random,
+			ProbabilisticRandom,
+			PCT,
+			Other
+		};
+
 		Strategy* strategy;
 
+		// The concrete type of 'strategy', if it is one of the devirtualized strategies.
+		StrategyKind kind = StrategyKind::Other;
+
 	public:
 		// Random Strategy
 		TestingStrategy(size_t seed)
 		{
 			strategy = new RandomStrategy(seed);
+			kind = StrategyKind::Random;
 		}
 
 		TestingStrategy(std::string strat)
@@ -32,17 +49,36 @@ namespace coyote
 			{
 				strategy = new DFSStrategy();
 			}
+			else if (strat.compare("SleepSetDFSStrategy") == 0)
+			{
+				strategy = new SleepSetDFSStrategy();
+			}
+			else if (strat.compare("PreemptionBoundedDFSStrategy") == 0)
+			{
+				strategy = new BoundedDFSStrategy(BoundedDFSStrategy::BoundKind::Preemption);
+			}
+			else if (strat.compare("DelayBoundedDFSStrategy") == 0)
+			{
+				strategy = new BoundedDFSStrategy(BoundedDFSStrategy::BoundKind::Delay);
+			}
 			else if (strat.compare("PCTStrategy") == 0)
 			{
 				strategy = new PCTStrategy();
+				kind = StrategyKind::PCT;
 			}
 			else if (strat.compare("RandomStrategy") == 0)
 			{
 				strategy = new RandomStrategy(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+				kind = StrategyKind::Random;
 			}
 			else if (strat.compare("ProbabilisticRandomStrategy") == 0)
 			{
 				strategy = new ProbabilisticRandomStrategy(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+				kind = StrategyKind::ProbabilisticRandom;
+			}
+			else if (strat.compare("POSStrategy") == 0)
+			{
+				strategy = new POSStrategy(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 			}
 			else if (strat.compare("PortfolioStrategy") == 0)
 			{
@@ -66,22 +102,49 @@ namespace coyote
 			}
 		}
 
+		// Takes ownership of the specified strategy, such as a 'ReplayStrategy'.
+		explicit TestingStrategy(std::unique_ptr<Strategy> custom_strategy) :
+			strategy(custom_strategy.release())
+		{
+		}
+
 		// Returns the next operation.
 		size_t next_operation(Operations& operations)
 		{
 			return strategy->next_operation(operations);
 		}
 
-		// Returns the next boolean choice.
+		// Returns the next boolean choice. The common strategies are called directly, so that their
+		// inline choice is compiled into the caller.
 		bool next_boolean()
 		{
-			return strategy->next_boolean();
+			switch (kind)
+			{
+			case StrategyKind::Random:
+				return static_cast<RandomStrategy*>(strategy)->RandomStrategy::next_boolean();
+			case StrategyKind::ProbabilisticRandom:
+				return static_cast<ProbabilisticRandomStrategy*>(strategy)->ProbabilisticRandomStrategy::next_boolean();
+			case StrategyKind::PCT:
+				return static_cast<PCTStrategy*>(strategy)->PCTStrategy::next_boolean();
+			default:
+				return strategy->next_boolean();
+			}
 		}
 
-		// Returns the next integer choice.
+		// Returns the next integer choice. The common strategies are called directly, like in 'next_boolean'.
 		int next_integer(int max_value)
 		{
-			return strategy->next_integer(max_value);
+			switch (kind)
+			{
+			case StrategyKind::Random:
+				return static_cast<RandomStrategy*>(strategy)->RandomStrategy::next_integer(max_value);
+			case StrategyKind::ProbabilisticRandom:
+				return static_cast<ProbabilisticRandomStrategy*>(strategy)->ProbabilisticRandomStrategy::next_integer(max_value);
+			case StrategyKind::PCT:
+				return static_cast<PCTStrategy*>(strategy)->PCTStrategy::next_integer(max_value);
+			default:
+				return strategy->next_integer(max_value);
+			}
 		}
 
 		// Prepares the next iteration.
@@ -90,6 +153,42 @@ namespace coyote
 			return strategy->prepare_next_iteration();
 		}
 
+		// Accounts for elided scheduling steps.
+		void skip_steps(size_t operation_id, size_t count)
+		{
+			strategy->skip_steps(operation_id, count);
+		}
+
+		// Declares the access of the next step of an operation.
+		void declare_access(size_t operation_id, const StepAccess& access)
+		{
+			strategy->declare_access(operation_id, access);
+		}
+
+		// Notifies that the current iteration reached a known program state.
+		void visit_known_state()
+		{
+			strategy->visit_known_state();
+		}
+
+		// Notifies that the current iteration reached a new program state.
+		void visit_new_state()
+		{
+			strategy->visit_new_state();
+		}
+
+		// Notifies that the last iteration found a bug.
+		void report_bug()
+		{
+			strategy->report_bug();
+		}
+
+		// Restarts the choices of the current iteration from the specified seed.
+		bool reseed(size_t seed)
+		{
+			return strategy->reseed(seed);
+		}
+
 		// Fair strategy or not
 		bool is_fair()
 		{
@@ -1,6 +1,7 @@
 ﻿// Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 
+#include <fstream>
 #include "ffi.h"
 #include "scheduler.h"
 
@@ -104,6 +105,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int schedule_next_access(void* scheduler, size_t location, bool is_write)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->schedule_next(location, is_write);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API bool next_boolean(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -116,6 +124,26 @@ extern "C"
         return ptr->next_integer(max_value);
     }
 
+    COYOTE_API int report_state(void* scheduler, size_t state_hash)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->report_state(state_hash);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int report_bug(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->report_bug();
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API size_t distinct_state_count(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->distinct_state_count();
+    }
+
     COYOTE_API size_t seed(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -129,6 +157,51 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int enable_metrics(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->enable_metrics();
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    // Returns the value of the metric with the specified 'Metric' value, summed over all completed iterations,
+    // or only for the last one. Returns 0 if metrics are disabled.
+    COYOTE_API uint64_t metric_value(void* scheduler, int metric, bool is_total)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        const SchedulerMetrics* metrics = ptr->get_metrics();
+        if (metrics == nullptr || metric < 0 || metric >= static_cast<int>(Metric::Count))
+        {
+            return 0;
+        }
+
+        return is_total ? metrics->total()[static_cast<Metric>(metric)] :
+            metrics->last_iteration()[static_cast<Metric>(metric)];
+    }
+
+    // Writes the collected metrics to the file at the specified path, as JSON or as CSV.
+    COYOTE_API int dump_metrics(void* scheduler, const char* path, bool is_json)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        const SchedulerMetrics* metrics = ptr->get_metrics();
+        if (metrics == nullptr)
+        {
+            return static_cast<std::underlying_type_t<ErrorCode>>(ErrorCode::NotSupported);
+        }
+
+        std::ofstream stream(path);
+        if (is_json)
+        {
+            metrics->write_json(stream);
+        }
+        else
+        {
+            metrics->write_csv(stream);
+        }
+
+        return static_cast<std::underlying_type_t<ErrorCode>>(stream ? ErrorCode::Success : ErrorCode::Failure);
+    }
+
     COYOTE_API int dispose_scheduler(void* scheduler)
     {
         try
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#if !defined(_WIN32)
+
+#include <cstdint>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "handoff/fiber_handoff.h"
+
+namespace coyote
+{
+	FiberHandoff::FiberHandoff(size_t stack_size) noexcept :
+		stack_size(stack_size),
+		carrier(nullptr)
+	{
+	}
+
+	FiberHandoff::~FiberHandoff()
+	{
+		release_fibers();
+		const size_t page_size = sysconf(_SC_PAGESIZE);
+		for (char* stack : free_stacks)
+		{
+			munmap(stack, stack_size + page_size);
+		}
+	}
+
+	void FiberHandoff::wait(Operation& op, std::unique_lock<std::mutex>& /*lock*/)
+	{
+		Fiber& fiber = get_fiber(op);
+		if (fiber.launcher == nullptr)
+		{
+			// The operation can only be resumed by another operation running on this thread, and none
+			// is left that can do so.
+			throw ErrorCode::DeadlockDetected;
+		}
+
+		// Return to the launcher, which continues from where it created this operation.
+		Fiber* launcher = fiber.launcher;
+		fiber.launcher = nullptr;
+		swapcontext(&fiber.context, &launcher->context);
+	}
+
+	void FiberHandoff::notify(Operation& /*op*/)
+	{
+		// Paused fibers are resumed only by 'handoff' and 'release', so there is nothing to wake.
+	}
+
+	void FiberHandoff::handoff(Operation& current, Operation& next, std::unique_lock<std::mutex>& /*lock*/)
+	{
+		Fiber& current_fiber = get_fiber(current);
+		Fiber& next_fiber = get_fiber(next);
+		swapcontext(&current_fiber.context, &next_fiber.context);
+	}
+
+	void FiberHandoff::release(Operation& /*completed*/, Operation& next, std::unique_lock<std::mutex>& /*lock*/)
+	{
+		setcontext(&get_fiber(next).context);
+	}
+
+	bool FiberHandoff::supports_launch()
+	{
+		return true;
+	}
+
+	void FiberHandoff::launch(Operation& current, Operation& op, std::function<void()> body,
+		std::unique_lock<std::mutex>& /*lock*/)
+	{
+		Fiber& current_fiber = get_fiber(current);
+
+		std::unique_ptr<Fiber> fiber = std::make_unique<Fiber>();
+		fiber->stack = allocate_stack();
+		fiber->body = std::move(body);
+		fiber->launcher = &current_fiber;
+		fiber->engine = this;
+
+		getcontext(&fiber->context);
+		fiber->context.uc_stack.ss_sp = fiber->stack + sysconf(_SC_PAGESIZE);
+		fiber->context.uc_stack.ss_size = stack_size;
+		fiber->context.uc_link = nullptr;
+
+		// The fiber pointer is split across two integer arguments, as 'makecontext' only portably
+		// passes 'int' sized arguments.
+		uint64_t address = reinterpret_cast<uintptr_t>(fiber.get());
+		makecontext(&fiber->context, reinterpret_cast<void (*)()>(&FiberHandoff::run), 2,
+			static_cast<unsigned int>(address >> 32), static_cast<unsigned int>(address & 0xffffffff));
+
+		Fiber& next_fiber = *fiber;
+		fibers[op.id] = std::move(fiber);
+		swapcontext(&current_fiber.context, &next_fiber.context);
+	}
+
+	void FiberHandoff::reset(std::unique_lock<std::mutex>& /*lock*/)
+	{
+		release_fibers();
+	}
+
+	void FiberHandoff::release_fibers()
+	{
+		for (auto& kvp : fibers)
+		{
+			if (kvp.second->stack != nullptr)
+			{
+				free_stacks.push_back(kvp.second->stack);
+			}
+		}
+
+		fibers.clear();
+		carrier = nullptr;
+	}
+
+	std::string FiberHandoff::get_description()
+	{
+		return "Fiber handoff.";
+	}
+
+	FiberHandoff::Fiber& FiberHandoff::get_fiber(const Operation& op)
+	{
+		auto it = fibers.find(op.id);
+		if (it != fibers.end())
+		{
+			return *it->second;
+		}
+
+		if (carrier != nullptr)
+		{
+			// Only one operation can run on the stack of the carrier thread.
+			throw ErrorCode::NotSupported;
+		}
+
+		std::unique_ptr<Fiber> fiber = std::make_unique<Fiber>();
+		fiber->stack = nullptr;
+		fiber->launcher = nullptr;
+		fiber->engine = this;
+		carrier = fiber.get();
+		fibers[op.id] = std::move(fiber);
+		return *carrier;
+	}
+
+	char* FiberHandoff::allocate_stack()
+	{
+		if (!free_stacks.empty())
+		{
+			char* stack = free_stacks.back();
+			free_stacks.pop_back();
+			return stack;
+		}
+
+		// Reserve an extra page below the stack as a guard, so that an overflow faults instead of
+		// silently corrupting the memory of another fiber.
+		const size_t page_size = sysconf(_SC_PAGESIZE);
+		void* memory = mmap(nullptr, stack_size + page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+			-1, 0);
+		if (memory == MAP_FAILED)
+		{
+			throw ErrorCode::Failure;
+		}
+
+		mprotect(memory, page_size, PROT_NONE);
+		return static_cast<char*>(memory);
+	}
+
+	void FiberHandoff::run(unsigned int high_bits, unsigned int low_bits)
+	{
+		Fiber* fiber = reinterpret_cast<Fiber*>(static_cast<uintptr_t>(
+			(static_cast<uint64_t>(high_bits) << 32) | low_bits));
+		fiber->body();
+
+		// The body only returns if no other operation could be scheduled after it completed, so give
+		// control back to the carrier thread, which reports the error.
+		setcontext(&fiber->engine->carrier->context);
+	}
+}
+
+#endif // !_WIN32
@@ -0,0 +1,217 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include "error_code.h"
+#include "resources/resource_table.h"
+
+namespace coyote
+{
+	ResourceWaiters::ResourceWaiters() noexcept :
+		spilled_indices(nullptr),
+		count(0),
+		capacity(INLINE_CAPACITY)
+	{
+	}
+
+	void ResourceWaiters::insert(size_t operation_index, Arena& arena)
+	{
+		size_t* indices = data();
+		if (std::find(indices, indices + count, operation_index) != indices + count)
+		{
+			return;
+		}
+
+		if (count == capacity)
+		{
+			// Spill into the arena. The previous storage is released when the arena resets.
+			size_t* new_indices = static_cast<size_t*>(arena.allocate(2 * capacity * sizeof(size_t), alignof(size_t)));
+			std::memcpy(new_indices, indices, count * sizeof(size_t));
+			spilled_indices = new_indices;
+			capacity *= 2;
+			indices = new_indices;
+		}
+
+		indices[count] = operation_index;
+		count += 1;
+	}
+
+	bool ResourceWaiters::erase(size_t operation_index) noexcept
+	{
+		size_t* indices = data();
+		size_t* it = std::find(indices, indices + count, operation_index);
+		if (it == indices + count)
+		{
+			return false;
+		}
+
+		// Shift the later waiters, so that the waiters stay in the order in which they started waiting.
+		std::copy(it + 1, indices + count, it);
+		count -= 1;
+		return true;
+	}
+
+	void ResourceWaiters::clear() noexcept
+	{
+		count = 0;
+	}
+
+	size_t ResourceWaiters::size() const noexcept
+	{
+		return count;
+	}
+
+	const size_t* ResourceWaiters::begin() const noexcept
+	{
+		return spilled_indices != nullptr ? spilled_indices : inline_indices;
+	}
+
+	const size_t* ResourceWaiters::end() const noexcept
+	{
+		return begin() + count;
+	}
+
+	size_t* ResourceWaiters::data() noexcept
+	{
+		return spilled_indices != nullptr ? spilled_indices : inline_indices;
+	}
+
+	ResourceTable::ResourceTable(Arena& arena) noexcept :
+		generation(1),
+		count(0),
+		arena(arena)
+	{
+	}
+
+	void ResourceTable::insert(size_t resource_id)
+	{
+		if ((count + 1) * 2 > entries.size())
+		{
+			grow();
+		}
+
+		const size_t bucket = find_bucket(resource_id);
+		if (entries[bucket].generation == generation)
+		{
+			throw ErrorCode::DuplicateResource;
+		}
+
+		entries[bucket].id = resource_id;
+		entries[bucket].generation = generation;
+		entries[bucket].waiters = ResourceWaiters();
+		count += 1;
+	}
+
+	ResourceWaiters& ResourceTable::at(size_t resource_id)
+	{
+		if (count > 0)
+		{
+			const size_t bucket = find_bucket(resource_id);
+			if (entries[bucket].generation == generation)
+			{
+				return entries[bucket].waiters;
+			}
+		}
+
+		throw ErrorCode::NotExistingResource;
+	}
+
+	void ResourceTable::add_waiter(size_t resource_id, size_t operation_index)
+	{
+		at(resource_id).insert(operation_index, arena);
+	}
+
+	void ResourceTable::erase(size_t resource_id)
+	{
+		size_t bucket = count > 0 ? find_bucket(resource_id) : 0;
+		if (count == 0 || entries[bucket].generation != generation)
+		{
+			throw ErrorCode::NotExistingResource;
+		}
+
+		// Backward shift deletion: move later entries of the probe sequence into the hole, so that lookups
+		// never need tombstones.
+		const size_t mask = entries.size() - 1;
+		size_t next = bucket;
+		while (true)
+		{
+			next = (next + 1) & mask;
+			if (entries[next].generation != generation)
+			{
+				break;
+			}
+
+			const size_t home = home_bucket(entries[next].id);
+			const bool is_movable = bucket <= next ?
+				(home <= bucket || home > next) :
+				(home <= bucket && home > next);
+			if (is_movable)
+			{
+				entries[bucket] = entries[next];
+				bucket = next;
+			}
+		}
+
+		entries[bucket].generation = 0;
+		count -= 1;
+	}
+
+	size_t ResourceTable::size() const noexcept
+	{
+		return count;
+	}
+
+	void ResourceTable::clear() noexcept
+	{
+		count = 0;
+		generation += 1;
+		if (generation == 0)
+		{
+			// The generation wrapped around, so stale buckets could look filled again.
+			for (auto& entry : entries)
+			{
+				entry.generation = 0;
+			}
+
+			generation = 1;
+		}
+	}
+
+	size_t ResourceTable::find_bucket(size_t resource_id) const noexcept
+	{
+		const size_t mask = entries.size() - 1;
+		size_t bucket = home_bucket(resource_id);
+		while (entries[bucket].generation == generation && entries[bucket].id != resource_id)
+		{
+			bucket = (bucket + 1) & mask;
+		}
+
+		return bucket;
+	}
+
+	size_t ResourceTable::home_bucket(size_t resource_id) const noexcept
+	{
+		// Resource ids are often addresses of lock objects, so fold the upper half into the lower bits.
+		const uint64_t hash = static_cast<uint64_t>(resource_id) * 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(hash ^ (hash >> 32)) & (entries.size() - 1);
+	}
+
+	void ResourceTable::grow()
+	{
+		std::vector<Entry> old_entries(entries.empty() ? 16 : entries.size() * 2);
+		old_entries.swap(entries);
+		for (auto& entry : entries)
+		{
+			entry.generation = 0;
+		}
+
+		for (auto& entry : old_entries)
+		{
+			if (entry.generation == generation)
+			{
+				entries[find_bucket(entry.id)] = entry;
+			}
+		}
+	}
+}
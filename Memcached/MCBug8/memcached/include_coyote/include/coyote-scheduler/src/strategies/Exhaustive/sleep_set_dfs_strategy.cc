@@ -0,0 +1,228 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "strategies/Exhaustive/sleep_set_dfs_strategy.h"
+#include <algorithm>
+
+constexpr auto TRUE_CHOICE = 1;
+constexpr auto DEFAULT_MAX_INTEGER_CHOICES = 64;
+
+namespace coyote
+{
+	SleepSetDFSStrategy::SleepSetDFSStrategy() noexcept :
+		SleepSetDFSStrategy((size_t)DEFAULT_MAX_INTEGER_CHOICES)
+	{
+	}
+
+	SleepSetDFSStrategy::SleepSetDFSStrategy(size_t max_integer_choices) noexcept :
+		SchIndex(0),
+		is_sleep_blocked(false),
+		max_integer_choices(max_integer_choices)
+	{
+	}
+
+	size_t SleepSetDFSStrategy::next_choice(const std::vector<size_t>& choices)
+	{
+		if (this->SchIndex < this->frames.size())
+		{
+			// Replay the choice of the previous iteration.
+			return current_choice(this->frames[this->SchIndex++]);
+		}
+
+		Frame& frame = push_frame(true, 0);
+		if (!this->is_sleep_blocked)
+		{
+			for (const size_t& operation_id : choices)
+			{
+				bool is_sleeping = false;
+				for (const auto& sleeping_operation : frame.sleep_set)
+				{
+					if (sleeping_operation.first == operation_id)
+					{
+						is_sleeping = true;
+						break;
+					}
+				}
+
+				if (!is_sleeping)
+				{
+					auto it = this->next_accesses.find(operation_id);
+					frame.choices.push_back(operation_id);
+					frame.accesses.push_back(it != this->next_accesses.end() ? it->second : StepAccess{ false, 0, false });
+				}
+			}
+
+			frame.count = frame.choices.size();
+
+			// Every enabled operation sleeps, so the rest of the iteration is equivalent to an explored one.
+			this->is_sleep_blocked = frame.count == 0;
+		}
+
+		if (this->is_sleep_blocked)
+		{
+			// Continue with forced choices, which the next iterations do not backtrack to.
+			frame.count = 1;
+			frame.choices.assign(1, choices.front());
+			frame.accesses.assign(1, StepAccess{ false, 0, false });
+			frame.sleep_set.clear();
+		}
+
+		return current_choice(this->frames[this->SchIndex++]);
+	}
+
+	// Once the iteration is equivalent to an explored one, value choices are forced to their first value.
+	size_t SleepSetDFSStrategy::next_choice(size_t count)
+	{
+		if (this->SchIndex < this->frames.size())
+		{
+			// Replay the choice of the previous iteration.
+			return current_choice(this->frames[this->SchIndex++]);
+		}
+
+		push_frame(false, this->is_sleep_blocked ? 1 : count);
+		return current_choice(this->frames[this->SchIndex++]);
+	}
+
+	SleepSetDFSStrategy::Frame& SleepSetDFSStrategy::push_frame(bool is_operation_choice, size_t count)
+	{
+		Frame frame;
+		frame.is_operation_choice = is_operation_choice;
+		frame.count = count;
+		frame.index = 0;
+		if (!this->is_sleep_blocked && !this->frames.empty())
+		{
+			inherit_sleep_set(frame);
+		}
+
+		this->frames.push_back(std::move(frame));
+		return this->frames.back();
+	}
+
+	size_t SleepSetDFSStrategy::current_choice(const Frame& frame) const
+	{
+		if (frame.is_operation_choice)
+		{
+			return frame.choices[frame.index];
+		}
+
+		return frame.index;
+	}
+
+	// An operation sleeps at a new scheduling point if it slept at the previous point, or if its subtree was
+	// explored there, and its next step is independent of the step that the previous point chose. Value
+	// choices are made within the step of the scheduled operation, so they keep the sleep set unchanged.
+	void SleepSetDFSStrategy::inherit_sleep_set(Frame& frame) const
+	{
+		const Frame& parent = this->frames.back();
+		if (!parent.is_operation_choice)
+		{
+			frame.sleep_set = parent.sleep_set;
+			return;
+		}
+
+		const StepAccess& access = parent.accesses[parent.index];
+		for (const auto& sleeping_operation : parent.sleep_set)
+		{
+			if (sleeping_operation.second.is_independent(access))
+			{
+				frame.sleep_set.push_back(sleeping_operation);
+			}
+		}
+
+		for (size_t i = 0; i < parent.index; i++)
+		{
+			if (parent.accesses[i].is_independent(access))
+			{
+				frame.sleep_set.emplace_back(parent.choices[i], parent.accesses[i]);
+			}
+		}
+	}
+
+	size_t SleepSetDFSStrategy::next_operation(Operations& operations)
+	{
+		return next_choice(operations.enabled_operation_ids());
+	}
+
+	bool SleepSetDFSStrategy::next_boolean()
+	{
+		return next_choice((size_t)2) == TRUE_CHOICE;
+	}
+
+	// The values are enumerated lazily from the frame, so a large 'max_value' costs no memory, but only its
+	// lowest 'max_integer_choices' values are explored.
+	int SleepSetDFSStrategy::next_integer(int max_value)
+	{
+		if (max_value <= 0 || this->max_integer_choices == 0)
+		{
+			return 0;
+		}
+
+		return (int)next_choice(std::min((size_t)max_value, this->max_integer_choices));
+	}
+
+	void SleepSetDFSStrategy::declare_access(size_t operation_id, const StepAccess& access)
+	{
+		this->next_accesses[operation_id] = access;
+	}
+
+	// The elided points did not declare their accesses, so the step that the last operation choice scheduled
+	// ran through steps that can access anything. Its access becomes undeclared, so it depends on every step,
+	// and the value choices made during it keep no operation asleep.
+	void SleepSetDFSStrategy::skip_steps(size_t operation_id, size_t /*count*/)
+	{
+		for (size_t i = this->SchIndex; i > 0; i--)
+		{
+			Frame& frame = this->frames[i - 1];
+			if (!frame.is_operation_choice)
+			{
+				continue;
+			}
+
+			if (frame.choices[frame.index] == operation_id)
+			{
+				frame.accesses[frame.index] = StepAccess{ false, 0, false };
+				for (size_t j = i; j < this->SchIndex; j++)
+				{
+					this->frames[j].sleep_set.clear();
+				}
+			}
+
+			break;
+		}
+	}
+
+	// Advances the last scheduling point that has choices left to explore, and drops the points after it.
+	void SleepSetDFSStrategy::prepare_next_iteration()
+	{
+		this->SchIndex = 0;
+		this->is_sleep_blocked = false;
+		this->next_accesses.clear();
+
+		while (!this->frames.empty())
+		{
+			Frame& frame = this->frames.back();
+			frame.index++;
+			if (frame.index < frame.count)
+			{
+				break;
+			}
+
+			this->frames.pop_back();
+		}
+	}
+
+	size_t SleepSetDFSStrategy::seed()
+	{
+		return 0;
+	}
+
+	bool SleepSetDFSStrategy::is_fair()
+	{
+		return false;
+	}
+
+	std::string SleepSetDFSStrategy::get_description()
+	{
+		return "Sleep set DFS Strategy.";
+	}
+}
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <fstream>
+#include <iterator>
+#include "error_code.h"
+#include "strategies/replay_strategy.h"
+
+namespace coyote
+{
+	// Reads a little-endian unsigned integer of the specified width from the trace header.
+	static uint64_t read_header_field(const std::vector<unsigned char>& bytes, size_t offset, size_t width)
+	{
+		uint64_t value = 0;
+		for (size_t i = 0; i < width; i++)
+		{
+			value |= static_cast<uint64_t>(bytes[offset + i]) << (8 * i);
+		}
+
+		return value;
+	}
+
+	ReplayStrategy::ReplayStrategy(const std::string& path) :
+		cursor(0),
+		is_diverged(false)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+		{
+			throw ErrorCode::Failure;
+		}
+
+		std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (bytes.size() < TraceFormat::HEADER_SIZE ||
+			read_header_field(bytes, 0, 4) != TraceFormat::MAGIC ||
+			read_header_field(bytes, 4, 4) != TraceFormat::VERSION)
+		{
+			throw ErrorCode::Failure;
+		}
+
+		const uint64_t payload_size = read_header_field(bytes, TraceFormat::PAYLOAD_SIZE_OFFSET, 8);
+		if (payload_size > bytes.size() - TraceFormat::HEADER_SIZE)
+		{
+			throw ErrorCode::Failure;
+		}
+
+		const size_t end = TraceFormat::HEADER_SIZE + static_cast<size_t>(payload_size);
+		size_t position = TraceFormat::HEADER_SIZE;
+		while (position < end)
+		{
+			uint64_t encoded = 0;
+			for (size_t shift = 0; ; shift += 7)
+			{
+				if (position == end || shift >= 64)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				const unsigned char byte = bytes[position++];
+				encoded |= static_cast<uint64_t>(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					break;
+				}
+			}
+
+			const uint64_t kind = encoded & 3;
+			if (kind > static_cast<uint64_t>(TraceDecision::Integer))
+			{
+				throw ErrorCode::Failure;
+			}
+
+			decisions.push_back({ static_cast<TraceDecision>(kind), static_cast<size_t>(encoded >> 2) });
+		}
+	}
+
+	size_t ReplayStrategy::next_operation(Operations& operations)
+	{
+		// Forced decisions are not recorded, so that a trace replays with or without scheduling elision.
+		if (operations.size() == 1)
+		{
+			return operations[0];
+		}
+
+		size_t operation_id = 0;
+		if (!next_decision(TraceDecision::Operation, operation_id))
+		{
+			throw ErrorCode::ReplayDiverged;
+		}
+
+		for (size_t i = 0; i < operations.size(); i++)
+		{
+			if (operations[i] == operation_id)
+			{
+				return operation_id;
+			}
+		}
+
+		// The recorded operation is not enabled in this execution.
+		is_diverged = true;
+		throw ErrorCode::ReplayDiverged;
+	}
+
+	size_t ReplayStrategy::size() const noexcept
+	{
+		return decisions.size();
+	}
+
+	bool ReplayStrategy::diverged() const noexcept
+	{
+		return is_diverged;
+	}
+
+	void ReplayStrategy::prepare_next_iteration()
+	{
+		cursor = 0;
+		is_diverged = false;
+	}
+
+	std::string ReplayStrategy::get_description()
+	{
+		return "Replay Strategy.";
+	}
+
+	bool ReplayStrategy::is_fair()
+	{
+		return false;
+	}
+
+	size_t ReplayStrategy::seed()
+	{
+		return 0;
+	}
+}
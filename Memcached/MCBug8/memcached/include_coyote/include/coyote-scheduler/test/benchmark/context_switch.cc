@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <memory>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/handoff/baton_handoff.h"
+#include "coyote/handoff/condition_variable_handoff.h"
+#include "coyote/handoff/fiber_handoff.h"
+
+using namespace coyote;
+
+// Total number of scheduling decisions that each configuration performs, split across its operations.
+constexpr size_t TOTAL_STEPS = 200000;
+
+Scheduler* scheduler;
+
+size_t steps_per_operation;
+size_t last_operation_id;
+size_t context_switches;
+
+void run_steps(size_t id)
+{
+	for (size_t i = 0; i < steps_per_operation; i++)
+	{
+		scheduler->schedule_next();
+		if (last_operation_id != id)
+		{
+			last_operation_id = id;
+			context_switches++;
+		}
+	}
+}
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	run_steps(id);
+	scheduler->complete_operation(id);
+}
+
+void fiber_work(void* arg)
+{
+	run_steps(*static_cast<size_t*>(arg));
+}
+
+void run_iteration(size_t num_operations, bool use_fibers)
+{
+	scheduler->attach();
+
+	std::vector<size_t> ids(num_operations + 1);
+	std::vector<std::unique_ptr<std::thread>> threads;
+	for (size_t i = 1; i <= num_operations; i++)
+	{
+		ids[i] = i;
+		if (use_fibers)
+		{
+			scheduler->create_operation(i, fiber_work, &ids[i]);
+		}
+		else
+		{
+			scheduler->create_operation(i);
+			threads.push_back(std::make_unique<std::thread>(work, i));
+		}
+	}
+
+	for (size_t i = 1; i <= num_operations; i++)
+	{
+		scheduler->join_operation(i);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread->join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void run(std::unique_ptr<HandoffEngine> engine, size_t num_operations)
+{
+	scheduler = new Scheduler((size_t)42);
+	std::string description = engine->get_description();
+	bool use_fibers = engine->supports_launch();
+	assert(scheduler->set_handoff_engine(std::move(engine)), ErrorCode::Success);
+
+	steps_per_operation = TOTAL_STEPS / num_operations;
+	last_operation_id = 0;
+	context_switches = 0;
+
+	auto start_time = std::chrono::steady_clock::now();
+	run_iteration(num_operations, use_fibers);
+	auto end_time = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end_time - start_time).count();
+
+	std::cout << "[benchmark] " << description << " " << num_operations << " operations: " <<
+		(size_t)(context_switches / seconds) << " context switches/sec, " <<
+		(size_t)(steps_per_operation * num_operations / seconds) << " decisions/sec." << std::endl;
+	delete scheduler;
+}
+
+// Measures how many context switches per second the scheduler sustains with each handoff engine,
+// when between 2 and 64 operations repeatedly call 'schedule_next' under the random strategy.
+int main()
+{
+	std::cout << "[benchmark] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		for (size_t num_operations = 2; num_operations <= 64; num_operations *= 2)
+		{
+			run(std::make_unique<ConditionVariableHandoff>(), num_operations);
+			run(std::make_unique<BatonHandoff>(), num_operations);
+			run(std::make_unique<FiberHandoff>(), num_operations);
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[benchmark] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[benchmark] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <set>
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 2;
+constexpr auto MAX_ITERATIONS = 10000;
+
+Scheduler* scheduler;
+
+// The counter that both operations increment without a lock.
+int counter;
+
+// The scheduling decisions of the current iteration.
+std::string schedule;
+
+// Records the decisions of an exhaustive strategy.
+template <typename StrategyT>
+class RecordingStrategy : public StrategyT
+{
+public:
+	using StrategyT::StrategyT;
+
+	size_t next_operation(Operations& operations) override
+	{
+		const size_t operation_id = StrategyT::next_operation(operations);
+		schedule += std::to_string(operation_id);
+		return operation_id;
+	}
+};
+
+// The explored schedules of a strategy, and the first one that lost an increment.
+struct Exploration
+{
+	std::set<std::string> schedules;
+	size_t iterations = 0;
+	size_t bug_iteration = 0;
+	size_t bug_bound = 0;
+};
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	for (int step = 0; step < NUM_STEPS; step++)
+	{
+		int value = counter;
+		scheduler->schedule_next();
+		counter = value + 1;
+		scheduler->schedule_next();
+	}
+
+	scheduler->complete_operation(id);
+}
+
+// Runs an iteration, and returns true if no increment was lost.
+bool run_iteration()
+{
+	counter = 0;
+	schedule.clear();
+
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return counter == 2 * NUM_STEPS;
+}
+
+// Records the schedule of the iteration that just completed with the specified bound.
+void record_iteration(Exploration& exploration, bool is_correct, size_t bound)
+{
+	exploration.schedules.insert(schedule);
+	exploration.iterations++;
+	if (!is_correct && exploration.bug_iteration == 0)
+	{
+		exploration.bug_iteration = exploration.iterations;
+		exploration.bug_bound = bound;
+	}
+}
+
+// Runs DFS until it starts over with the first schedule.
+Exploration explore_dfs()
+{
+	Exploration exploration;
+	scheduler = new Scheduler(std::make_unique<RecordingStrategy<DFSStrategy>>());
+
+	std::string first_schedule;
+	while (exploration.iterations < MAX_ITERATIONS)
+	{
+		const bool is_correct = run_iteration();
+		if (schedule == first_schedule)
+		{
+			break;
+		}
+		else if (first_schedule.empty())
+		{
+			first_schedule = schedule;
+		}
+
+		record_iteration(exploration, is_correct, 0);
+	}
+
+	assert(exploration.iterations < MAX_ITERATIONS, "DFS did not start over.");
+	delete scheduler;
+	return exploration;
+}
+
+// Runs the bounded strategy until it starts over from bound 0.
+Exploration explore_bounded(BoundedDFSStrategy::BoundKind bound_kind)
+{
+	Exploration exploration;
+	auto strategy = std::make_unique<RecordingStrategy<BoundedDFSStrategy>>(bound_kind);
+	BoundedDFSStrategy* bounded_strategy = strategy.get();
+	scheduler = new Scheduler(std::move(strategy));
+
+	size_t bound = 0;
+	while (exploration.iterations < MAX_ITERATIONS)
+	{
+		const bool is_correct = run_iteration();
+		if (bounded_strategy->bound() < bound)
+		{
+			break;
+		}
+
+		bound = bounded_strategy->bound();
+		record_iteration(exploration, is_correct, bound);
+	}
+
+	assert(exploration.iterations < MAX_ITERATIONS, "the bounded strategy did not start over.");
+	assert(bound > 0, "the bounded strategy did not raise its bound.");
+	delete scheduler;
+	return exploration;
+}
+
+void test_bounded_exploration(BoundedDFSStrategy::BoundKind bound_kind, const Exploration& dfs_exploration)
+{
+	const Exploration exploration = explore_bounded(bound_kind);
+	std::cout << "[test] found the lost increment after " << exploration.bug_iteration << " of " <<
+		exploration.iterations << " schedules, with bound " << exploration.bug_bound << "." << std::endl;
+
+	// The lost increment needs one preemption, or one delay, between the read and the write of an operation.
+	assert(exploration.bug_iteration > 0, "the bounded strategy did not find the lost increment.");
+	assert(exploration.bug_bound == 1, "the bounded strategy did not find the lost increment with bound 1.");
+	assert(exploration.bug_iteration * 10 < dfs_exploration.iterations,
+		"the bounded strategy explored too many schedules before the lost increment.");
+
+	// Iterative deepening explores the schedules of the lower bounds again, but no other schedule.
+	assert(exploration.schedules == dfs_exploration.schedules,
+		"the bounded strategy did not explore the same schedules as DFS.");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		const Exploration dfs_exploration = explore_dfs();
+		std::cout << "[test] DFS found the lost increment after " << dfs_exploration.bug_iteration << " of " <<
+			dfs_exploration.iterations << " schedules." << std::endl;
+		assert(dfs_exploration.bug_iteration > 0, "DFS did not find the lost increment.");
+
+		test_bounded_exploration(BoundedDFSStrategy::BoundKind::Preemption, dfs_exploration);
+		test_bounded_exploration(BoundedDFSStrategy::BoundKind::Delay, dfs_exploration);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdlib>
+#include <thread>
+#include "test.h"
+#include "coyote/runners/parallel_runner.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+void work(size_t id)
+{
+	scheduler->start_operation(id);
+	int value = shared_var;
+	scheduler->schedule_next();
+	shared_var = value + 1;
+	scheduler->complete_operation(id);
+}
+
+// Runs a racy increment, and returns true if the race was exposed.
+bool run_iteration()
+{
+	shared_var = 0;
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return shared_var != 2;
+}
+
+// Runs the iterations of a worker, and reports the iteration with the specified seed as buggy.
+void run_worker(ParallelWorker& worker, size_t buggy_seed, bool crash)
+{
+	scheduler = new Scheduler(worker.first_seed);
+	for (size_t i = 0; i < worker.num_iterations; i++)
+	{
+		size_t seed = worker.start_iteration();
+		run_iteration();
+		if (seed == buggy_seed && crash)
+		{
+			std::abort();
+		}
+
+		worker.complete_iteration(seed == buggy_seed);
+	}
+
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		ParallelRunner runner(4, 42, 100);
+		assert(runner.run([](ParallelWorker& worker) { run_worker(worker, 0, false); }), ErrorCode::Success);
+		assert(!runner.bug_found(), "found a bug in a correct run.");
+		assert(runner.completed_iterations() == 42, "not all iterations completed.");
+
+		assert(runner.run([](ParallelWorker& worker) { run_worker(worker, 117, false); }), ErrorCode::Success);
+		assert(runner.bug_found(), "did not find the reported bug.");
+		assert(runner.bug_seed() == 117, "reported the wrong bug seed.");
+
+		assert(runner.run([](ParallelWorker& worker) { run_worker(worker, 123, true); }), ErrorCode::Success);
+		assert(runner.bug_found(), "did not find the crash.");
+		assert(runner.bug_seed() == 123, "reported the wrong crash seed.");
+
+		// The race is exposed by some seeds, and each worker uses the seeds of its own range.
+		ParallelRunner race_runner(4, 100, 0);
+		assert(race_runner.run([](ParallelWorker& worker) {
+			scheduler = new Scheduler(worker.first_seed);
+			for (size_t i = 0; i < worker.num_iterations; i++)
+			{
+				worker.start_iteration();
+				worker.complete_iteration(run_iteration());
+			}
+
+			delete scheduler;
+		}), ErrorCode::Success);
+		assert(race_runner.bug_found(), "did not find the race.");
+		assert(race_runner.bug_seed() < 100, "reported a seed outside of the budget.");
+
+		assert(ParallelRunner(0, 10, 0).run([](ParallelWorker& /*worker*/) {}), ErrorCode::Failure);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
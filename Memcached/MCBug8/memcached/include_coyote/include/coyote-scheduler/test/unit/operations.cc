@@ -97,6 +97,27 @@ int main()
 	assert(ops.size() == 0, "unexpected enabled size [15]");
 	assert(ops.size(false) == 0, "unexpected disabled size [15]");
 
+	ops.insert(9);
+	ops.insert(2);
+	ops.insert(6);
+	ops.disable(2);
+	assert(ops.enabled_operation_ids().size() == 2, "unexpected enabled view size [16]");
+	assert(ops.enabled_operation_ids()[0] == 6, "unexpected element in enabled view index 0 [16]");
+	assert(ops.enabled_operation_ids()[1] == 9, "unexpected element in enabled view index 1 [16]");
+
+	ops.enable(2);
+	assert(ops.enabled_operation_ids().size() == 3, "unexpected enabled view size [17]");
+	assert(ops.enabled_operation_ids()[0] == 2, "unexpected element in enabled view index 0 [17]");
+	assert(ops.enabled_operation_ids()[1] == 6, "unexpected element in enabled view index 1 [17]");
+	assert(ops.enabled_operation_ids()[2] == 9, "unexpected element in enabled view index 2 [17]");
+
+	ops.remove(6);
+	ops.disable(7);
+	assert(ops.enabled_operation_ids().size() == 2, "unexpected enabled view size [18]");
+	assert(ops.enabled_operation_ids()[1] == 9, "unexpected element in enabled view index 1 [18]");
+
+	ops.clear();
+
 	for (size_t i = 0; i < 10000; i++)
 	{
 		ops.insert(i + 7);
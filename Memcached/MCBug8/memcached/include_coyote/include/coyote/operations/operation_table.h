@@ -0,0 +1,114 @@
+﻿// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_OPERATION_TABLE_H
+#define COYOTE_OPERATION_TABLE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "operation.h"
+#include "operation_status.h"
+
+namespace coyote
+{
+	// Dense slot map of the operations of the current iteration. Each operation is addressed by a compact
+	// slot index that is assigned in creation order, and its state is stored in parallel arrays indexed
+	// by that slot. Operation ids are hashed only when they cross the scheduler API, so the scheduling
+	// hot path works on indices. Slots are reused across iterations, so the table does not allocate
+	// once it has seen the largest iteration.
+	class OperationTable
+	{
+	private:
+		// Open-addressing hash from operation ids to slots. Each bucket stores the slot index plus one,
+		// and zero marks an empty bucket.
+		std::vector<size_t> buckets;
+
+		// The operation id of each slot.
+		std::vector<size_t> ids;
+
+		// The status of the operation in each slot.
+		std::vector<OperationStatus> statuses;
+
+		// For each slot, non-zero if its operation is currently scheduled.
+		std::vector<unsigned char> scheduled_flags;
+
+		// The parking primitives and wait state of each slot. They are heap allocated, because threads
+		// may be parked on them while the arrays grow.
+		std::vector<std::unique_ptr<Operation>> records;
+
+		// Number of slots used by the current iteration.
+		size_t slot_count;
+
+	public:
+		// Index returned when an operation does not exist.
+		static const size_t npos = static_cast<size_t>(-1);
+
+		OperationTable() noexcept;
+
+		OperationTable(OperationTable&& table) = delete;
+		OperationTable(OperationTable const&) = delete;
+
+		OperationTable& operator=(OperationTable&& table) = delete;
+		OperationTable& operator=(OperationTable const&) = delete;
+
+		// Adds a new operation with the specified id, and returns its slot index.
+		size_t insert(size_t operation_id);
+
+		// Returns the slot index of the operation with the specified id, or 'npos' if it does not exist.
+		size_t find(size_t operation_id) const noexcept;
+
+		// Returns the slot index of the operation with the specified id, or throws if it does not exist.
+		size_t index_of(size_t operation_id) const;
+
+		// Returns the number of operations in the current iteration.
+		size_t size() const noexcept;
+
+		// Returns the id of the operation in the specified slot.
+		size_t id(size_t index) const noexcept;
+
+		// Returns the status of the operation in the specified slot.
+		OperationStatus& status(size_t index) noexcept;
+
+		// Returns true if the operation in the specified slot is currently scheduled, else false.
+		bool is_scheduled(size_t index) const noexcept;
+
+		// Sets if the operation in the specified slot is currently scheduled.
+		void set_scheduled(size_t index, bool is_scheduled) noexcept;
+
+		// Returns the parking primitives and wait state of the operation in the specified slot.
+		Operation& operator[](size_t index) noexcept;
+
+		// Makes the operation in the specified slot wait until the operation in the joined slot has completed.
+		void join_operation(size_t index, size_t join_index);
+
+		// Makes the operation in the specified slot wait until the operations in the joined slots have completed.
+		void join_operations(size_t index, const std::vector<size_t>& join_indices, bool wait_all);
+
+		// Makes the operation in the specified slot wait until the specified resource sends a signal.
+		void wait_resource_signal(size_t index, size_t resource_id);
+
+		// Makes the operation in the specified slot wait until the specified resources send a signal.
+		void wait_resource_signals(size_t index, const size_t* resource_ids, size_t size, bool wait_all);
+
+		// Invoked when the operation in the joined slot completes. Returns true if the operation in the
+		// specified slot became enabled, else false.
+		bool on_join_operation(size_t index, size_t join_index);
+
+		// Invoked when the specified resource sends a signal. Returns true if the operation in the specified
+		// slot became enabled, else false.
+		bool on_resource_signal(size_t index, size_t resource_id);
+
+		// Removes all operations. The slots and their records are kept for the next iteration.
+		void clear() noexcept;
+
+	private:
+		// Returns the bucket that holds the specified operation id, or the empty bucket where it belongs.
+		size_t find_bucket(size_t operation_id) const noexcept;
+
+		// Doubles the number of buckets and rehashes the operations of the current iteration.
+		void grow_buckets();
+	};
+}
+
+#endif // COYOTE_OPERATION_TABLE_H
@@ -29,17 +29,30 @@ namespace coyote
 		RandomStrategy& operator=(RandomStrategy const&) = delete;
 
 		// Returns the next operation.
-		size_t next_operation(Operations& operations);
+		size_t next_operation(Operations& operations)
+		{
+			const size_t index = generator.next() % operations.size();
+			return operations[index];
+		}
 
 		// Returns the next boolean choice.
-		bool next_boolean();
+		bool next_boolean()
+		{
+			return generator.next() & 1;
+		}
 
 		// Returns the next integer choice.
-		int next_integer(int max_value);
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
 
 		// Returns the seed used in the current iteration.
 		size_t seed();
 
+		// Restarts the choices of the current iteration from the specified seed.
+		bool reseed(size_t seed);
+
 		// Prepares the next iteration.
 		void prepare_next_iteration();
 
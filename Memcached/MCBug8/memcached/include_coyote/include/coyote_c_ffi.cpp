@@ -11,10 +11,16 @@
 
 //#define COYOTE_DEBUG_LOG 1
 #include "test.h"
+#include "coyote/runners/fork_server.h"
+#include "coyote/runners/parallel_runner.h"
+#include "coyote/runners/test_campaign.h"
+#include "coyote/handoff/fiber_handoff.h"
 #include <cassert>
 #include <climits>
 #include <errno.h>
 #include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <mcheck.h>
 
 // Require C++11 or above
@@ -23,7 +29,8 @@
 
 typedef unsigned long long llu;
 
-Scheduler* scheduler = NULL;
+// Handle for reporting iterations, if this process is a worker forked by FFI_run_parallel.
+coyote::ParallelWorker* parallel_worker = NULL;
 
 // Use this flag to kepp a track of all heap allocations and get rid of heap memory leaks.
 #define INTERCEPT_HEAP_ALLOCATORS
@@ -40,6 +47,79 @@ Scheduler* scheduler = NULL;
 // Use this to enable schedule_next() statements in heap allocators.
 #define EXECUTION_COYOTE_CONTROLLED
 
+/******************************************** FFI_context Start ******************************************/
+
+class CoyoteLock;
+
+/************************************* For checking liveness property *******************************/
+
+// Memcached can be in the following 3 states
+enum program_state{STATE_READ, STATE_WRITE, STATE_INIT};
+
+/* All the state of one test harness: its scheduler, the Coyote resources that model the pthread
+*  objects of the program under test, and its heap allocations. Several contexts can be used
+*  concurrently in one process, as long as each runs on its own thread.
+*/
+struct FFI_context{
+
+	// Scheduler of this harness
+	Scheduler* scheduler;
+	// True if controlled operations run as fibers on the thread that attached the scheduler.
+	bool fibers_enabled;
+	// Counter to keep a track of resource IDs, we have already allocated.
+	// We won't be using the same resource ID again, even if the previous
+	// resource is deleted.
+	int total_resource_count;
+	// Hash map to store which pointer corresponds to which CoyoteLock object
+	std::unordered_map<llu, CoyoteLock*>* hash_map;
+	// List to keep a track of all statically allocated global mutexes and initialize them if needed
+	std::vector<void *>* lazy_mutex_init_list;
+	// List to keep a track of all statically allocated global conditional variable and initialize them if needed
+	std::vector<void *>* lazy_cond_init_list;
+	// Current state of the program, for checking the liveness property
+	enum program_state curr_state;
+	// Heap allocations of the current iteration, which FFI_free_all releases
+	std::vector<void*>* allocation_vector;
+	// Server that forks the iterations at the ready point, if FFI_enable_fork_server was called
+	coyote::ForkServer* fork_server;
+	// Number of calls to FFI_schedule_next at which the fork server forks the iterations
+	size_t fork_ready_step;
+	// Number of calls to FFI_schedule_next since the fork server was enabled
+	size_t fork_step_count;
+	// Number of operations created by the program under test in the current iteration, from which their
+	// ids are allocated
+	size_t operation_count;
+
+	FFI_context() :
+		scheduler(NULL),
+		fibers_enabled(false),
+		total_resource_count(0),
+		hash_map(NULL),
+		lazy_mutex_init_list(NULL),
+		lazy_cond_init_list(NULL),
+		curr_state(STATE_INIT),
+		allocation_vector(NULL),
+		fork_server(NULL),
+		fork_ready_step(0),
+		fork_step_count(0),
+		operation_count(0){
+	}
+};
+
+// Context of the FFI functions that do not take one, unless the calling thread is bound to another context.
+FFI_context default_context;
+
+// Context bound to the calling thread by FFI_ctx_bind or FFI_ctx_attach. Fibers run on the thread that
+// attached their scheduler, so they share its binding.
+thread_local FFI_context* bound_context = NULL;
+
+static inline FFI_context* current_context(){
+
+	return bound_context != NULL ? bound_context : &default_context;
+}
+
+/******************************************** FFI_context End ******************************************/
+
 /******************************************** CoyoteLock Start ******************************************/
 
 /* This class is intended to model a pthread mutex or a condition variable (condV)
@@ -53,10 +133,8 @@ public:
 	bool is_locked;
 	// Unique Coyote resource id
 	int coyote_resource_id;
-	// Counter to keep a track of resource IDs, we have already allocated.
-	// We won't be using the same resource ID again, even if the previous
-	// resource is deleted.
-	static int total_resource_count;
+	// Context whose scheduler owns this resource
+	FFI_context* ctx;
 	// Is it a conditional variable?
 	bool is_cond_var;
 	// Vector of operations waiting for this conditional variable
@@ -68,20 +146,21 @@ public:
 	// existing coyote resources with IDs less than or equal to reserved_resource_id_min.
 	// Use it when your application is moduler and you want to reserve some resource_ids for
 	// one module.
-	CoyoteLock(int reserved_resource_id_min = -1, int reserved_resource_id_max = INT_MAX, bool is_conditional_var = false){
-		assert(scheduler != NULL && "CoyoteLock: please initialize the coyote scheduler first!\n");
+	CoyoteLock(FFI_context* context, int reserved_resource_id_min = -1, int reserved_resource_id_max = INT_MAX, bool is_conditional_var = false){
+		ctx = context;
+		assert(ctx->scheduler != NULL && "CoyoteLock: please initialize the coyote scheduler first!\n");
 
-		assert(total_resource_count < reserved_resource_id_max && "CoyoteLock: Can not allocate more resources!");
+		assert(ctx->total_resource_count < reserved_resource_id_max && "CoyoteLock: Can not allocate more resources!");
 
 		// Should only be true once per module
-		if(total_resource_count <= reserved_resource_id_min){
-			total_resource_count = reserved_resource_id_min + 1;
+		if(ctx->total_resource_count <= reserved_resource_id_min){
+			ctx->total_resource_count = reserved_resource_id_min + 1;
 		}
 
-		coyote_resource_id = total_resource_count;
-		total_resource_count ++;
+		coyote_resource_id = ctx->total_resource_count;
+		ctx->total_resource_count ++;
 
-		ErrorCode e = scheduler->create_resource(coyote_resource_id);
+		ErrorCode e = ctx->scheduler->create_resource(coyote_resource_id);
 		assert(e == coyote::ErrorCode::Success && "CoyoteLock: failed to create resource! perhaps it already exists\n");
 
 		is_locked = false;
@@ -102,7 +181,7 @@ public:
 	}
 
 	~CoyoteLock(){
-		assert(scheduler != NULL && "~CoyoteLock: please initialize the coyote scheduler first!\n");
+		assert(ctx->scheduler != NULL && "~CoyoteLock: please initialize the coyote scheduler first!\n");
 
 		if(is_cond_var && (waitingOps != NULL) ){
 
@@ -119,40 +198,79 @@ public:
 			assert( (is_locked == false) && "Can not delete the resource as it is locked!");
 		}
 
-		ErrorCode e = scheduler->delete_resource(coyote_resource_id);
+		ErrorCode e = ctx->scheduler->delete_resource(coyote_resource_id);
 		assert(e == coyote::ErrorCode::Success && "~CoyoteLock: failed to delete resource!\n");
 	}
 
-	// Call with caution!! Currently, it is being called only during coyote_scheduler->detach()
-	static void reset_resource_count(){
-		total_resource_count = 0;
-	}
 };
 
-int CoyoteLock::total_resource_count = 0;
+/******************************************** CoyoteLock End ******************************************/
 
-// Global hash map to store which pointer corresponds to which CoyoteLock object
-std::unordered_map<llu, CoyoteLock*>* hash_map = NULL;
+/*********************************************** Metrics ***********************************************/
 
-// List to keep a track of all statically allocated global mutexes and initialize them if needed
-std::vector<void *>* lazy_mutex_init_list = NULL;
+// Writes the metrics of the scheduler to the specified path, as JSON if the path ends with '.json', else as CSV.
+static void dump_scheduler_metrics(Scheduler* scheduler, const char* path){
 
-// List to keep a track of all statically allocated global conditional variable and initialize them if needed
-std::vector<void *>* lazy_cond_init_list = NULL;
+	const coyote::SchedulerMetrics* metrics = scheduler->get_metrics();
+	assert(metrics != NULL && "Metrics are disabled. Call FFI_enable_metrics first.");
 
-/************************************* For checking liveness property *******************************/
+	std::ofstream stream(path);
+	const size_t length = strlen(path);
+	if(length >= 5 && strcmp(path + length - 5, ".json") == 0){
+		metrics->write_json(stream);
+	} else {
+		metrics->write_csv(stream);
+	}
 
-// Memcached can be in the following 3 states
-enum program_state{STATE_READ, STATE_WRITE, STATE_INIT};
-enum program_state curr_state = STATE_INIT;
+	assert(stream && "FFI_dump_metrics: failed to write the metrics");
+}
 
-// Number of 'attempted' context switches in one program state
-llu num_cxt_switch = 0;
+// Returns the value of the metric with the specified name, or 0 if there is no such metric.
+static llu scheduler_metric(Scheduler* scheduler, const char* name, bool is_total){
 
-// Maximum number of context switches that can happen *without* changing the program state
-#define MAX_NUM_CXT_SWITCH 2000000
+	const coyote::SchedulerMetrics* metrics = scheduler->get_metrics();
+	assert(metrics != NULL && "Metrics are disabled. Call FFI_enable_metrics first.");
 
-/******************************************** CoyoteLock End ******************************************/
+	for(int i = 0; i < (int)coyote::Metric::Count; i++){
+		coyote::Metric metric = (coyote::Metric)i;
+		if(coyote::metric_name(metric) == name){
+			return is_total ? metrics->total()[metric] : metrics->last_iteration()[metric];
+		}
+	}
+
+	return 0;
+}
+
+// Runs a test campaign on the scheduler and prints its throughput and the seeds of the buggy iterations.
+static int run_scheduler_campaign(Scheduler* scheduler, size_t max_iterations, size_t time_budget_ms,
+	bool stop_on_first_bug, bool (*iteration)(void), size_t* bug_seed){
+
+	coyote::TestCampaign campaign(*scheduler, max_iterations, std::chrono::milliseconds(time_budget_ms),
+		stop_on_first_bug);
+	while(campaign.next_iteration()){
+		campaign.complete_iteration(iteration());
+	}
+
+	printf("Completed %lu iterations in %.3f seconds (%.1f iterations/second)\n", campaign.completed_iterations(),
+		campaign.elapsed_seconds(), campaign.iterations_per_second());
+	if(!campaign.bug_found()){
+		return 0;
+	}
+
+	const coyote::CampaignBug& first_bug = campaign.found_bugs().front();
+	printf("Found the first bug after %.3f seconds in iteration %lu with seed: %lu\n",
+		campaign.time_to_first_bug_seconds(), first_bug.iteration, first_bug.seed);
+	for(size_t i = 1; i < campaign.found_bugs().size(); i++){
+		printf("Found a bug in iteration %lu with seed: %lu\n", campaign.found_bugs()[i].iteration,
+			campaign.found_bugs()[i].seed);
+	}
+
+	if(bug_seed != NULL){
+		*bug_seed = first_bug.seed;
+	}
+
+	return 1;
+}
 
 /* Since these functions will be called from a C code, we
 * need to specifiy this to our C++ compiler (g++) so that it accordingly
@@ -164,29 +282,521 @@ extern "C"{
 
 void clean_coyote_ops_hash_map();
 
+/******************************************** Context API ******************************************/
+
+FFI_context* FFI_ctx_create(){
+
+	FFI_context* ctx = new FFI_context();
+	ctx->scheduler = new coyote::Scheduler();
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	return ctx;
+}
+
+FFI_context* FFI_ctx_create_w_seed(size_t seed){
+
+	FFI_context* ctx = new FFI_context();
+	ctx->scheduler = new coyote::Scheduler(seed);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	return ctx;
+}
+
+FFI_context* FFI_ctx_current(){
+
+	return current_context();
+}
+
+void FFI_ctx_bind(FFI_context* ctx){
+
+	bound_context = ctx;
+}
+
+// Releases the scheduler and all the state of the context. The default context is only reset.
+void FFI_ctx_delete(FFI_context* ctx){
+
+	assert(ctx != NULL && "FFI_ctx_delete: NULL context");
+
+	if(ctx->lazy_mutex_init_list != NULL){
+		delete ctx->lazy_mutex_init_list;
+		ctx->lazy_mutex_init_list = NULL;
+	}
+
+	if(ctx->lazy_cond_init_list != NULL){
+		delete ctx->lazy_cond_init_list;
+		ctx->lazy_cond_init_list = NULL;
+	}
+
+	if(ctx->scheduler != NULL){
+		delete ctx->scheduler;
+		ctx->scheduler = NULL;
+	}
+
+	if(ctx->fork_server != NULL){
+		delete ctx->fork_server;
+		ctx->fork_server = NULL;
+	}
+
+	ctx->fibers_enabled = false;
+
+	if(bound_context == ctx){
+		bound_context = NULL;
+	}
+
+	if(ctx != &default_context){
+		delete ctx;
+	}
+}
+
+void FFI_ctx_attach(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	// The pthread models and heap allocators called by the program under test find the context through
+	// the thread that runs them.
+	bound_context = ctx;
+
+	// Lazy initialization of hash map
+	if(ctx->hash_map == NULL){
+		ctx->hash_map = new std::unordered_map<llu, CoyoteLock*>();
+	}
+
+	// Each iteration allocates the same operation ids, which the strategies that replay ids depend on
+	ctx->operation_count = 0;
+
+	ErrorCode e = ctx->scheduler->attach();
+	assert(e == coyote::ErrorCode::Success && "FFI_attach_scheduler: attach failed");
+
+	if(parallel_worker != NULL){
+		parallel_worker->start_iteration();
+	}
+}
+
+void FFI_ctx_detach(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	// If hash_map is non-null, clear and destroy it!
+	if(ctx->hash_map != NULL){
+
+		// Delete all the resources present in the hash map
+		for(auto it = ctx->hash_map->begin(); it != ctx->hash_map->end(); it ++){
+
+			CoyoteLock* obj = (*it).second;
+			delete obj;
+			obj = NULL;
+		}
+
+		ctx->hash_map->clear();
+
+		delete ctx->hash_map;
+		ctx->hash_map = NULL;
+
+		ctx->total_resource_count = 0;
+	}
+
+	//clean_coyote_ops_hash_map();
+
+	ErrorCode e = ctx->scheduler->detach();
+	if(parallel_worker != NULL){
+		parallel_worker->complete_iteration(e != coyote::ErrorCode::Success);
+	}
+
+	assert(e == coyote::ErrorCode::Success && "FFI_detach_scheduler: detach failed");
+
+	// A forked child only runs the iteration that it was forked from
+	if(ctx->fork_server != NULL && ctx->fork_server->is_child()){
+		ctx->fork_server->exit_child(ctx->scheduler->error_code() != coyote::ErrorCode::Success);
+	}
+}
+
+void FFI_ctx_scheduler_assert(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	coyote_sch_assert(ctx->scheduler->error_code(), ErrorCode::Success);
+}
+
+void FFI_ctx_create_operation(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->create_operation(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_create_operation: failed");
+}
+
+void FFI_ctx_enable_fibers(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->set_handoff_engine(std::unique_ptr<coyote::HandoffEngine>(new coyote::FiberHandoff()));
+	assert(e == coyote::ErrorCode::Success && "FFI_enable_fibers: failed");
+	ctx->fibers_enabled = true;
+}
+
+bool FFI_ctx_fibers_enabled(FFI_context* ctx){
+
+	return ctx->fibers_enabled;
+}
+
+void FFI_ctx_enable_fork_server(FFI_context* ctx, size_t ready_step, size_t num_iterations, size_t first_seed){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	assert(ctx->fibers_enabled && "FFI_enable_fork_server: the fork server requires FFI_enable_fibers");
+	assert(ctx->fork_server == NULL && "FFI_enable_fork_server: the fork server is already enabled");
+
+	ctx->fork_server = new coyote::ForkServer(num_iterations, first_seed, true);
+	ctx->fork_ready_step = ready_step;
+	ctx->fork_step_count = 0;
+}
+
+// Forks the iterations of the fork server at the ready point, and reseeds the scheduler of each child.
+static void fork_at_ready_point(FFI_context* ctx){
+
+	coyote::ForkServer* server = ctx->fork_server;
+	ErrorCode e = server->fork_children();
+	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next: failed to fork, is the process running a single thread?");
+
+	if(server->is_child()){
+
+		e = ctx->scheduler->reseed(server->seed());
+		assert(e == coyote::ErrorCode::Success && "FFI_schedule_next: the strategy cannot be reseeded");
+		printf("Running the forked iteration with seed: %lu\n", server->seed());
+		return;
+	}
+
+	printf("Completed %lu forked iterations\n", server->completed_iterations() + server->failed_iterations());
+	if(server->bug_found()){
+		printf("Found a bug in the forked iteration with seed: %lu\n", server->bug_seed());
+	}
+}
+
+void FFI_ctx_enable_scheduling_elision(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->set_scheduling_elision(true);
+	assert(e == coyote::ErrorCode::Success && "FFI_enable_scheduling_elision: failed");
+}
+
+void FFI_ctx_record_trace(FFI_context* ctx, const char* path){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->record_trace(path);
+	assert(e == coyote::ErrorCode::Success && "FFI_record_trace: failed");
+}
+
+void FFI_ctx_set_livelock_bound(FFI_context* ctx, size_t max_steps){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->set_livelock_bound(max_steps);
+	assert(e == coyote::ErrorCode::Success && "FFI_set_livelock_bound: failed");
+}
+
+void FFI_ctx_signal_progress(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ctx->scheduler->signal_progress();
+}
+
+void FFI_ctx_report_state(FFI_context* ctx, size_t state_hash){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->report_state(state_hash);
+	assert(e == coyote::ErrorCode::Success && "FFI_report_state: failed");
+}
+
+void FFI_ctx_report_bug(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->report_bug();
+	assert(e == coyote::ErrorCode::Success && "FFI_report_bug: failed");
+}
+
+size_t FFI_ctx_distinct_state_count(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return ctx->scheduler->distinct_state_count();
+}
+
+void FFI_ctx_enable_metrics(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->enable_metrics();
+	assert(e == coyote::ErrorCode::Success && "FFI_enable_metrics: failed");
+}
+
+llu FFI_ctx_metric(FFI_context* ctx, const char* name, bool is_total){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return scheduler_metric(ctx->scheduler, name, is_total);
+}
+
+void FFI_ctx_dump_metrics(FFI_context* ctx, const char* path){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	dump_scheduler_metrics(ctx->scheduler, path);
+}
+
+int FFI_ctx_run_campaign(FFI_context* ctx, size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug,
+	bool (*iteration)(void), size_t* bug_seed){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return run_scheduler_campaign(ctx->scheduler, max_iterations, time_budget_ms, stop_on_first_bug, iteration,
+		bug_seed);
+}
+
+void FFI_ctx_create_fiber_operation(FFI_context* ctx, size_t id, void (*func)(void*), void* arg){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->create_operation(id, func, arg);
+	assert(e == coyote::ErrorCode::Success && "FFI_create_fiber_operation: failed");
+}
+
+void FFI_ctx_start_operation(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->start_operation(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_start_operation: failed");
+}
+
+void FFI_ctx_join_operation(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->join_operation(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_join_operation: failed");
+}
+
+void FFI_ctx_join_operations(FFI_context* ctx, const size_t* operation_ids, size_t size, bool wait_all){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->join_operations(operation_ids, size, wait_all);
+	assert(e == coyote::ErrorCode::Success && "FFI_join_operations: failed");
+}
+
+void FFI_ctx_complete_operation(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->complete_operation(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_complete_operation: failed");
+}
+
+void FFI_ctx_create_resource(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->create_resource(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_create_resource: failed");
+}
+
+void FFI_ctx_wait_resource(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->wait_resource(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_wait_resource: failed");
+}
+
+void FFI_ctx_wait_resources(FFI_context* ctx, const size_t* resource_ids, size_t size, bool wait_all){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->wait_resources(resource_ids, size, wait_all);
+	assert(e == coyote::ErrorCode::Success && "FFT_wait_resources: failed");
+}
+
+void FFI_ctx_signal_resource(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->signal_resource(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_signal_resource: failed");
+}
+
+// Signal resource availability to a specific operation, op_id
+void FFI_ctx_signal_resource_to_op(FFI_context* ctx, size_t id, size_t op_id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	// This function is not available in PCT Strategy branch
+	//assert(0);
+	ErrorCode e = ctx->scheduler->signal_resource(id, op_id);
+	assert(e == coyote::ErrorCode::Success && "FFI_signal_resource_to_op: failed");
+}
+
+void FFI_ctx_delete_resource(FFI_context* ctx, size_t id){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->delete_resource(id);
+	assert(e == coyote::ErrorCode::Success && "FFI_delete_resource: failed");
+}
+
+void FFI_ctx_schedule_next(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	if(ctx->fork_server != NULL && !ctx->fork_server->is_child() && ++ctx->fork_step_count == ctx->fork_ready_step){
+		fork_at_ready_point(ctx);
+	}
+
+	ErrorCode e = ctx->scheduler->schedule_next();
+	assert(e != coyote::ErrorCode::LivelockDetected && "Potential violation of the liveliness property.");
+	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next: failed");
+}
+
+void FFI_ctx_schedule_next_access(FFI_context* ctx, size_t location, bool is_write){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	if(ctx->fork_server != NULL && !ctx->fork_server->is_child() && ++ctx->fork_step_count == ctx->fork_ready_step){
+		fork_at_ready_point(ctx);
+	}
+
+	ErrorCode e = ctx->scheduler->schedule_next(location, is_write);
+	assert(e != coyote::ErrorCode::LivelockDetected && "Potential violation of the liveliness property.");
+	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next_access: failed");
+}
+
+bool FFI_ctx_next_boolean(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	bool val = ctx->scheduler->next_boolean();
+	return val;
+}
+
+size_t FFI_ctx_next_integer(FFI_context* ctx, size_t max_value){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	// Bounds above INT_MAX are clamped by the scheduler.
+	return ctx->scheduler->next_integer(max_value);
+}
+
+size_t FFI_ctx_seed(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	return ctx->scheduler->seed();
+}
+
+size_t FFI_ctx_error_code(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	ErrorCode e = ctx->scheduler->error_code();
+	return (size_t)e;
+}
+
+size_t FFI_ctx_get_operation_id(FFI_context* ctx){
+
+	assert(ctx->scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+
+	size_t id = ctx->scheduler->get_operation_id();
+	assert(id >= 0 && "operation id can't be negative!");
+
+	return id;
+}
+
+size_t FFI_ctx_next_operation_id(FFI_context* ctx){
+
+	// Only the scheduled operation of the context runs, so the counter needs no synchronization. Id 0 is
+	// the main operation.
+	return ++ctx->operation_count;
+}
+
+void FFI_ctx_set_state_read(FFI_context* ctx){
+
+	if(ctx->curr_state == STATE_READ) return;
+
+	// There is a state change!
+	FFI_ctx_signal_progress(ctx);
+	ctx->curr_state = STATE_READ;
+}
+
+void FFI_ctx_set_state_write(FFI_context* ctx){
+
+	if(ctx->curr_state == STATE_WRITE) return;
+
+	// There is a state change!
+	FFI_ctx_signal_progress(ctx);
+	ctx->curr_state = STATE_WRITE;
+}
+
+/******************************* API on the context of the calling thread ***************************/
+
 void FFI_create_scheduler(){
 
+	FFI_context* ctx = current_context();
+
 	// Assuming that we can have only one instance
-	// of Coyote scheduler
-	if(scheduler != NULL){
+	// of Coyote scheduler per context
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
-	scheduler = new coyote::Scheduler();
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	ctx->scheduler = new coyote::Scheduler();
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
 // Create scheduler with the seed
 void FFI_create_scheduler_w_seed(size_t seed){
 
+	FFI_context* ctx = current_context();
+
 	// Udit: Assuming that we can have only one instance
 	// of Coyote scheduler
-	if(scheduler != NULL){
+	if(ctx->scheduler != NULL){
+		return;
+	}
+
+	ctx->scheduler = new coyote::Scheduler(seed);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
+// Create scheduler that replays the trace file written by FFI_record_trace
+void FFI_create_scheduler_replay(const char* path){
+
+	FFI_context* ctx = current_context();
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
-	scheduler = new coyote::Scheduler(seed);
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	std::unique_ptr<coyote::Strategy> strategy;
+	try{
+		strategy.reset(new coyote::ReplayStrategy(path));
+	}
+	catch(...){
+		assert(false && "FFI_create_scheduler_replay: could not read the trace file");
+	}
+
+	ctx->scheduler = new coyote::Scheduler(std::move(strategy));
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
+// Create scheduler with the POS strategy and the seed
+void FFI_create_scheduler_pos(size_t seed){
+
+	FFI_context* ctx = current_context();
+	if(ctx->scheduler != NULL){
+		return;
+	}
+
+	ctx->scheduler = new coyote::Scheduler(std::unique_ptr<coyote::Strategy>(new coyote::POSStrategy(seed)));
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
 #ifdef USING_PCT_BRANCH
@@ -194,29 +804,33 @@ void FFI_create_scheduler_w_seed(size_t seed){
 // Create scheduler with the random strategy
 void FFI_create_scheduler_rand(){
 
+	FFI_context* ctx = current_context();
+
 	// Udit: Assuming that we can have only one instance
 	// of Coyote scheduler
-	if(scheduler != NULL){
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
 	std::string st = "RandomStrategy";
-	scheduler = new coyote::Scheduler(st);
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
 // Create scheduler with the pct strategy
 void FFI_create_scheduler_pct(){
 
+	FFI_context* ctx = current_context();
+
 	// Udit: Assuming that we can have only one instance
 	// of Coyote scheduler
-	if(scheduler != NULL){
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
 	std::string st = "PCTStrategy";
-	scheduler = new coyote::Scheduler(st);
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
 #endif // USING_PCT_BRANCH
@@ -226,260 +840,295 @@ void FFI_create_scheduler_pct(){
 // Create scheduler with the random strategy
 void FFI_create_scheduler_rand(){
 
+	FFI_context* ctx = current_context();
+
 	// Udit: Assuming that we can have only one instance
 	// of Coyote scheduler
-	if(scheduler != NULL){
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
 	std::string st = "RandomStrategy";
-	scheduler = new coyote::Scheduler(st);
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
 
 // Create scheduler with the dfs strategy
 void FFI_create_scheduler_dfs(){
 
+	FFI_context* ctx = current_context();
+
 	// Udit: Assuming that we can have only one instance
 	// of Coyote scheduler
-	if(scheduler != NULL){
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
 	std::string st = "DFSStrategy";
-	scheduler = new coyote::Scheduler(st);
-	assert(scheduler != NULL && "coyote::Scheduler() returned NULL!");
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
-#endif
 
-void FFI_delete_scheduler(){
+// Create scheduler with the preemption-bounded dfs strategy
+void FFI_create_scheduler_preemption_bounded(){
 
-	if(lazy_mutex_init_list != NULL){
-		delete lazy_mutex_init_list;
-		lazy_mutex_init_list = NULL;
-	}
+	FFI_context* ctx = current_context();
 
-	if(lazy_cond_init_list != NULL){
-		delete lazy_cond_init_list;
-		lazy_cond_init_list = NULL;
+	if(ctx->scheduler != NULL){
+		return;
 	}
 
-	// Make sure the scheduler pointer is not NULL
-	if(scheduler == NULL){
+	std::string st = "PreemptionBoundedDFSStrategy";
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
+}
+
+// Create scheduler with the delay-bounded dfs strategy
+void FFI_create_scheduler_delay_bounded(){
+
+	FFI_context* ctx = current_context();
+
+	if(ctx->scheduler != NULL){
 		return;
 	}
 
-	delete scheduler;
+	std::string st = "DelayBoundedDFSStrategy";
+	ctx->scheduler = new coyote::Scheduler(st);
+	assert(ctx->scheduler != NULL && "coyote::Scheduler() returned NULL!");
 }
+#endif
 
-void FFI_attach_scheduler(){
+void FFI_delete_scheduler(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_delete(current_context());
+}
 
-	// Lazy initialization of hash map
-	if(hash_map == NULL){
-		hash_map = new std::unordered_map<llu, CoyoteLock*>();
-	}
+void FFI_attach_scheduler(){
 
-	ErrorCode e = scheduler->attach();
-	assert(e == coyote::ErrorCode::Success && "FFI_attach_scheduler: attach failed");
+	FFI_ctx_attach(current_context());
 }
 
 void FFI_detach_scheduler(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_detach(current_context());
+}
 
-	// If hash_map is non-null, clear and destroy it!
-	if(hash_map != NULL){
+int FFI_run_parallel(size_t num_workers, size_t num_iterations, size_t seed,
+	void (*worker_main)(size_t first_seed, size_t num_iterations), size_t* bug_seed){
 
-		// Delete all the resources present in the hash map
-		for(auto it = hash_map->begin(); it != hash_map->end(); it ++){
+	assert(current_context()->scheduler == NULL && "FFI_run_parallel: each worker must create its own scheduler");
 
-			CoyoteLock* obj = (*it).second;
-			delete obj;
-			obj = NULL;
-		}
+	coyote::ParallelRunner runner(num_workers, num_iterations, seed);
+	ErrorCode e = runner.run([worker_main](coyote::ParallelWorker& worker){
+		parallel_worker = &worker;
+		worker_main(worker.first_seed, worker.num_iterations);
+		parallel_worker = NULL;
+	});
+	assert(e == coyote::ErrorCode::Success && "FFI_run_parallel: failed to run the workers");
 
-		hash_map->clear();
-
-		delete hash_map;
-		hash_map = NULL;
+	printf("Completed %lu iterations across %lu workers\n", runner.completed_iterations(), num_workers);
+	if(!runner.bug_found()){
+		return 0;
+	}
 
-		CoyoteLock::reset_resource_count();
+	if(bug_seed != NULL){
+		*bug_seed = runner.bug_seed();
 	}
 
-	//clean_coyote_ops_hash_map();
+	return 1;
+}
 
-	ErrorCode e = scheduler->detach();
-	assert(e == coyote::ErrorCode::Success && "FFI_detach_scheduler: detach failed");
+int FFI_run_campaign(size_t max_iterations, size_t time_budget_ms, bool stop_on_first_bug, bool (*iteration)(void),
+	size_t* bug_seed){
+
+	return FFI_ctx_run_campaign(current_context(), max_iterations, time_budget_ms, stop_on_first_bug, iteration,
+		bug_seed);
 }
 
 void FFI_scheduler_assert(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-	coyote_sch_assert(scheduler->error_code(), ErrorCode::Success);
+	FFI_ctx_scheduler_assert(current_context());
 }
 
 void FFI_create_operation(size_t id){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_create_operation(current_context(), id);
+}
+
+// Runs the controlled operations as fibers on the thread that attaches the scheduler.
+// Call it after creating the scheduler and before the first attach.
+void FFI_enable_fibers(){
 
-	ErrorCode e = scheduler->create_operation(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_create_operation: failed");
+	FFI_ctx_enable_fibers(current_context());
 }
 
-void FFI_start_operation(size_t id){
+bool FFI_fibers_enabled(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	return current_context()->fibers_enabled;
+}
 
-	ErrorCode e = scheduler->start_operation(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_start_operation: failed");
+// Forks the iterations from a snapshot of the process at the ready_step-th call to FFI_schedule_next.
+void FFI_enable_fork_server(size_t ready_step, size_t num_iterations, size_t first_seed){
+
+	FFI_ctx_enable_fork_server(current_context(), ready_step, num_iterations, first_seed);
 }
 
-void FFI_join_operation(size_t id){
+// Lets scheduling points where a single operation is enabled return without consulting the strategy.
+// Call it after creating the scheduler and before the first attach.
+void FFI_enable_scheduling_elision(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_enable_scheduling_elision(current_context());
+}
 
-	ErrorCode e = scheduler->join_operation(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_join_operation: failed");
+// Records the scheduling decisions of the latest iteration into the trace file at the specified path.
+void FFI_record_trace(const char* path){
+
+	FFI_ctx_record_trace(current_context(), path);
 }
 
-void FFI_join_operations(const size_t* operation_ids, size_t size, bool wait_all){
+// Fails the iteration once it takes more than the specified number of scheduling steps without progress.
+void FFI_set_livelock_bound(size_t max_steps){
+
+	FFI_ctx_set_livelock_bound(current_context(), max_steps);
+}
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+void FFI_signal_progress(){
 
-	ErrorCode e = scheduler->join_operations(operation_ids, size, wait_all);
-	assert(e == coyote::ErrorCode::Success && "FFI_join_operations: failed");
+	FFI_ctx_signal_progress(current_context());
 }
 
-void FFI_complete_operation(size_t id){
+// Reports the hash of the current program state, so that strategies can prune schedules that reach known states.
+void FFI_report_state(size_t state_hash){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_report_state(current_context(), state_hash);
+}
 
-	ErrorCode e = scheduler->complete_operation(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_complete_operation: failed");
+// Reports that the last iteration found a bug, so that the portfolio strategy favors the strategy that found it.
+void FFI_report_bug(){
+
+	FFI_ctx_report_bug(current_context());
 }
 
-void FFI_create_resource(size_t id){
+size_t FFI_distinct_state_count(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	return FFI_ctx_distinct_state_count(current_context());
+}
 
-	ErrorCode e = scheduler->create_resource(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_create_resource: failed");
+// Collects metrics about each iteration, such as scheduling decisions and context switches.
+void FFI_enable_metrics(){
+
+	FFI_ctx_enable_metrics(current_context());
 }
 
-void FFI_wait_resource(size_t id){
+llu FFI_metric(const char* name, bool is_total){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	return FFI_ctx_metric(current_context(), name, is_total);
+}
 
-	ErrorCode e = scheduler->wait_resource(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_wait_resource: failed");
+void FFI_dump_metrics(const char* path){
+
+	FFI_ctx_dump_metrics(current_context(), path);
 }
 
-void FFT_wait_resources(const size_t* resource_ids, size_t size, bool wait_all){
+void FFI_create_fiber_operation(size_t id, void (*func)(void*), void* arg){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_create_fiber_operation(current_context(), id, func, arg);
+}
 
-	ErrorCode e = scheduler->wait_resources(resource_ids, size, wait_all);
-	assert(e == coyote::ErrorCode::Success && "FFT_wait_resources: failed");
+void FFI_start_operation(size_t id){
+
+	FFI_ctx_start_operation(current_context(), id);
 }
 
-void FFI_signal_resource(size_t id){
+void FFI_join_operation(size_t id){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_join_operation(current_context(), id);
+}
 
-	ErrorCode e = scheduler->signal_resource(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_signal_resource: failed");
+void FFI_join_operations(const size_t* operation_ids, size_t size, bool wait_all){
+
+	FFI_ctx_join_operations(current_context(), operation_ids, size, wait_all);
+}
+
+void FFI_complete_operation(size_t id){
+
+	FFI_ctx_complete_operation(current_context(), id);
+}
+
+void FFI_create_resource(size_t id){
+
+	FFI_ctx_create_resource(current_context(), id);
+}
+
+void FFI_wait_resource(size_t id){
+
+	FFI_ctx_wait_resource(current_context(), id);
+}
+
+void FFT_wait_resources(const size_t* resource_ids, size_t size, bool wait_all){
+
+	FFI_ctx_wait_resources(current_context(), resource_ids, size, wait_all);
+}
+
+void FFI_signal_resource(size_t id){
+
+	FFI_ctx_signal_resource(current_context(), id);
 }
 
 // Signal resource availability to a specific operation, op_id
 void FFI_signal_resource_to_op(size_t id, size_t op_id){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	// This function is not available in PCT Strategy branch
-	//assert(0);
-	ErrorCode e = scheduler->signal_resource(id, op_id);
-	assert(e == coyote::ErrorCode::Success && "FFI_signal_resource_to_op: failed");
+	FFI_ctx_signal_resource_to_op(current_context(), id, op_id);
 }
 
 void FFI_delete_resource(size_t id){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	ErrorCode e = scheduler->delete_resource(id);
-	assert(e == coyote::ErrorCode::Success && "FFI_delete_resource: failed");
+	FFI_ctx_delete_resource(current_context(), id);
 }
 
 void FFI_schedule_next(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
+	FFI_ctx_schedule_next(current_context());
+}
 
-	num_cxt_switch++;
-	//assert(num_cxt_switch < MAX_NUM_CXT_SWITCH && "Potential violation of the liveliness property.");
+void FFI_schedule_next_access(size_t location, bool is_write){
 
-	ErrorCode e = scheduler->schedule_next();
-	assert(e == coyote::ErrorCode::Success && "FFI_schedule_next: failed");
+	FFI_ctx_schedule_next_access(current_context(), location, is_write);
 }
 
 bool FFI_next_boolean(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	bool val = scheduler->next_boolean();
-	return val;
+	return FFI_ctx_next_boolean(current_context());
 }
 
 size_t FFI_next_integer(size_t max_value){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	//assert(0 && "Fix this!!");
-	return scheduler->next_integer((long unsigned)max_value);
-	//return 0;
+	return FFI_ctx_next_integer(current_context(), max_value);
 }
 
 size_t FFI_seed(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	return scheduler->seed();
+	return FFI_ctx_seed(current_context());
 }
 
 size_t FFI_error_code(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	ErrorCode e = scheduler->error_code();
-	return (size_t)e;
+	return FFI_ctx_error_code(current_context());
 }
 
 size_t FFI_get_operation_id(){
 
-	assert(scheduler != NULL && "Wrong sequence of API calls. Create Coyote Scheduler first.");
-
-	size_t id = scheduler->get_operation_id();
-	assert(id >= 0 && "operation id can't be negative!");
-
-	return id;
+	return FFI_ctx_get_operation_id(current_context());
 }
 
 void FFI_set_state_read(){
 
-	if(curr_state == STATE_READ) return;
-
-	// There is a state change!
-	num_cxt_switch = 0;
-	curr_state = STATE_READ;
+	FFI_ctx_set_state_read(current_context());
 }
 
 void FFI_set_state_write(){
 
-	if(curr_state == STATE_WRITE) return;
-
-	// There is a state change!
-	num_cxt_switch = 0;
-	curr_state = STATE_WRITE;
+	FFI_ctx_set_state_write(current_context());
 }
 
 /***** Modelling of pthread APIs using coyote scheduler APIs *****
@@ -491,7 +1140,8 @@ void FFI_set_state_write(){
 // be a problem in our case.
 int FFI_pthread_mutex_init(void *ptr, void *mutex_attr){
 
-	FFI_schedule_next();
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
 
 #ifdef DEBUG_PTHREAD_API
 	printf("In FFI_pthread_mutex_init: recieved: %p \n", ptr);
@@ -501,28 +1151,28 @@ int FFI_pthread_mutex_init(void *ptr, void *mutex_attr){
 
 	llu key = (llu)ptr;
 
-	//assert(hash_map->find(key) == hash_map->end() && "FFI_pthread_mutex_init: Key is already in the map\n");
+	//assert(ctx->hash_map->find(key) == ctx->hash_map->end() && "FFI_pthread_mutex_init: Key is already in the map\n");
 
 	// If it is already in the map, return. Don't use the above assertion as it can fail even if
 	// the mutex is new. That can happen due to reuse of heap allocated mutex variable.
-	if(hash_map->find(key) != hash_map->end()){
+	if(ctx->hash_map->find(key) != ctx->hash_map->end()){
 
 		return 0;
 	}
 	// Make sure that this key is not in the list of `Globally initialized' mutexes. Otherwise, it can be a potential
 	// double initialization bug!
 
-	if(lazy_mutex_init_list != NULL){
+	if(ctx->lazy_mutex_init_list != NULL){
 
 		std::vector<void*>::iterator it;
-		it = std::find(lazy_mutex_init_list->begin(), lazy_mutex_init_list->end(), ptr);
+		it = std::find(ctx->lazy_mutex_init_list->begin(), ctx->lazy_mutex_init_list->end(), ptr);
 
-		//assert(it == lazy_mutex_init_list->end() && "This mutex is already globally initialized!");
+		//assert(it == ctx->lazy_mutex_init_list->end() && "This mutex is already globally initialized!");
 	}
 
 	// Create a new resource object and insert it into the hash map
-	CoyoteLock* new_obj = new CoyoteLock();
-	bool rv = (hash_map->insert({key, new_obj})).second;
+	CoyoteLock* new_obj = new CoyoteLock(ctx);
+	bool rv = (ctx->hash_map->insert({key, new_obj})).second;
 	assert(rv == true && "FFI_pthread_mutex_init: Inserting in the map failed!\n");
 
 #ifdef DEBUG_PTHREAD_API
@@ -535,44 +1185,46 @@ int FFI_pthread_mutex_init(void *ptr, void *mutex_attr){
 // Called only for globally initialized mutexs
 int FFI_pthread_mutex_lazy_init(void *ptr){
 
-	if(lazy_mutex_init_list == NULL){
-		lazy_mutex_init_list = new std::vector<void*>();
+	FFI_context* ctx = current_context();
+	if(ctx->lazy_mutex_init_list == NULL){
+		ctx->lazy_mutex_init_list = new std::vector<void*>();
 	}
 
 	// Add it to the list of globally initialized mutex
-	lazy_mutex_init_list->push_back(ptr);
+	ctx->lazy_mutex_init_list->push_back(ptr);
 	return 0;
 }
 
-void check_and_init_mutex(void* ptr){
+void check_and_init_mutex(FFI_context* ctx, void* ptr){
 
-	if(lazy_mutex_init_list == NULL) return;
+	if(ctx->lazy_mutex_init_list == NULL) return;
 
 	std::vector<void*>::iterator it;
-	it = std::find(lazy_mutex_init_list->begin(), lazy_mutex_init_list->end(), ptr);
+	it = std::find(ctx->lazy_mutex_init_list->begin(), ctx->lazy_mutex_init_list->end(), ptr);
 
 	// If the item is in the list
-	if(it != lazy_mutex_init_list->end()){
+	if(it != ctx->lazy_mutex_init_list->end()){
 		FFI_pthread_mutex_init(ptr, NULL);
 	}
 }
 
 int FFI_pthread_mutex_lock(void *ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_mutex_lock: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_mutex_lock: Initialize the hash map first\n");
 
 	llu key = (llu)ptr;
-	std::unordered_map<llu, CoyoteLock*>::iterator it = hash_map->find(key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it = ctx->hash_map->find(key);
 
 	// If it is not in the hash map, initialize it. It can be becoz this mutex ptr is globally initialized
-	if(it == hash_map->end()){
+	if(it == ctx->hash_map->end()){
 
 		FFI_pthread_mutex_init(ptr, NULL);
-		it = hash_map->find(key);
+		it = ctx->hash_map->find(key);
 	}
 
-	assert(it != hash_map->end() && "FFI_pthread_mutex_lock: key not in map\n");
+	assert(it != ctx->hash_map->end() && "FFI_pthread_mutex_lock: key not in map\n");
 
 	CoyoteLock* obj = it->second;
 
@@ -580,38 +1232,39 @@ int FFI_pthread_mutex_lock(void *ptr){
 	printf("In FFI_pthread_mutex_lock: Locking on: %p as coyote resource id: %d \n", ptr, obj->coyote_resource_id);
 #endif
 
-	assert( ( !(obj->is_locked) || FFI_get_operation_id() != obj->user_op_id ) &&
+	assert( ( !(obj->is_locked) || FFI_ctx_get_operation_id(ctx) != obj->user_op_id ) &&
 		"This thread is already holding this lock, why is it trying to lock it again?");
 
 	// If the resource is already locked, then spinlock!
 	while(obj->is_locked){
-		FFI_wait_resource(obj->coyote_resource_id);
+		FFI_ctx_wait_resource(ctx, obj->coyote_resource_id);
 	}
 
 	// If the resource is free for use, lock it!
 	obj->is_locked = true;
 	// How is holding this lock?
-	obj->user_op_id = FFI_get_operation_id();
+	obj->user_op_id = FFI_ctx_get_operation_id(ctx);
 
 	return 0;
 }
 
 int FFI_pthread_mutex_trylock(void *ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_mutex_trylock: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_mutex_trylock: Initialize the hash map first\n");
 
 	llu key = (llu)ptr;
-	std::unordered_map<llu, CoyoteLock*>::iterator it = hash_map->find(key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it = ctx->hash_map->find(key);
 
 	// If it is not in the hash map, initialize it
-	if(it == hash_map->end()){
+	if(it == ctx->hash_map->end()){
 
 		FFI_pthread_mutex_init(ptr, NULL);
-		it = hash_map->find(key);
+		it = ctx->hash_map->find(key);
 	}
 
-	assert(it != hash_map->end() && "FFI_pthread_mutex_trylock: key not in map\n");
+	assert(it != ctx->hash_map->end() && "FFI_pthread_mutex_trylock: key not in map\n");
 
 	CoyoteLock* obj = it->second;
 
@@ -626,26 +1279,27 @@ int FFI_pthread_mutex_trylock(void *ptr){
 	// Otherwise, return 0 and gain the lock
 	obj->is_locked = true;
 	// How is holding this lock?
-	obj->user_op_id = FFI_get_operation_id();
+	obj->user_op_id = FFI_ctx_get_operation_id(ctx);
 
 	return 0;
 }
 
 int FFI_pthread_mutex_is_lock(void *ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_mutex_is_lock: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_mutex_is_lock: Initialize the hash map first\n");
 
 	llu key = (llu)ptr;
-	std::unordered_map<llu, CoyoteLock*>::iterator it = hash_map->find(key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it = ctx->hash_map->find(key);
 
 	// If it is not in the hash map, try looking up in the lazy init list
-	if(it == hash_map->end()){
-		check_and_init_mutex(ptr);
-		it = hash_map->find(key);
+	if(it == ctx->hash_map->end()){
+		check_and_init_mutex(ctx, ptr);
+		it = ctx->hash_map->find(key);
 	}
 
-	assert(it != hash_map->end() && "FFI_pthread_mutex_is_lock: key not in map\n");
+	assert(it != ctx->hash_map->end() && "FFI_pthread_mutex_is_lock: key not in map\n");
 
 	CoyoteLock* obj = it->second;
 
@@ -663,24 +1317,25 @@ int FFI_pthread_mutex_is_lock(void *ptr){
 
 int FFI_pthread_mutex_unlock(void *ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_mutex_unlock: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_mutex_unlock: Initialize the hash map first\n");
 
 #ifdef DEBUG_PTHREAD_API
 	printf("In FFI_pthread_mutex_unlock: Unlocking on: %p \n", ptr);
 #endif
 
 	llu key = (llu)ptr;
-	std::unordered_map<llu, CoyoteLock*>::iterator it = hash_map->find(key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it = ctx->hash_map->find(key);
 
 	// If it is not in the hash map, try looking up in the lazy init list
-	if(it == hash_map->end()){
+	if(it == ctx->hash_map->end()){
 
 		FFI_pthread_mutex_init(ptr, NULL);
-		it = hash_map->find(key);
+		it = ctx->hash_map->find(key);
 	}
 
-	assert(it != hash_map->end() && "FFI_pthread_mutex_unlock: key not in map\n");
+	assert(it != ctx->hash_map->end() && "FFI_pthread_mutex_unlock: key not in map\n");
 
 	CoyoteLock* obj = it->second;
 
@@ -693,27 +1348,28 @@ int FFI_pthread_mutex_unlock(void *ptr){
 	printf("In FFI_pthread_mutex_unlock: Unlocking on: %p as coyote resource id: %d \n", ptr, obj->coyote_resource_id);
 #endif
 
-	FFI_signal_resource(obj->coyote_resource_id);
+	FFI_ctx_signal_resource(ctx, obj->coyote_resource_id);
 
 	return 0;
 }
 
 int FFI_pthread_mutex_destroy(void *ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_mutex_destroy: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_mutex_destroy: Initialize the hash map first\n");
 
 	llu key = (llu)ptr;
-	std::unordered_map<llu, CoyoteLock*>::iterator it = hash_map->find(key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it = ctx->hash_map->find(key);
 
 	// If it is not in the hash map, try looking up in the lazy init list
-	if(it == hash_map->end()){
+	if(it == ctx->hash_map->end()){
 
 		FFI_pthread_mutex_init(ptr, NULL);
-		it = hash_map->find(key);
+		it = ctx->hash_map->find(key);
 	}
 
-	assert(it != hash_map->end() && "FFI_pthread_mutex_destroy: key not in map\n");
+	assert(it != ctx->hash_map->end() && "FFI_pthread_mutex_destroy: key not in map\n");
 
 	CoyoteLock* obj = it->second;
 	assert(obj->is_locked == false && "FFI_pthread_mutex_destroy: Don't destroy a locked mutex!");
@@ -722,7 +1378,7 @@ int FFI_pthread_mutex_destroy(void *ptr){
 	printf("In FFI_pthread_mutex_destroy: Destroying: %p and coyote resource id: %d \n", ptr, obj->coyote_resource_id);
 #endif
 
-	hash_map->erase(it); // Remove the object from hash_map
+	ctx->hash_map->erase(it); // Remove the object from hash_map
 	delete obj; // Remove the object from heap
 
 	return 0;
@@ -730,28 +1386,29 @@ int FFI_pthread_mutex_destroy(void *ptr){
 
 int FFI_pthread_cond_init(void* ptr, void* attr){
 
-	FFI_schedule_next();
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
 	llu key = (llu)ptr;
 
-	if(hash_map == NULL){
-		hash_map = new std::unordered_map<llu, CoyoteLock*>();
+	if(ctx->hash_map == NULL){
+		ctx->hash_map = new std::unordered_map<llu, CoyoteLock*>();
 	}
 
-	assert(hash_map->find(key) == hash_map->end() && "FFI_pthread_cond_init: Key is already in the map\n");
+	assert(ctx->hash_map->find(key) == ctx->hash_map->end() && "FFI_pthread_cond_init: Key is already in the map\n");
 
 	// Make sure that this key is not in the list of `Globally initialized' condition vars. Otherwise, it can be a potential
 	// double initialization bug!
 
-	if(lazy_cond_init_list != NULL){
+	if(ctx->lazy_cond_init_list != NULL){
 
 		std::vector<void*>::iterator it;
-		it = std::find(lazy_cond_init_list->begin(), lazy_cond_init_list->end(), ptr);
+		it = std::find(ctx->lazy_cond_init_list->begin(), ctx->lazy_cond_init_list->end(), ptr);
 
-		// assert(it == lazy_cond_init_list->end() && "This condition variable is already globally initialized!");
+		// assert(it == ctx->lazy_cond_init_list->end() && "This condition variable is already globally initialized!");
 	}
 
-	CoyoteLock* new_obj = new CoyoteLock(-1, INT_MAX, true /*it is a condition variable*/);
-	bool rv = (hash_map->insert({key, new_obj})).second;
+	CoyoteLock* new_obj = new CoyoteLock(ctx, -1, INT_MAX, true /*it is a condition variable*/);
+	bool rv = (ctx->hash_map->insert({key, new_obj})).second;
 	assert(rv == true && "FFI_pthread_cond_init: Inserting in the map failed!\n");
 
 #ifdef DEBUG_PTHREAD_API
@@ -763,54 +1420,57 @@ int FFI_pthread_cond_init(void* ptr, void* attr){
 
 int FFI_pthread_cond_lazy_init(void *ptr){
 
-	if(lazy_cond_init_list == NULL){
-		lazy_cond_init_list = new std::vector<void*>();
+	FFI_context* ctx = current_context();
+	if(ctx->lazy_cond_init_list == NULL){
+		ctx->lazy_cond_init_list = new std::vector<void*>();
 	}
 
-	lazy_cond_init_list->push_back(ptr);
+	ctx->lazy_cond_init_list->push_back(ptr);
 	return 0;
 }
 
-void check_and_init_cond(void *ptr){
+void check_and_init_cond(FFI_context* ctx, void *ptr){
 
-	if(lazy_cond_init_list == NULL) return;
+	if(ctx->lazy_cond_init_list == NULL) return;
 
 	std::vector<void*>::iterator it;
-	it = std::find(lazy_cond_init_list->begin(), lazy_cond_init_list->end(), ptr);
+	it = std::find(ctx->lazy_cond_init_list->begin(), ctx->lazy_cond_init_list->end(), ptr);
 
 	// If the item is in the list, initialize it!
-	if(it != lazy_cond_init_list->end()){
+	if(it != ctx->lazy_cond_init_list->end()){
 		FFI_pthread_cond_init(ptr, NULL);
 	}
 }
 
 int FFI_pthread_cond_wait(void* cond_var_ptr, void* mtx){
 
+	FFI_context* ctx = current_context();
+
 	// Don't put a context switch here. There's a bug in our libevent modelling, which can cause deadlock
-	// FFI_schedule_next();
+	// FFI_ctx_schedule_next(ctx);
 
 #ifdef DEBUG_PTHREAD_API
 	printf("In FFI_pthread_cond_wait: with cond_var: %p and mutex is: %p \n", cond_var_ptr, mtx);
 #endif
 
-	assert(hash_map != NULL && "FFI_pthread_cond_wait: Initialize the hash map first\n");
+	assert(ctx->hash_map != NULL && "FFI_pthread_cond_wait: Initialize the hash map first\n");
 
 	llu cond_var_key = (llu)cond_var_ptr;
 	llu mutex_key = (llu)mtx;
 
 	// First check whether the conditional variable and mutex are in the map or not
-	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = hash_map->find(cond_var_key);
-	std::unordered_map<llu, CoyoteLock*>::iterator it_mtx = hash_map->find(mutex_key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = ctx->hash_map->find(cond_var_key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it_mtx = ctx->hash_map->find(mutex_key);
 
 	// If conditional variable is not in the map; check it in the lazy initialization list
-	if(it_cond == hash_map->end()){
+	if(it_cond == ctx->hash_map->end()){
 
 		FFI_pthread_cond_init(cond_var_ptr, NULL);
-		it_cond = hash_map->find(cond_var_key);
+		it_cond = ctx->hash_map->find(cond_var_key);
 	}
 
-	assert(it_cond != hash_map->end() && "FFI_pthread_cond_wait: conditional variable not in map\n");
-	assert(it_mtx != hash_map->end() && "FFI_pthread_cond_wait: mutex not in map\n");
+	assert(it_cond != ctx->hash_map->end() && "FFI_pthread_cond_wait: conditional variable not in map\n");
+	assert(it_mtx != ctx->hash_map->end() && "FFI_pthread_cond_wait: mutex not in map\n");
 
 	CoyoteLock* cond_var = (*it_cond).second;
 	assert(cond_var->is_cond_var && "It is not a conditional variable!");
@@ -819,7 +1479,7 @@ int FFI_pthread_cond_wait(void* cond_var_ptr, void* mtx){
 	// If they are in the map:
 	// Register this operation in the list of all operations waiting on this
 	// conditional variable.
-	size_t current_op_id = FFI_get_operation_id();
+	size_t current_op_id = FFI_ctx_get_operation_id(ctx);
 
 	cond_var->waitingOps->push_back(current_op_id);
 	cond_var->is_locked = true;
@@ -835,7 +1495,7 @@ int FFI_pthread_cond_wait(void* cond_var_ptr, void* mtx){
 	// Wait for cond_signal or cond_broadcast
 	while(cond_var->is_locked && (find(cond_var->waitingOps->begin(), cond_var->waitingOps->end(), current_op_id) 
 									  != cond_var->waitingOps->end())   ){
-		FFI_wait_resource(cond_var->coyote_resource_id);
+		FFI_ctx_wait_resource(ctx, cond_var->coyote_resource_id);
 	}
 
 	// Lock that conditional variable again, so that other operations can wait on this conditional variable
@@ -849,21 +1509,22 @@ int FFI_pthread_cond_wait(void* cond_var_ptr, void* mtx){
 
 int FFI_pthread_cond_signal(void* ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_cond_signal: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_cond_signal: Initialize the hash map first\n");
 
 	llu cond_key = (llu)ptr;
 
 	// First check whether the conditional variable are in the map or not
-	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = hash_map->find(cond_key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = ctx->hash_map->find(cond_key);
 
 	// If conditional variable is not in the map; check it in the lazy initialization list
-	if(it_cond == hash_map->end()){
+	if(it_cond == ctx->hash_map->end()){
 
 		FFI_pthread_cond_init(ptr, NULL);
-		it_cond = hash_map->find(cond_key);
+		it_cond = ctx->hash_map->find(cond_key);
 	}
-	assert(it_cond != hash_map->end() && "FFI_pthread_cond_signal: conditional variable not in map\n");
+	assert(it_cond != ctx->hash_map->end() && "FFI_pthread_cond_signal: conditional variable not in map\n");
 
 	CoyoteLock* cond_obj = (*it_cond).second;
 	assert(cond_obj->is_cond_var && "FFI_pthread_cond_signal: this is not a conditional variable");
@@ -878,7 +1539,7 @@ int FFI_pthread_cond_signal(void* ptr){
 		cond_obj->is_locked = false; // Unlock it and signal the operation
 
 		// It is the responsibility of this operation to lock the conditional variable again!
-		FFI_signal_resource_to_op(cond_obj->coyote_resource_id, op_id);
+		FFI_ctx_signal_resource_to_op(ctx, cond_obj->coyote_resource_id, op_id);
 	} else{
 
 		// If there is no one waiting, then just unlock it
@@ -894,21 +1555,22 @@ int FFI_pthread_cond_signal(void* ptr){
 
 int FFI_pthread_cond_broadcast(void* ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_cond_broadcast: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_cond_broadcast: Initialize the hash map first\n");
 
 	llu cond_key = (llu)ptr;
 
 	// First check whether the conditional variable are in the map or not
-	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = hash_map->find(cond_key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = ctx->hash_map->find(cond_key);
 
 	// If conditional variable is not in the map; check it in the lazy initialization list
-	if(it_cond == hash_map->end()){
+	if(it_cond == ctx->hash_map->end()){
 
 		FFI_pthread_cond_init(ptr, NULL);
-		it_cond = hash_map->find(cond_key);
+		it_cond = ctx->hash_map->find(cond_key);
 	}
-	assert(it_cond != hash_map->end() && "FFI_pthread_cond_broadcast: conditional variable not in map\n");
+	assert(it_cond != ctx->hash_map->end() && "FFI_pthread_cond_broadcast: conditional variable not in map\n");
 
 	CoyoteLock* cond_obj = (*it_cond).second;
 	assert(cond_obj->is_cond_var && "FFI_pthread_cond_broadcast: this is not a conditional variable");
@@ -933,8 +1595,8 @@ int FFI_pthread_cond_broadcast(void* ptr){
 #endif
 
 		// It is the responsibility of this operation to lock the conditional variable again!
-		// Not sure if instead of this,  I should do a single FFI_signal_resource() out side this loop
-		FFI_signal_resource_to_op(cond_obj->coyote_resource_id, op_id);
+		// Not sure if instead of this,  I should do a single FFI_ctx_signal_resource(ctx, ) out side this loop
+		FFI_ctx_signal_resource_to_op(ctx, cond_obj->coyote_resource_id, op_id);
 	};
 
 	return 0;
@@ -942,27 +1604,28 @@ int FFI_pthread_cond_broadcast(void* ptr){
 
 int FFI_pthread_cond_destroy(void* ptr){
 
-	FFI_schedule_next();
-	assert(hash_map != NULL && "FFI_pthread_cond_destroy: Initialize the hash map first\n");
+	FFI_context* ctx = current_context();
+	FFI_ctx_schedule_next(ctx);
+	assert(ctx->hash_map != NULL && "FFI_pthread_cond_destroy: Initialize the hash map first\n");
 
 	llu cond_key = (llu)ptr;
 
 	// First check whether the conditional variable is in the map or not
-	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = hash_map->find(cond_key);
+	std::unordered_map<llu, CoyoteLock*>::iterator it_cond = ctx->hash_map->find(cond_key);
 
 	// If conditional variable is not in the map; check it in the lazy initialization list
-	if(it_cond == hash_map->end()){
+	if(it_cond == ctx->hash_map->end()){
 
 		FFI_pthread_cond_init(ptr, NULL);
-		it_cond = hash_map->find(cond_key);
+		it_cond = ctx->hash_map->find(cond_key);
 	}
 
-	assert(it_cond != hash_map->end() && "FFI_pthread_cond_destroy: conditional variable not in map\n");
+	assert(it_cond != ctx->hash_map->end() && "FFI_pthread_cond_destroy: conditional variable not in map\n");
 
 	CoyoteLock* cond_obj = (*it_cond).second;
 	assert(cond_obj->is_cond_var && "FFI_pthread_cond_destroy: this is not a conditional variable");
 
-	hash_map->erase(it_cond);
+	ctx->hash_map->erase(it_cond);
 	delete cond_obj;
 
 	return 0;
@@ -985,42 +1648,40 @@ int FFI_pthread_cond_destroy(void* ptr){
 	#define ALLOC_UNLOCK()
 #endif
 
-std::vector<void*>* allocation_vector = NULL;
-
-void add_to_allocation_vector(void* ptr){
+void add_to_allocation_vector(FFI_context* ctx, void* ptr){
 
 	ALLOC_LOCK();
-	if(allocation_vector == NULL){
-		allocation_vector = new std::vector<void*>();
+	if(ctx->allocation_vector == NULL){
+		ctx->allocation_vector = new std::vector<void*>();
 	}
-	assert(allocation_vector != NULL && "Heap memory full; Not able to allocate");
+	assert(ctx->allocation_vector != NULL && "Heap memory full; Not able to allocate");
 
-	allocation_vector->push_back(ptr);
+	ctx->allocation_vector->push_back(ptr);
 	ALLOC_UNLOCK();
 }
 
-void remove_from_allocation_vector(void* ptr){
+void remove_from_allocation_vector(FFI_context* ctx, void* ptr){
 
 	ALLOC_LOCK();
 
-	assert(allocation_vector != NULL);
+	assert(ctx->allocation_vector != NULL);
 
-	std::vector<void*>::iterator it = std::find(allocation_vector->begin(), allocation_vector->end(), ptr);
+	std::vector<void*>::iterator it = std::find(ctx->allocation_vector->begin(), ctx->allocation_vector->end(), ptr);
 
-	if(it != allocation_vector->end()){
+	if(it != ctx->allocation_vector->end()){
 
-		allocation_vector->erase(it);
+		ctx->allocation_vector->erase(it);
 	}
 
 	ALLOC_UNLOCK();
 }
 
-void clear_allocation_vector(){
+void clear_allocation_vector(FFI_context* ctx){
 
-	if(allocation_vector == NULL) return;
+	if(ctx->allocation_vector == NULL) return;
 
-	std::vector<void*>::iterator it = allocation_vector->begin();
-	for(; it != allocation_vector->end(); it++){
+	std::vector<void*>::iterator it = ctx->allocation_vector->begin();
+	for(; it != ctx->allocation_vector->end(); it++){
 
 		void* ptr = *(it);
 
@@ -1039,8 +1700,8 @@ void clear_allocation_vector(){
 		}
 	}
 
-	delete allocation_vector;
-	allocation_vector = NULL;
+	delete ctx->allocation_vector;
+	ctx->allocation_vector = NULL;
 }
 
 extern "C"{
@@ -1051,7 +1712,7 @@ extern "C"{
 		//FFI_schedule_next();
 #endif
 		void* retval = malloc(s);
-		add_to_allocation_vector(retval);
+		add_to_allocation_vector(current_context(), retval);
 		return retval;
 	}
 
@@ -1061,7 +1722,7 @@ extern "C"{
 		//FFI_schedule_next();
 #endif
 		void* retval = calloc(a, b);
-		add_to_allocation_vector(retval);
+		add_to_allocation_vector(current_context(), retval);
 		return retval;
 	}
 
@@ -1070,10 +1731,10 @@ extern "C"{
 #ifdef EXECUTION_COYOTE_CONTROLLED
 		//FFI_schedule_next();
 #endif
-		remove_from_allocation_vector(ptr);
+		remove_from_allocation_vector(current_context(), ptr);
 
 		void* retval = realloc(ptr, s);
-		add_to_allocation_vector(retval);
+		add_to_allocation_vector(current_context(), retval);
 		return retval;
 	}
 
@@ -1082,13 +1743,18 @@ extern "C"{
 #ifdef EXECUTION_COYOTE_CONTROLLED
 		//FFI_schedule_next();
 #endif
-		remove_from_allocation_vector(ptr);
+		remove_from_allocation_vector(current_context(), ptr);
 		free(ptr);
 	}
 
+	void FFI_ctx_free_all(FFI_context* ctx){
+
+		clear_allocation_vector(ctx);
+	}
+
 	void FFI_free_all(){
 
-		clear_allocation_vector();
+		clear_allocation_vector(current_context());
 	}
 
 } // End of Extern "C"